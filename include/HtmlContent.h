@@ -51,6 +51,10 @@
                                     "<td align=\"center\"><button type=\"submit\" name=\"do\" value=\"btn_on\">On</button></td>"
                                     "<td align=\"center\"><button type=\"submit\" name=\"do\" value=\"btn_off\">Off</button></td>"
                                 "</tr>"
+                                "<tr ${group_hidden}>"
+                                    "<td align=\"center\"><button type=\"submit\" name=\"do\" value=\"grp_on\">Group On</button></td>"
+                                    "<td align=\"center\"><button type=\"submit\" name=\"do\" value=\"grp_off\">Group Off</button></td>"
+                                "</tr>"
                             "</table>"
                             "<br />"
                             "<hr />"
@@ -65,6 +69,130 @@
                         "Firmware Version: ${version}; By: Scott Griffis"
                     "</div>"
                 "</div>"
+                "<script>"
+                    // 0: clock is fine, 1: send browser time, 2: send it and reload to show the timer
+                    "var clockSync=${clock_sync};"
+                    "if(clockSync){fetch('/clock',{method:'POST',headers:{'Content-Type':'application/x-www-form-urlencoded'},body:'t='+Date.now()}).then(function(r){if(r.ok&&clockSync>1){location.replace('/classic');}});}"
+                "</script>"
+            "</body>"
+        "</html>"
+    };
+
+    /**
+     * This is the HTML content of the Dashboard.
+     * This HTML is static so browsers can keep it, everything shown on it
+     * comes from /api/status and every control goes through /api/cmd.
+    */
+    const char PROGMEM DASHBOARD_PAGE[] = {
+        "<html lang=\"en\">"
+            "<head>"
+                "<title>Lumen Lighting Controller</title>"
+                "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">"
+                "<style>"
+                    "body { background-color: #000000; color: #FFFFFF; }"
+                    "h1 { text-align: center; background-color: #5878B0; color: #FFFFFF; border: 3px; }"
+                    "h2 { text-align: center; background-color: #58ADB0; color: #FFFFFF; border: 3px;  border-radius: 15px; }"
+                    "#wrapper { background-color: #E6EFFF; color: #000000; padding: 20px; margin-left: auto; margin-right: auto; max-width: 700px; box-shadow: 3px 3px 3px #b8b8b8; }"
+                    "#info, input { font-size: 25px; font-weight: bold; line-height: 150%; } "
+                    "strong { font-size: 30px; }"
+                    ".hlt { background-color: #FFFFFF; display: inline; }"
+                    ".tiny { font-size: 8px; }"
+                    "button { background-color: #5878B0; color: white; font-size: 16px; padding: 10px 24px; border-radius: 12px; border: 2px solid black; transition-duration: 0.4s; }"
+                    "button:hover { background-color: white; color: black; }"
+                "</style>"
+            "</head>"
+            "<body>"
+                "<div id=\"wrapper\">"
+                    "<h1>Lumen Lighting Controller</h1>"
+                    "<noscript><a href=\"/classic\">Use the page without scripts</a></noscript>"
+                    "<div id=\"info\">"
+                        "<strong>Light Status:</strong> <div class=\"hlt\" id=\"lights\">...</div>"
+                        "<br />"
+                        "<strong>Brightness:</strong> <input type=\"range\" min=\"1\" max=\"100\" id=\"lvl\" oninput=\"level(this.value,0)\" onchange=\"level(this.value,1)\" />"
+                        "<br />"
+                        "<strong>Current Time:</strong> <div class=\"hlt\" id=\"time\">...</div>"
+                        "<br /><br />"
+                        "<h2>Timer Control</h2>"
+                        "<strong>Status:</strong> <div class=\"hlt\" id=\"timer\">...</div>"
+                        "<br /><br />"
+                        "<button id=\"toggle\" onclick=\"cmd(S.timer?'timer_off':'timer_on')\" hidden>Toggle</button>"
+                        "<br />"
+                        "<div id=\"sched\" hidden>"
+                            "<br />"
+                            "<strong>Schedule:</strong><br />"
+                            "On at: <input type=\"time\" id=\"onat\" required /><br />"
+                            "Off at: <input type=\"time\" id=\"offat\" required />"
+                            "<br /><br />"
+                            "<button onclick=\"cmd('schedule','&onat='+$('onat').value+'&offat='+$('offat').value)\">Update</button>"
+                            "<br />"
+                        "</div>"
+                        "<h2>Manual Controls</h2>"
+                        "<table style=\"width: 100%;\">"
+                            "<tr>"
+                                "<td align=\"center\"><button onclick=\"cmd('on')\">On</button></td>"
+                                "<td align=\"center\"><button onclick=\"cmd('off')\">Off</button></td>"
+                            "</tr>"
+                            "<tr id=\"grp\" hidden>"
+                                "<td align=\"center\"><button onclick=\"cmd('grp_on')\">Group On</button></td>"
+                                "<td align=\"center\"><button onclick=\"cmd('grp_off')\">Group Off</button></td>"
+                            "</tr>"
+                        "</table>"
+                        "<br />"
+                        "<hr />"
+                        "<br />"
+                        "<button onclick=\"location.href='/admin'\">Settings</button>"
+                    "</div>"
+                    "<div class=\"tiny\">"
+                        "<br /><hr /><br />"
+                        "About Device:<br />"
+                        "SSID: <span id=\"ssid\"></span>; WiFi Address: <span id=\"ip\"></span><br />"
+                        "Firmware Version: <span id=\"fw\"></span>; By: Scott Griffis"
+                    "</div>"
+                "</div>"
+                "<script>"
+                    "var S={},synced=0,ws=null;"
+                    "function $(i){return document.getElementById(i);}"
+                    "function paint(){"
+                        "$('lights').textContent=S.on?'On':'Off';"
+                        // Leave the slider alone while it is being dragged
+                        "if(document.activeElement!==$('lvl')){$('lvl').value=S.level;}"
+                        "$('timer').textContent=S.timer?'Enabled':'Disabled';"
+                    "}"
+                    "function show(s){"
+                        "S=s;"
+                        "paint();"
+                        "$('time').textContent=s.time||'Unknown';"
+                        "$('toggle').hidden=!s.time;"
+                        "$('sched').hidden=!(s.timer&&s.time);"
+                        // Leave the schedule alone while it is being edited
+                        "if(document.activeElement!==$('onat')&&document.activeElement!==$('offat')){$('onat').value=s.onAt;$('offat').value=s.offAt;}"
+                        "$('grp').hidden=!s.group;"
+                        "$('ssid').textContent=s.ssid||'Not Connected';"
+                        "$('ip').textContent=s.ip||'N/A';"
+                        "$('fw').textContent=s.fw;"
+                        // 0: clock is fine, 1: send browser time, 2: send it as the time is unknown
+                        "if(s.sync&&!synced){synced=1;fetch('/clock',{method:'POST',headers:{'Content-Type':'application/x-www-form-urlencoded'},body:'t='+Date.now()}).then(poll);}"
+                    "}"
+                    "function poll(){fetch('/api/status',{cache:'no-cache'}).then(function(r){return r.json();}).then(show).catch(function(){});}"
+                    "function cmd(d,x){"
+                        "fetch('/api/cmd',{method:'POST',headers:{'Content-Type':'application/x-www-form-urlencoded'},body:'do='+d+(x||'')})"
+                        ".then(function(r){return r.json();}).then(function(s){if(s.error){alert(s.error);}else{show(s);}}).catch(function(){});"
+                    "}"
+                    // Slider moves go over the light socket, or as a command once let go if it is down
+                    "function level(v,done){"
+                        "if(ws&&ws.readyState===1){ws.send(new Uint8Array([2,v]));}"
+                        "else if(done){cmd('level','&value='+v);}"
+                    "}"
+                    "function sock(){"
+                        "ws=new WebSocket('ws://'+location.hostname+':81/');"
+                        "ws.binaryType='arraybuffer';"
+                        "ws.onmessage=function(e){var b=new Uint8Array(e.data);if(b[0]===128){S.on=!!b[1];S.level=b[2];S.timer=!!b[3];paint();}};"
+                        "ws.onclose=function(){ws=null;setTimeout(sock,10000);};"
+                    "}"
+                    "poll();"
+                    "sock();"
+                    "setInterval(poll,5000);"
+                "</script>"
             "</body>"
         "</html>"
     };
@@ -116,16 +244,87 @@
                             "<br /><br />"
                             "<strong>SSID:</strong> <input maxlength=\"32\" type=\"text\" value=\"${ssid}\" name=\"ssid\" id=\"ssid\"><br />"
                             "<strong>Password:</strong> <input maxlength=\"63\" type=\"text\" value=\"${pwd}\" name=\"pwd\" id=\"pwd\">"
+                            "<h2>Group</h2>"
+                            "<div>Note: Devices sharing a group number switch together, use 0 for no group.</div>"
+                            "<strong>Group:</strong> <input type=\"number\" min=\"0\" max=\"65535\" value=\"${group}\" name=\"group\" id=\"group\">"
+                            "<h2>Automation</h2>"
+                            "<div>Note: Key for UDP control from automation controllers, leave empty to turn it off.</div>"
+                            "<strong>Control Key:</strong> <input maxlength=\"32\" type=\"text\" value=\"${controlkey}\" name=\"controlkey\" id=\"controlkey\">"
+                            "<h2>MQTT</h2>"
+                            "<div>Note: Broker for Home Assistant, leave the host empty to turn it off.</div>"
+                            "<strong>Host:</strong> <input maxlength=\"63\" type=\"text\" value=\"${mqtthost}\" name=\"mqtthost\" id=\"mqtthost\"><br />"
+                            "<strong>Port:</strong> <input type=\"number\" min=\"1\" max=\"65535\" value=\"${mqttport}\" name=\"mqttport\" id=\"mqttport\"><br />"
+                            "<strong>User:</strong> <input maxlength=\"32\" type=\"text\" value=\"${mqttuser}\" name=\"mqttuser\" id=\"mqttuser\"><br />"
+                            "<strong>Password:</strong> <input maxlength=\"32\" type=\"text\" value=\"${mqttpwd}\" name=\"mqttpwd\" id=\"mqttpwd\">"
+                            "<h2>Vacation</h2>"
+                            "<div>Note: While away the lights switch on and off at a different time each day, picked between these times.</div>"
+                            "<label for=\"vacation\">Vacation Mode:&nbsp;</label><input type=\"checkbox\" id=\"vacation\" name=\"vacation\" value=\"ON\" ${vacation_checked}><br />"
+                            "<strong>On Between:</strong> <input type=\"time\" value=\"${vaconfrom}\" name=\"vaconfrom\" id=\"vaconfrom\"> and <input type=\"time\" value=\"${vaconto}\" name=\"vaconto\" id=\"vaconto\"><br />"
+                            "<strong>Off Between:</strong> <input type=\"time\" value=\"${vacofffrom}\" name=\"vacofffrom\" id=\"vacofffrom\"> and <input type=\"time\" value=\"${vacoffto}\" name=\"vacoffto\" id=\"vacoffto\">"
+                            "<h2>Ambient Light</h2>"
+                            "<div>Note: With a light sensor on A0 the timer only has the lights on while it is dark. The sensor reads ${ambient_level} now, higher being lighter.</div>"
+                            "<label for=\"ambient\">Use Sensor:&nbsp;</label><input type=\"checkbox\" id=\"ambient\" name=\"ambient\" value=\"ON\" ${ambient_checked}><br />"
+                            "<strong>Dark At Or Below:</strong> <input type=\"number\" min=\"0\" max=\"1023\" value=\"${ambientthreshold}\" name=\"ambientthreshold\" id=\"ambientthreshold\">"
+                            "<h2>Occupancy</h2>"
+                            "<div>Note: With a motion or occupancy sensor on D6 the lights come on as someone comes in and go off once nobody has been there for the timeout. The button, timer and commands take the lights over from it.</div>"
+                            "<label for=\"occupancy\">Use Sensor:&nbsp;</label><input type=\"checkbox\" id=\"occupancy\" name=\"occupancy\" value=\"ON\" ${occupancy_checked}><br />"
+                            "<strong>Off After (minutes):</strong> <input type=\"number\" min=\"1\" max=\"240\" value=\"${occupancytimeout}\" name=\"occupancytimeout\" id=\"occupancytimeout\">"
+                            "<h2>Tunable White</h2>"
+                            "<div>Note: For fixtures with the warm white channel on D1 and the cool white channel on D2. The shade and brightness follow the time of day, from warm and dim at night to cool in the middle of the day.</div>"
+                            "<label for=\"circadian\">Follow Time Of Day:&nbsp;</label><input type=\"checkbox\" id=\"circadian\" name=\"circadian\" value=\"ON\" ${circadian_checked}><br />"
+                            "<strong>Warm Channel (K):</strong> <input type=\"number\" min=\"1000\" max=\"10000\" value=\"${warmkelvin}\" name=\"warmkelvin\" id=\"warmkelvin\"><br />"
+                            "<strong>Cool Channel (K):</strong> <input type=\"number\" min=\"1000\" max=\"10000\" value=\"${coolkelvin}\" name=\"coolkelvin\" id=\"coolkelvin\">"
                             "<h2>Admin</h2>"
                             "<strong>Admin User:</strong> <input maxlength=\"50\" type=\"text\" value=\"${adminuser}\" name=\"adminuser\" id=\"adminuser\"><br />"
                             "<strong>Admin Password:</strong> <input maxlength=\"50\" type=\"text\" value=\"${adminpwd}\" name=\"adminpwd\" id=\"adminpwd\"><br />"
                             "<br />"
                             "<button type=\"submit\" name=\"do\" value=\"admin_save\">Save</button>&nbsp;&nbsp;&nbsp;&nbsp;<button type=\"submit\" name=\"do\" value=\"admin_exit\">Exit</button>"
                         "</form>"
+                        "<form method=\"get\" action=\"/update\">"
+                            "<h2>Firmware</h2>"
+                            "<button type=\"submit\">Firmware Update</button>"
+                        "</form>"
                     "</div>"
             "</div>"
             "</body>"
         "</html>"
     };
 
+    /**
+     * This is the HTML content of the Firmware Update Page.
+     * The MD5 of the uploaded file is passed as a query arg so that it is
+     * known before the file itself starts streaming in.
+    */
+    const char PROGMEM UPDATE_PAGE[] = {
+        "<!DOCTYPE HTML>"
+        "<html lang=\"en\">"
+            "<head>"
+                "<title>Lumen Lighting Controller</title>"
+                "<style>"
+                    "body { background-color: #000000; color: #FFFFFF; }"
+                    "h1 { text-align: center; background-color: #5878B0; color: #FFFFFF; border: 3px; }"
+                    "#wrapper { background-color: #E6EFFF; color: #000000; padding: 20px; margin-left: auto; margin-right: auto; max-width: 700px; box-shadow: 3px 3px 3px #b8b8b8; }"
+                    "#info, input { font-size: 25px; font-weight: bold; line-height: 150%; }"
+                    "strong { font-size: 30px; }"
+                    "button { background-color: #5878B0; color: white; font-size: 16px; padding: 10px 24px; border-radius: 12px; border: 2px solid black; transition-duration: 0.4s; }"
+                    "button:hover { background-color: white; color: black; }"
+                "</style>"
+            "</head>"
+            "<body>"
+                "<div id=\"wrapper\">"
+                    "<h1>Firmware Update</h1>"
+                    "Firmware Version: ${version}"
+                    "<div id=\"info\">"
+                        "<form method=\"post\" action=\"/update\" enctype=\"multipart/form-data\" onsubmit=\"this.action='/update?md5='+encodeURIComponent(document.getElementById('md5').value.trim());\">"
+                            "<strong>MD5:</strong> <input maxlength=\"32\" type=\"text\" id=\"md5\" required><br />"
+                            "<strong>Image:</strong> <input type=\"file\" name=\"image\" accept=\".bin,.gz,.delta\" required><br />"
+                            "<br />"
+                            "<button type=\"submit\">Upload</button>"
+                        "</form>"
+                    "</div>"
+                "</div>"
+            "</body>"
+        "</html>"
+    };
+
 #endif
\ No newline at end of file
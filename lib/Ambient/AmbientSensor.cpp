@@ -0,0 +1,128 @@
+/*
+    AmbientSensor - A class that reads a light sensor on the ADC, filtering
+    its readings into whether it is dark.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "AmbientSensor.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+AmbientSensor::AmbientSensor() {
+    pin = A0;
+    threshold = 300;
+    lastSampleAt = 0;
+    reset();
+}
+
+/**
+ * Sets the pin the sensor is read from.
+ * 
+ * @param pin The analog pin as uint8_t.
+ */
+void AmbientSensor::begin(uint8_t pin) {
+    this->pin = pin;
+    lastSampleAt = millis();
+}
+
+/**
+ * Forgets past readings, so the next one is taken as the level straight
+ * away rather than being averaged with stale ones.
+ */
+void AmbientSensor::reset() {
+    memset(samples, 0, sizeof(samples));
+    sum = 0;
+    next = 0;
+    isPrimed = false;
+    dark = false;
+}
+
+/**
+ * Sets the level at or below which it counts as dark.
+ * 
+ * @param threshold The level from 0 to 1023 as uint16_t.
+ */
+void AmbientSensor::setThreshold(uint16_t threshold) {
+    this->threshold = min(threshold, (uint16_t)AMBIENT_MAX_LEVEL);
+}
+
+/**
+ * Reads the sensor once a sample is due. Should be called every time
+ * through the main loop.
+ * 
+ * @return Returns true if it went dark or light otherwise false as bool.
+ */
+bool AmbientSensor::handle() {
+    if (millis() - lastSampleAt < AMBIENT_SAMPLE_MS) {
+
+        return false;
+    }
+    lastSampleAt = millis();
+
+    return addSample(analogRead(pin));
+}
+
+/**
+ * Adds a reading to the average and works out whether it is dark.
+ * 
+ * @param reading The reading from 0 to 1023 as uint16_t.
+ * 
+ * @return Returns true if it went dark or light otherwise false as bool.
+ */
+bool AmbientSensor::addSample(uint16_t reading) {
+    reading = min(reading, (uint16_t)AMBIENT_MAX_LEVEL);
+    if (!isPrimed) {
+        // Start out at the first reading rather than climbing up from 0
+        for (uint8_t i = 0; i < AMBIENT_WINDOW; i++) {
+            samples[i] = reading;
+        }
+        sum = reading << AMBIENT_WINDOW_SHIFT;
+        isPrimed = true;
+        dark = reading <= threshold;
+
+        return true;
+    }
+
+    sum = sum - samples[next] + reading;
+    samples[next] = reading;
+    next = (next + 1) % AMBIENT_WINDOW;
+
+    bool wasDark = dark;
+    uint16_t level = getLevel();
+    if (level <= threshold) {
+        dark = true;
+    } else if (level >= threshold + AMBIENT_HYSTERESIS) {
+        dark = false;
+    }
+
+    return dark != wasDark;
+}
+
+/**
+ * Gets the average level.
+ * 
+ * @return Returns the level from 0 to 1023 as uint16_t.
+ */
+uint16_t AmbientSensor::getLevel() {
+
+    return sum >> AMBIENT_WINDOW_SHIFT;
+}
+
+bool AmbientSensor::isDark() {
+
+    return dark;
+}
+
+/**
+ * Determines if the sensor has been read yet, before which it isn't
+ * known whether it is dark.
+ * 
+ * @return Returns true if read otherwise false as bool.
+ */
+bool AmbientSensor::isReady() {
+
+    return isPrimed;
+}
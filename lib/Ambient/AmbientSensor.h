@@ -0,0 +1,60 @@
+#ifndef AmbientSensor_h
+    #define AmbientSensor_h
+
+    #include <Arduino.h>
+
+    #define AMBIENT_SAMPLE_MS 500UL // <-- Time between reads of the ADC (ms), reading it much faster upsets WiFi
+    #define AMBIENT_WINDOW_SHIFT 5 // <--- Average taken over 2^5 = 32 samples, 16 seconds
+    #define AMBIENT_WINDOW (1 << AMBIENT_WINDOW_SHIFT)
+    #define AMBIENT_HYSTERESIS 40 // <---- Level must rise this far over the threshold to count as light again
+    #define AMBIENT_MAX_LEVEL 1023
+
+    /**
+     * The AmbientSensor class reads a light sensor on the ADC and decides
+     * whether it is dark, so the timer can leave the lights off while
+     * daylight is coming in.
+     * 
+     * The ADC is read once every AMBIENT_SAMPLE_MS from handle(), which
+     * takes well under a millisecond, so the loop is never held up. The
+     * readings go into a moving average over AMBIENT_WINDOW samples, kept
+     * as a running sum over a ring so each sample costs one add and one
+     * subtract, all in integers. Passing shadows and mains flicker are
+     * smoothed out by it.
+     * 
+     * The average then goes through hysteresis: it counts as dark once at
+     * or below the threshold and only as light again once it has risen
+     * AMBIENT_HYSTERESIS past it. This keeps a level hovering around the
+     * threshold, at dusk say, from switching the lights back and forth.
+     * 
+     * Higher readings mean more light. The filter is separate from the
+     * reading of the ADC, through addSample(), so it can be fed made up
+     * readings on the host.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class AmbientSensor {
+        private:
+            uint8_t        pin                                 ;
+            uint16_t       samples      [AMBIENT_WINDOW]       ;
+            uint16_t       sum                                 ; // of samples, at most 32 * 1023
+            uint8_t        next                                ; // index of the oldest sample
+            bool           isPrimed                            ;
+            bool           dark                                ;
+            uint16_t       threshold                           ;
+            unsigned long  lastSampleAt                        ;
+
+        public:
+            AmbientSensor();
+
+            void begin(uint8_t pin);
+            void reset();
+            void setThreshold(uint16_t threshold);
+            bool handle();
+            bool addSample(uint16_t reading);
+            uint16_t getLevel();
+            bool isDark();
+            bool isReady();
+    };
+
+#endif
@@ -0,0 +1,181 @@
+/*
+    DeviceClock - A class that keeps the time of day for the device along 
+    with where that time came from, correcting for the drift of millis().
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "DeviceClock.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ * 
+ * @param millisSource The function elapsed time is read from as MillisFunction.
+ */
+DeviceClock::DeviceClock(MillisFunction millisSource) {
+    this->millisSource = millisSource;
+    baseEpochMillis = 0;
+    baseMillis = 0;
+    setAtMillis = 0;
+    source = CLOCK_SOURCE_NONE;
+    stratum = CLOCK_STRATUM_UNSYNCED;
+    driftPpm = 0;
+    hasDriftRef = false;
+    driftRefEpochMillis = 0;
+    driftRefMillis = 0;
+    isDriftRefCoarse = false;
+}
+
+/**
+ * Sets the clock to the given time.
+ * 
+ * @param epoch The time as seconds since the Unix epoch as uint32_t.
+ * @param epochMillis The millis past the given second as uint16_t.
+ * @param source Where the time came from as a CLOCK_SOURCE_ value.
+ * @param stratum The NTP stratum this clock now has as uint8_t.
+ * @param isWholeSecond True if the source only knows the time to the second as bool.
+ */
+void DeviceClock::setTime(uint32_t epoch, uint16_t epochMillis, uint8_t source, uint8_t stratum, bool isWholeSecond) {
+    unsigned long now = millisSource();
+    uint64_t newEpochMillis = ((uint64_t)epoch * 1000ULL) + epochMillis;
+    learnDrift(newEpochMillis, now, isWholeSecond);
+
+    baseEpochMillis = newEpochMillis;
+    baseMillis = now;
+    setAtMillis = now;
+    this->source = source;
+    this->stratum = stratum;
+}
+
+/**
+ * Moves the base of the clock forward so that the millis elapsed 
+ * since it was set never grow large enough to roll over. Needs to
+ * be called at least once every few weeks, calling it every loop
+ * is cheap.
+ */
+void DeviceClock::update() {
+    unsigned long now = millisSource();
+    if (isSet() && now - baseMillis >= 86400000UL) {
+        baseEpochMillis = nowEpochMillis();
+        baseMillis = now;
+    }
+    if (hasDriftRef && now - driftRefMillis >= 2000000000UL) {
+        // Too old to measure against before millis rolls over
+        hasDriftRef = false;
+    }
+}
+
+bool DeviceClock::isSet() {
+
+    return source != CLOCK_SOURCE_NONE;
+}
+
+uint32_t DeviceClock::getEpoch() {
+
+    return (uint32_t)(nowEpochMillis() / 1000ULL);
+}
+
+uint16_t DeviceClock::getEpochMillis() {
+
+    return (uint16_t)(nowEpochMillis() % 1000ULL);
+}
+
+/**
+ * @return Returns the UTC hour of the day as int.
+ */
+int DeviceClock::getHours() {
+
+    return (getEpoch() % 86400UL) / 3600UL;
+}
+
+/**
+ * @return Returns the UTC minute of the hour as int.
+ */
+int DeviceClock::getMinutes() {
+
+    return (getEpoch() % 3600UL) / 60UL;
+}
+
+uint8_t DeviceClock::getSource() {
+
+    return source;
+}
+
+uint8_t DeviceClock::getStratum() {
+
+    return stratum;
+}
+
+/**
+ * @return Returns the millis since the clock was last set as unsigned long.
+ */
+unsigned long DeviceClock::getAgeMillis() {
+
+    return millisSource() - setAtMillis;
+}
+
+/**
+ * @return Returns the drift of millis being corrected for in ppm as long.
+ */
+long DeviceClock::getDriftPpm() {
+
+    return driftPpm;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * @return Returns the drift corrected time in millis since the Unix 
+ * epoch as uint64_t.
+ */
+uint64_t DeviceClock::nowEpochMillis() {
+    int64_t elapsed = (int64_t)(millisSource() - baseMillis);
+
+    return baseEpochMillis + elapsed + ((elapsed * driftPpm) / 1000000LL);
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Measures the drift of millis between the last reference set and the
+ * given one, averaging it into the correction. Readings that are beyond 
+ * what a crystal could do are taken to be a bad time source and ignored.
+ * When either reading is only to the whole second the span must be long
+ * enough for the second of rounding not to pass for drift.
+ * 
+ * @param epochMillis The time being set in epoch millis as uint64_t.
+ * @param now The millis the time is being set at as unsigned long.
+ * @param isCoarse True if the time being set is only to the whole second as bool.
+ */
+void DeviceClock::learnDrift(uint64_t epochMillis, unsigned long now, bool isCoarse) {
+    if (!hasDriftRef) {
+        hasDriftRef = true;
+        driftRefEpochMillis = epochMillis;
+        driftRefMillis = now;
+        isDriftRefCoarse = isCoarse;
+
+        return;
+    }
+
+    unsigned long span = now - driftRefMillis;
+    if (span < ((isCoarse || isDriftRefCoarse) ? CLOCK_DRIFT_MIN_SPAN_COARSE : CLOCK_DRIFT_MIN_SPAN)) {
+
+        return;
+    }
+
+    int64_t error = (int64_t)(epochMillis - driftRefEpochMillis) - (int64_t)span;
+    long ppm = (long)((error * 1000000LL) / (int64_t)span);
+    if (ppm >= -CLOCK_DRIFT_MAX_PPM && ppm <= CLOCK_DRIFT_MAX_PPM) {
+        driftPpm = driftPpm == 0 ? ppm : (driftPpm + ppm) / 2;
+    }
+    driftRefEpochMillis = epochMillis;
+    driftRefMillis = now;
+    isDriftRefCoarse = isCoarse;
+}
@@ -0,0 +1,73 @@
+#ifndef DeviceClock_h
+    #define DeviceClock_h
+
+    #include <Arduino.h>
+
+    #define CLOCK_SOURCE_NONE 0
+    #define CLOCK_SOURCE_NTP 1
+    #define CLOCK_SOURCE_PEER 2
+    #define CLOCK_SOURCE_MANUAL 3
+
+    #define CLOCK_STRATUM_MANUAL 10
+    #define CLOCK_STRATUM_UNSYNCED 16
+
+    #define CLOCK_DRIFT_MIN_SPAN 3600000UL
+    #define CLOCK_DRIFT_MIN_SPAN_COARSE 86400000UL // Whole second readings are +/-1 s, about 12 ppm over a day
+    #define CLOCK_DRIFT_MAX_PPM 500L
+
+    /**
+     * The DeviceClock class keeps the time of day for the device. It is set
+     * from whichever source knows the time (Internet NTP, a peer device or
+     * the user) and then runs from millis() until it is set again. Along with
+     * the time it remembers where the time came from and its NTP stratum, so
+     * the device can in turn serve the time to its peers.
+     * 
+     * The crystal behind millis() can be off by a few hundred ppm, which adds
+     * up to seconds a day. Whenever the clock is set at least an hour after 
+     * the set it is measuring against, the drift of millis() over that span
+     * is worked out and corrected for from then on. This matters most when
+     * the time is set by hand and may not be set again for weeks. Sources
+     * that only give whole seconds are off by up to a second each time, so 
+     * their readings are only measured against after a day.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class DeviceClock {
+        public:
+            typedef unsigned long (*MillisFunction)();
+
+        private:
+            MillisFunction millisSource          ;
+            uint64_t       baseEpochMillis       ;
+            unsigned long  baseMillis            ;
+            unsigned long  setAtMillis           ;
+            uint8_t        source                ;
+            uint8_t        stratum               ;
+            long           driftPpm              ;
+            bool           hasDriftRef           ;
+            uint64_t       driftRefEpochMillis   ;
+            unsigned long  driftRefMillis        ;
+            bool           isDriftRefCoarse      ;
+
+            uint64_t nowEpochMillis();
+            void learnDrift(uint64_t epochMillis, unsigned long now, bool isCoarse);
+
+        public:
+            DeviceClock(MillisFunction millisSource = millis);
+
+            void setTime(uint32_t epoch, uint16_t epochMillis, uint8_t source, uint8_t stratum, bool isWholeSecond = false);
+            void update();
+
+            bool           isSet              ()    ;
+            uint32_t       getEpoch           ()    ;
+            uint16_t       getEpochMillis     ()    ;
+            int            getHours           ()    ;
+            int            getMinutes         ()    ;
+            uint8_t        getSource          ()    ;
+            uint8_t        getStratum         ()    ;
+            unsigned long  getAgeMillis       ()    ;
+            long           getDriftPpm        ()    ;
+    };
+
+#endif
@@ -0,0 +1,197 @@
+/*
+    SntpPeer - A class that serves the device's time to its peers over SNTP
+    and sets the device's time from a peer when it has no other source.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "SntpPeer.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ * 
+ * @param clock The DeviceClock to serve and set.
+ */
+SntpPeer::SntpPeer(DeviceClock &clock) : clock(clock) {
+    listening = false;
+    querying = false;
+    lastQueryAt = 0;
+    queryEpoch = 0;
+    queryEpochMillis = 0;
+    ownIp = 0;
+}
+
+/**
+ * Starts listening on the SNTP port.
+ */
+void SntpPeer::begin() {
+    listening = udp.begin(SNTP_PORT) == 1;
+}
+
+/**
+ * Answers any SNTP request that has arrived and, if asked to seek peers,
+ * periodically broadcasts a request and takes the time from the replies.
+ * 
+ * @param seekPeers Indicates the clock should be set from a peer as bool.
+ * @param ownIp The address of this device on the network as IPAddress.
+ * @param broadcastIp The broadcast address of the network as IPAddress.
+ */
+void SntpPeer::handle(bool seekPeers, IPAddress ownIp, IPAddress broadcastIp) {
+    if (!listening) {
+
+        return;
+    }
+    this->ownIp = (uint32_t)ownIp;
+
+    unsigned long interval = clock.isSet() ? SNTP_RESYNC_INTERVAL : SNTP_QUERY_INTERVAL;
+    if (seekPeers && (lastQueryAt == 0 || millis() - lastQueryAt >= interval)) {
+        sendQuery(broadcastIp);
+    }
+    if (querying && millis() - lastQueryAt >= SNTP_REPLY_TIMEOUT) {
+        // Stop listening for replies to the last query
+        querying = false;
+    }
+
+    if (udp.parsePacket() <= 0) {
+
+        return;
+    }
+    uint8_t packet[SNTP_PACKET_SIZE];
+    int len = udp.read(packet, sizeof(packet));
+    if (len < SNTP_PACKET_SIZE || (uint32_t)udp.remoteIP() == this->ownIp) {
+
+        return;
+    }
+
+    uint8_t mode = packet[0] & 0x07;
+    if (mode == 3) {
+        // Client request
+        answer(packet);
+    } else if (mode == 4 && querying) {
+        // Server reply to our query
+        accept(packet);
+    }
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Replies to the given request with the time of the clock, if set.
+ */
+void SntpPeer::answer(const uint8_t *request) {
+    if (!clock.isSet() || clock.getStratum() >= CLOCK_STRATUM_UNSYNCED - 1) {
+        // Nothing worth sharing
+
+        return;
+    }
+
+    uint32_t epoch = clock.getEpoch();
+    uint16_t epochMillis = clock.getEpochMillis();
+    uint32_t setAt = epoch - (clock.getAgeMillis() / 1000UL);
+
+    uint8_t reply[SNTP_PACKET_SIZE];
+    memset(reply, 0, sizeof(reply));
+    reply[0] = (request[0] & 0x38) | 0x04; // LI 0, client's version, mode 4
+    reply[1] = clock.getStratum() + 1;
+    reply[2] = request[2]; // poll
+    reply[3] = 0xEC; // precision about 1ms
+    memcpy(reply + 12, "LUMN", 4); // reference ID
+    writeTimestamp(reply + 16, setAt, 0); // reference time
+    memcpy(reply + 24, request + 40, 8); // originate = client's transmit
+    writeTimestamp(reply + 32, epoch, epochMillis); // receive
+    writeTimestamp(reply + 40, epoch, epochMillis); // transmit
+
+    udp.beginPacket(udp.remoteIP(), udp.remotePort());
+    udp.write(reply, sizeof(reply));
+    udp.endPacket();
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Sets the clock from the given reply if it answers our query and is
+ * better than the time the clock already has. Time from a peer may be
+ * refreshed by a peer of the same stratum, any other time needs one at 
+ * least two better. The stratum never gets worse, whatever the source, 
+ * so peers can't push each other's stratum up between them.
+ */
+void SntpPeer::accept(const uint8_t *reply) {
+    uint8_t stratum = reply[1];
+    int worstStratum = clock.getSource() == CLOCK_SOURCE_PEER ? clock.getStratum() : clock.getStratum() - 2;
+    if (
+        stratum == 0 
+        || stratum >= CLOCK_STRATUM_UNSYNCED - 1 
+        || (clock.isSet() && stratum > worstStratum)
+        || readUint32(reply + 24) != queryEpoch + SNTP_UNIX_OFFSET
+    ) {
+        // Not better or not a reply to our query
+
+        return;
+    }
+
+    // Half the round trip is added to the peer's transmit time
+    unsigned long roundTrip = millis() - lastQueryAt;
+    uint32_t epoch = readUint32(reply + 40) - SNTP_UNIX_OFFSET;
+    uint32_t fractionMillis = (uint32_t)(((uint64_t)readUint32(reply + 44) * 1000ULL) >> 32);
+    uint32_t totalMillis = fractionMillis + (roundTrip / 2UL);
+    clock.setTime(epoch + (totalMillis / 1000UL), totalMillis % 1000UL, CLOCK_SOURCE_PEER, stratum);
+    querying = false;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Broadcasts an SNTP request to find peers that know the time.
+ */
+void SntpPeer::sendQuery(IPAddress broadcastIp) {
+    // Our own time, even if unset, identifies the replies to this query
+    queryEpoch = clock.getEpoch();
+    queryEpochMillis = clock.getEpochMillis();
+
+    uint8_t request[SNTP_PACKET_SIZE];
+    memset(request, 0, sizeof(request));
+    request[0] = 0x23; // LI 0, version 4, mode 3
+    writeTimestamp(request + 40, queryEpoch, queryEpochMillis);
+
+    udp.beginPacket(broadcastIp, SNTP_PORT);
+    udp.write(request, sizeof(request));
+    udp.endPacket();
+
+    lastQueryAt = millis();
+    querying = true;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Writes an NTP timestamp for the given Unix time.
+ */
+void SntpPeer::writeTimestamp(uint8_t *at, uint32_t epoch, uint16_t epochMillis) {
+    uint32_t seconds = epoch + SNTP_UNIX_OFFSET;
+    uint32_t fraction = (uint32_t)(((uint64_t)epochMillis << 32) / 1000ULL);
+    at[0] = seconds >> 24;
+    at[1] = seconds >> 16;
+    at[2] = seconds >> 8;
+    at[3] = seconds;
+    at[4] = fraction >> 24;
+    at[5] = fraction >> 16;
+    at[6] = fraction >> 8;
+    at[7] = fraction;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Reads a big endian uint32.
+ */
+uint32_t SntpPeer::readUint32(const uint8_t *at) {
+
+    return ((uint32_t)at[0] << 24) | ((uint32_t)at[1] << 16) | ((uint32_t)at[2] << 8) | (uint32_t)at[3];
+}
@@ -0,0 +1,54 @@
+#ifndef SntpPeer_h
+    #define SntpPeer_h
+
+    #include <Arduino.h>
+    #include <WiFiUdp.h>
+    #include <IPAddress.h>
+
+    #include "DeviceClock.h"
+
+    #define SNTP_PORT 123
+    #define SNTP_PACKET_SIZE 48
+    #define SNTP_UNIX_OFFSET 2208988800UL
+    #define SNTP_QUERY_INTERVAL 30000UL
+    #define SNTP_RESYNC_INTERVAL 600000UL
+    #define SNTP_REPLY_TIMEOUT 2000UL
+
+    /**
+     * The SntpPeer class shares the time among devices on a network that has
+     * no Internet NTP. It acts as a minimal SNTP server that answers
+     * requests only while the DeviceClock is set, advertising a stratum one
+     * worse than the clock's. When asked to, it also looks for peers by
+     * broadcasting an SNTP request on the local network and sets the clock
+     * from the first answer it gets that is better than the time it already
+     * has. Peers are queried often while the clock is unset and only now and
+     * then after. Any standard SNTP client can use a device as a server.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class SntpPeer {
+        private:
+            DeviceClock    &clock                   ;
+            WiFiUDP        udp                      ;
+            bool           listening                ;
+            bool           querying                 ;
+            unsigned long  lastQueryAt              ;
+            uint32_t       queryEpoch               ;
+            uint16_t       queryEpochMillis         ;
+            uint32_t       ownIp                    ;
+
+            void answer(const uint8_t *request);
+            void accept(const uint8_t *reply);
+            void sendQuery(IPAddress broadcastIp);
+            static void writeTimestamp(uint8_t *at, uint32_t epoch, uint16_t epochMillis);
+            static uint32_t readUint32(const uint8_t *at);
+
+        public:
+            SntpPeer(DeviceClock &clock);
+
+            void begin();
+            void handle(bool seekPeers, IPAddress ownIp, IPAddress broadcastIp);
+    };
+
+#endif
@@ -0,0 +1,483 @@
+/*
+    CoapServer - A class that serves resources over CoAP, with Observe so
+    clients are pushed changes.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "CoapServer.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+CoapServer::CoapServer() {
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        observers[i].used = false;
+    }
+    listening = false;
+    resourceCount = 0;
+    nextMessageId = 0;
+    observeSeq = 0;
+    notificationCount = 0;
+}
+
+/**
+ * Registers a resource. The get handler writes the representation into
+ * the buffer it is given, returning its length like snprintf does, so a
+ * length of size or more means it didn't fit.
+ * 
+ * @param path The path of the resource, starting with '/', as char*.
+ * @param get The handler for GET requests as GetHandler.
+ * @param put The handler for PUT and POST requests, or nullptr if the
+ * resource can't be changed, as PutHandler.
+ * 
+ * @return Returns true if registered otherwise false if full as bool.
+ */
+bool CoapServer::on(const char *path, GetHandler get, PutHandler put) {
+    if (resourceCount >= COAP_MAX_RESOURCES) {
+
+        return false;
+    }
+    resources[resourceCount].path = path;
+    resources[resourceCount].get = get;
+    resources[resourceCount].put = put;
+    resourceCount++;
+
+    return true;
+}
+
+/**
+ * Starts listening for requests.
+ */
+void CoapServer::begin() {
+    listening = udp.begin(COAP_PORT);
+    nextMessageId = (uint16_t)random(0x10000);
+}
+
+/**
+ * Serves a request if there is one and drops observers that have gone
+ * quiet. Should be called every time through the main loop.
+ */
+void CoapServer::handle() {
+    if (!listening) {
+
+        return;
+    }
+
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        if (observers[i].used && millis() - observers[i].registeredAt > COAP_OBSERVE_LIFETIME_MS) {
+            observers[i].used = false;
+        }
+    }
+
+    int size = udp.parsePacket();
+    if (size <= 0) {
+
+        return;
+    }
+    int length = udp.read(rxBuffer, sizeof(rxBuffer));
+    if (size > COAP_MAX_PACKET || length != size) {
+        // Too big to handle
+
+        return;
+    }
+    handleRequest(length);
+}
+
+/**
+ * Notifies each observer whose resource's representation has changed
+ * since it was last sent to it. Should be called after anything served
+ * may have changed.
+ */
+void CoapServer::notifyChanged() {
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        if (!observers[i].used) {
+            continue;
+        }
+        uint16_t messageId = nextMessageId;
+        uint16_t lastOption = 0;
+        size_t pos = beginMessage(COAP_TYPE_NON, COAP_CONTENT, messageId, observers[i].token, observers[i].tokenLen);
+        pos = addOption(pos, lastOption, COAP_OPTION_OBSERVE, (observeSeq + 1) & 0xFFFFFF);
+        pos = addOption(pos, lastOption, COAP_OPTION_CONTENT_FORMAT, COAP_FORMAT_JSON);
+        uint32_t payloadHash = 0;
+        pos = addPayload(pos, observers[i].resource, &payloadHash);
+        if (pos == 0 || payloadHash == observers[i].lastHash) {
+            // Nothing new to tell it
+            continue;
+        }
+        observeSeq++;
+        nextMessageId++;
+        send(observers[i].ip, observers[i].port, pos);
+        observers[i].lastHash = payloadHash;
+        observers[i].lastMessageId = messageId;
+        notificationCount++;
+    }
+}
+
+uint8_t CoapServer::getObserverCount() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        if (observers[i].used) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+uint32_t CoapServer::getNotificationCount() {
+
+    return notificationCount;
+}
+
+/**
+ * Hashes the given data with 32 bit FNV-1a, used to tell whether a
+ * representation has changed.
+ * 
+ * @param data The data to hash as uint8_t*.
+ * @param length The length of the data as size_t.
+ * 
+ * @return Returns the hash as uint32_t.
+ */
+uint32_t CoapServer::hash(const uint8_t *data, size_t length) {
+    uint32_t result = 2166136261UL;
+    for (size_t i = 0; i < length; i++) {
+        result = (result ^ data[i]) * 16777619UL;
+    }
+
+    return result;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Parses and answers the message in the receive buffer.
+ * 
+ * @param length The length of the message as size_t.
+ */
+void CoapServer::handleRequest(size_t length) {
+    /* Parse The Header */
+    if (length < 4 || (rxBuffer[0] >> 6) != 1) {
+
+        return;
+    }
+    uint8_t type = (rxBuffer[0] >> 4) & 0x03;
+    uint8_t tokenLen = rxBuffer[0] & 0x0F;
+    uint8_t code = rxBuffer[1];
+    uint16_t messageId = (rxBuffer[2] << 8) | rxBuffer[3];
+    if (tokenLen > COAP_MAX_TOKEN || 4U + tokenLen > length) {
+
+        return;
+    }
+    const uint8_t *token = rxBuffer + 4;
+
+    if (type == COAP_TYPE_RST) {
+        // Observer no longer wants what it was sent
+        for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+            if (
+                observers[i].used 
+                && observers[i].lastMessageId == messageId 
+                && observers[i].ip == udp.remoteIP() 
+                && observers[i].port == udp.remotePort()
+            ) {
+                observers[i].used = false;
+            }
+        }
+
+        return;
+    }
+    if (type == COAP_TYPE_ACK || (code >> 5) != 0) {
+        // Not a request
+
+        return;
+    }
+    if (code == 0) {
+        // Empty message, answered with a reset if confirmable (CoAP ping)
+        if (type == COAP_TYPE_CON) {
+            send(udp.remoteIP(), udp.remotePort(), beginMessage(COAP_TYPE_RST, 0, messageId, nullptr, 0));
+        }
+
+        return;
+    }
+
+    /* Parse The Options */
+    char path[COAP_MAX_PATH + 1];
+    size_t pathLen = 0;
+    bool isPathTooLong = false;
+    bool hasObserve = false;
+    uint32_t observeValue = 0;
+    const uint8_t *payload = nullptr;
+    size_t payloadLen = 0;
+    uint16_t option = 0;
+    size_t pos = 4 + tokenLen;
+    while (pos < length) {
+        if (rxBuffer[pos] == 0xFF) {
+            payload = rxBuffer + pos + 1;
+            payloadLen = length - pos - 1;
+            break;
+        }
+        uint16_t delta = rxBuffer[pos] >> 4;
+        uint16_t optionLen = rxBuffer[pos] & 0x0F;
+        pos++;
+        uint16_t *fields[] = { &delta, &optionLen };
+        for (uint8_t f = 0; f < 2; f++) {
+            // Extended delta and length
+            if (*fields[f] == 13 && pos < length) {
+                *fields[f] = 13 + rxBuffer[pos];
+                pos += 1;
+            } else if (*fields[f] == 14 && pos + 1 < length) {
+                *fields[f] = 269 + ((rxBuffer[pos] << 8) | rxBuffer[pos + 1]);
+                pos += 2;
+            } else if (*fields[f] >= 13) {
+
+                return;
+            }
+        }
+        if (pos + optionLen > length) {
+
+            return;
+        }
+        option += delta;
+        if (option == COAP_OPTION_URI_PATH) {
+            if (pathLen + 1 + optionLen > COAP_MAX_PATH) {
+                isPathTooLong = true;
+            } else {
+                path[pathLen++] = '/';
+                memcpy(path + pathLen, rxBuffer + pos, optionLen);
+                pathLen += optionLen;
+            }
+        } else if (option == COAP_OPTION_OBSERVE) {
+            hasObserve = true;
+            for (uint16_t i = 0; i < optionLen && i < 4; i++) {
+                observeValue = (observeValue << 8) | rxBuffer[pos + i];
+            }
+        }
+        pos += optionLen;
+    }
+    if (pathLen == 0) {
+        path[pathLen++] = '/';
+    }
+    path[pathLen] = '\0';
+
+    /* Answer The Request */
+    uint8_t responseType = type == COAP_TYPE_CON ? COAP_TYPE_ACK : COAP_TYPE_NON;
+    uint16_t responseId = type == COAP_TYPE_CON ? messageId : nextMessageId++;
+    uint16_t lastOption = 0;
+    int resource = isPathTooLong ? -1 : findResource(path);
+    if (strcmp(path, "/.well-known/core") == 0 && code == COAP_GET) {
+        // Resource discovery
+        pos = beginMessage(responseType, COAP_CONTENT, responseId, token, tokenLen);
+        pos = addOption(pos, lastOption, COAP_OPTION_CONTENT_FORMAT, COAP_FORMAT_LINK);
+        pos = addLinkFormat(pos);
+    } else if (resource == -1) {
+        pos = beginMessage(responseType, COAP_NOT_FOUND, responseId, token, tokenLen);
+    } else if (code == COAP_GET) {
+        int observer = -1;
+        if (hasObserve && observeValue == 1) {
+            forget(token, tokenLen);
+        } else if (hasObserve && observeValue == 0) {
+            observer = observe(resource, token, tokenLen);
+        }
+        pos = beginMessage(responseType, COAP_CONTENT, responseId, token, tokenLen);
+        if (observer != -1) {
+            pos = addOption(pos, lastOption, COAP_OPTION_OBSERVE, observeSeq & 0xFFFFFF);
+        }
+        pos = addOption(pos, lastOption, COAP_OPTION_CONTENT_FORMAT, COAP_FORMAT_JSON);
+        uint32_t payloadHash = 0;
+        pos = addPayload(pos, resource, &payloadHash);
+        if (pos == 0) {
+            // Representation didn't fit
+            pos = beginMessage(responseType, COAP_INTERNAL_ERROR, responseId, token, tokenLen);
+        } else if (observer != -1) {
+            observers[observer].lastHash = payloadHash;
+            observers[observer].lastMessageId = responseId;
+        }
+    } else if ((code == COAP_PUT || code == COAP_POST) && resources[resource].put) {
+        uint8_t result = resources[resource].put((const char *)payload, payloadLen);
+        pos = beginMessage(responseType, result, responseId, token, tokenLen);
+    } else {
+        pos = beginMessage(responseType, COAP_METHOD_NOT_ALLOWED, responseId, token, tokenLen);
+    }
+    send(udp.remoteIP(), udp.remotePort(), pos);
+}
+
+/**
+ * Starts a message in the transmit buffer.
+ * 
+ * @return Returns the length so far as size_t.
+ */
+size_t CoapServer::beginMessage(uint8_t type, uint8_t code, uint16_t messageId, const uint8_t *token, uint8_t tokenLen) {
+    txBuffer[0] = 0x40 | (type << 4) | tokenLen;
+    txBuffer[1] = code;
+    txBuffer[2] = messageId >> 8;
+    txBuffer[3] = messageId & 0xFF;
+    if (tokenLen > 0) {
+        memcpy(txBuffer + 4, token, tokenLen);
+    }
+
+    return 4 + tokenLen;
+}
+
+/**
+ * Adds an option with an unsigned integer value to the message in the
+ * transmit buffer. Options must be added in increasing order.
+ * 
+ * @return Returns the length so far as size_t.
+ */
+size_t CoapServer::addOption(size_t pos, uint16_t &lastOption, uint16_t option, uint32_t value) {
+    uint8_t valueLen = 0;
+    for (uint32_t v = value; v != 0; v >>= 8) {
+        valueLen++;
+    }
+    uint16_t delta = option - lastOption;
+    if (delta < 13) {
+        txBuffer[pos++] = (delta << 4) | valueLen;
+    } else {
+        txBuffer[pos++] = (13 << 4) | valueLen;
+        txBuffer[pos++] = delta - 13;
+    }
+    for (uint8_t i = valueLen; i > 0; i--) {
+        txBuffer[pos++] = (value >> (8 * (i - 1))) & 0xFF;
+    }
+    lastOption = option;
+
+    return pos;
+}
+
+/**
+ * Adds the representation of a resource to the message in the transmit
+ * buffer as its payload.
+ * 
+ * @param hash Set to the hash of the representation as uint32_t*.
+ * 
+ * @return Returns the length of the message, or 0 if the representation
+ * didn't fit, as size_t.
+ */
+size_t CoapServer::addPayload(size_t pos, uint8_t resource, uint32_t *hash) {
+    size_t room = COAP_MAX_PACKET - pos - 1;
+    size_t payloadLen = resources[resource].get((char *)txBuffer + pos + 1, room);
+    if (payloadLen >= room) {
+
+        return 0;
+    }
+    *hash = CoapServer::hash(txBuffer + pos + 1, payloadLen);
+    if (payloadLen == 0) {
+        // No payload marker without a payload
+
+        return pos;
+    }
+    txBuffer[pos] = 0xFF;
+
+    return pos + 1 + payloadLen;
+}
+
+/**
+ * Adds the link format listing of the resources to the message in the
+ * transmit buffer as its payload.
+ * 
+ * @return Returns the length of the message as size_t.
+ */
+size_t CoapServer::addLinkFormat(size_t pos) {
+    txBuffer[pos++] = 0xFF;
+    for (size_t i = 0; i < resourceCount; i++) {
+        int written = snprintf(
+            (char *)txBuffer + pos, 
+            COAP_MAX_PACKET - pos, 
+            "%s<%s>;obs;ct=50", 
+            i == 0 ? "" : ",", 
+            resources[i].path
+        );
+        if (written < 0 || (size_t)written >= COAP_MAX_PACKET - pos) {
+            break;
+        }
+        pos += written;
+    }
+
+    return pos;
+}
+
+/**
+ * Sends the message in the transmit buffer.
+ */
+void CoapServer::send(IPAddress ip, uint16_t port, size_t length) {
+    udp.beginPacket(ip, port);
+    udp.write(txBuffer, length);
+    udp.endPacket();
+}
+
+/**
+ * Registers the client of the current request as an observer of the given
+ * resource, or renews its registration.
+ * 
+ * @return Returns the observer's slot or -1 if there is no room as int.
+ */
+int CoapServer::observe(uint8_t resource, const uint8_t *token, uint8_t tokenLen) {
+    int slot = -1;
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        if (
+            observers[i].used 
+            && observers[i].ip == udp.remoteIP() 
+            && observers[i].port == udp.remotePort() 
+            && observers[i].tokenLen == tokenLen 
+            && memcmp(observers[i].token, token, tokenLen) == 0
+        ) {
+            // Renewing
+            slot = i;
+            break;
+        }
+        if (!observers[i].used && slot == -1) {
+            slot = i;
+        }
+    }
+    if (slot == -1) {
+
+        return -1;
+    }
+    observers[slot].used = true;
+    observers[slot].ip = udp.remoteIP();
+    observers[slot].port = udp.remotePort();
+    memcpy(observers[slot].token, token, tokenLen);
+    observers[slot].tokenLen = tokenLen;
+    observers[slot].resource = resource;
+    observers[slot].registeredAt = millis();
+
+    return slot;
+}
+
+/**
+ * Deregisters the client of the current request as an observer.
+ */
+void CoapServer::forget(const uint8_t *token, uint8_t tokenLen) {
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        if (
+            observers[i].used 
+            && observers[i].ip == udp.remoteIP() 
+            && observers[i].port == udp.remotePort() 
+            && observers[i].tokenLen == tokenLen 
+            && memcmp(observers[i].token, token, tokenLen) == 0
+        ) {
+            observers[i].used = false;
+        }
+    }
+}
+
+/**
+ * Finds the registered resource with the given path.
+ * 
+ * @return Returns the index of the resource or -1 if there is none as int.
+ */
+int CoapServer::findResource(const char *path) {
+    for (size_t i = 0; i < resourceCount; i++) {
+        if (strcmp(resources[i].path, path) == 0) {
+
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,125 @@
+#ifndef CoapServer_h
+    #define CoapServer_h
+
+    #include <Arduino.h>
+    #include <WiFiUdp.h>
+    #include <IPAddress.h>
+    #include <functional>
+
+    #define COAP_PORT 5683
+    #define COAP_MAX_PACKET 320
+    #define COAP_MAX_RESOURCES 4
+    #define COAP_MAX_OBSERVERS 4
+    #define COAP_MAX_TOKEN 8
+    #define COAP_MAX_PATH 24
+    #define COAP_OBSERVE_LIFETIME_MS 600000UL // <-- Observers not heard from in this long are dropped
+
+    /* Message Types */
+    #define COAP_TYPE_CON 0
+    #define COAP_TYPE_NON 1
+    #define COAP_TYPE_ACK 2
+    #define COAP_TYPE_RST 3
+
+    /* Method And Response Codes (class << 5 | detail) */
+    #define COAP_GET 0x01
+    #define COAP_POST 0x02
+    #define COAP_PUT 0x03
+    #define COAP_CHANGED 0x44
+    #define COAP_CONTENT 0x45
+    #define COAP_BAD_REQUEST 0x80
+    #define COAP_NOT_FOUND 0x84
+    #define COAP_METHOD_NOT_ALLOWED 0x85
+    #define COAP_INTERNAL_ERROR 0xA0
+
+    /* Options Used */
+    #define COAP_OPTION_OBSERVE 6
+    #define COAP_OPTION_URI_PATH 11
+    #define COAP_OPTION_CONTENT_FORMAT 12
+
+    /* Content Formats */
+    #define COAP_FORMAT_TEXT 0
+    #define COAP_FORMAT_LINK 40
+    #define COAP_FORMAT_JSON 50
+
+    /**
+     * The CoapServer class serves resources over CoAP (RFC 7252) for
+     * building automation gateways, with Observe (RFC 7641) so they get
+     * pushed changes rather than having to poll.
+     * 
+     * Resources are registered with a path, a handler that writes their
+     * JSON representation into a buffer and optionally a handler that takes
+     * a PUT or POST payload and returns the response code. The link format
+     * listing of them is served at /.well-known/core.
+     * 
+     * A GET with the Observe option registers the client, taking one of
+     * COAP_MAX_OBSERVERS slots. After notifyChanged() each observer gets a
+     * notification, as a NON message, only if its resource's representation
+     * differs from what it was last sent. Observers are dropped when they
+     * answer a notification with a reset, deregister, or go without
+     * registering again for COAP_OBSERVE_LIFETIME_MS.
+     * 
+     * Messages are built in and read from two buffers of COAP_MAX_PACKET
+     * bytes set aside up front, nothing is allocated while serving.
+     * Block-wise transfer is not supported.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class CoapServer {
+        public:
+            typedef std::function<size_t(char *buffer, size_t size)> GetHandler;
+            typedef std::function<uint8_t(const char *payload, size_t length)> PutHandler;
+
+        private:
+            struct Resource {
+                const char     *path                            ;
+                GetHandler     get                              ;
+                PutHandler     put                              ;
+            } resources[COAP_MAX_RESOURCES];
+
+            struct Observer {
+                bool           used                             ;
+                IPAddress      ip                               ;
+                uint16_t       port                             ;
+                uint8_t        token        [COAP_MAX_TOKEN]    ;
+                uint8_t        tokenLen                         ;
+                uint8_t        resource                         ;
+                uint32_t       lastHash                         ;
+                uint16_t       lastMessageId                    ;
+                unsigned long  registeredAt                     ;
+            } observers[COAP_MAX_OBSERVERS];
+
+            WiFiUDP        udp                                  ;
+            bool           listening                            ;
+            size_t         resourceCount                        ;
+            uint8_t        rxBuffer     [COAP_MAX_PACKET]       ;
+            uint8_t        txBuffer     [COAP_MAX_PACKET]       ;
+            uint16_t       nextMessageId                        ;
+            uint32_t       observeSeq                           ;
+            uint32_t       notificationCount                    ;
+
+            void handleRequest(size_t length);
+            size_t beginMessage(uint8_t type, uint8_t code, uint16_t messageId, const uint8_t *token, uint8_t tokenLen);
+            size_t addOption(size_t pos, uint16_t &lastOption, uint16_t option, uint32_t value);
+            size_t addPayload(size_t pos, uint8_t resource, uint32_t *hash);
+            size_t addLinkFormat(size_t pos);
+            void send(IPAddress ip, uint16_t port, size_t length);
+            int observe(uint8_t resource, const uint8_t *token, uint8_t tokenLen);
+            void forget(const uint8_t *token, uint8_t tokenLen);
+            int findResource(const char *path);
+
+        public:
+            CoapServer();
+
+            bool on(const char *path, GetHandler get, PutHandler put = nullptr);
+            void begin();
+            void handle();
+            void notifyChanged();
+
+            uint8_t getObserverCount();
+            uint32_t getNotificationCount();
+
+            static uint32_t hash(const uint8_t *data, size_t length);
+    };
+
+#endif
@@ -0,0 +1,148 @@
+/*
+    CircadianCurve - A class that works out the shade of white and the
+    brightness for the time of day from a precomputed table.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "CircadianCurve.h"
+
+/**
+ * The shape of the day, as minute of the day, colour temperature in
+ * kelvin and brightness in percent. Runs on from the last point to the
+ * first over midnight.
+ */
+static const uint16_t PROGMEM CURVE_POINTS[][3] = {
+    {    0, 2200,  20 },
+    {  360, 2700,  50 },
+    {  480, 4000,  90 },
+    {  600, 5000, 100 },
+    {  900, 5000, 100 },
+    { 1080, 3500,  90 },
+    { 1200, 2700,  70 },
+    { 1320, 2200,  40 }
+};
+static const uint8_t CURVE_POINT_COUNT = sizeof(CURVE_POINTS) / sizeof(CURVE_POINTS[0]);
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+CircadianCurve::CircadianCurve() {
+    build(2700, 6500);
+}
+
+/**
+ * Fills in the table for a fixture's pair of channels.
+ * 
+ * @param warmKelvin The colour temperature of the warm channel as uint16_t.
+ * @param coolKelvin The colour temperature of the cool channel as uint16_t.
+ */
+void CircadianCurve::build(uint16_t warmKelvin, uint16_t coolKelvin) {
+    warmMired = 1000000UL / max(warmKelvin, (uint16_t)1000);
+    coolMired = 1000000UL / max(coolKelvin, (uint16_t)1000);
+
+    uint8_t point = CURVE_POINT_COUNT - 1;
+    for (uint8_t slot = 0; slot < CIRCADIAN_SLOTS; slot++) {
+        uint16_t minute = slot * CIRCADIAN_SLOT_MINUTES;
+        while (point + 1 < CURVE_POINT_COUNT && pgm_read_word(&CURVE_POINTS[point + 1][0]) <= minute) {
+            point++;
+        }
+        if (point == CURVE_POINT_COUNT - 1 && pgm_read_word(&CURVE_POINTS[0][0]) <= minute) {
+            // Past the first point, so no longer carried over from yesterday
+            point = 0;
+            while (point + 1 < CURVE_POINT_COUNT && pgm_read_word(&CURVE_POINTS[point + 1][0]) <= minute) {
+                point++;
+            }
+        }
+        uint8_t nextPoint = (point + 1) % CURVE_POINT_COUNT;
+
+        long fromMinute = pgm_read_word(&CURVE_POINTS[point][0]);
+        long toMinute = pgm_read_word(&CURVE_POINTS[nextPoint][0]);
+        long span = (toMinute - fromMinute + 1440) % 1440;
+        long into = (minute - fromMinute + 1440) % 1440;
+
+        long fromMired = 1000000L / pgm_read_word(&CURVE_POINTS[point][1]);
+        long toMired = 1000000L / pgm_read_word(&CURVE_POINTS[nextPoint][1]);
+        long fromPercent = pgm_read_word(&CURVE_POINTS[point][2]);
+        long toPercent = pgm_read_word(&CURVE_POINTS[nextPoint][2]);
+
+        mixes[slot] = miredToMix(fromMired + ((toMired - fromMired) * into) / span);
+        percents[slot] = fromPercent + ((toPercent - fromPercent) * into) / span;
+    }
+}
+
+/**
+ * Gets the mix of the two channels for a time of day.
+ * 
+ * @param minuteOfDay The local time as minutes since midnight as uint16_t.
+ * 
+ * @return Returns the 256ths of the output to go to the cool channel as
+ * uint16_t.
+ */
+uint16_t CircadianCurve::getMix(uint16_t minuteOfDay) {
+    uint8_t slot = (minuteOfDay / CIRCADIAN_SLOT_MINUTES) % CIRCADIAN_SLOTS;
+    int into = minuteOfDay % CIRCADIAN_SLOT_MINUTES;
+    int from = mixes[slot];
+    int to = mixes[(slot + 1) % CIRCADIAN_SLOTS];
+
+    return from + ((to - from) * into) / CIRCADIAN_SLOT_MINUTES;
+}
+
+/**
+ * Gets the brightness for a time of day, to be applied on top of the
+ * brightness asked for.
+ * 
+ * @param minuteOfDay The local time as minutes since midnight as uint16_t.
+ * 
+ * @return Returns the brightness in percent as uint8_t.
+ */
+uint8_t CircadianCurve::getPercent(uint16_t minuteOfDay) {
+    uint8_t slot = (minuteOfDay / CIRCADIAN_SLOT_MINUTES) % CIRCADIAN_SLOTS;
+    int into = minuteOfDay % CIRCADIAN_SLOT_MINUTES;
+    int from = percents[slot];
+    int to = percents[(slot + 1) % CIRCADIAN_SLOTS];
+
+    return from + ((to - from) * into) / CIRCADIAN_SLOT_MINUTES;
+}
+
+/**
+ * Works out the colour temperature a mix of the two channels gives.
+ * 
+ * @param mix The 256ths of the output on the cool channel as uint16_t.
+ * 
+ * @return Returns the colour temperature in kelvin as uint16_t.
+ */
+uint16_t CircadianCurve::mixToKelvin(uint16_t mix) {
+    long mired = warmMired - (((long)warmMired - coolMired) * mix) / CIRCADIAN_MIX_FULL;
+
+    return 1000000L / max(mired, 1L);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Works out the mix of the two channels that makes a colour temperature.
+ * 
+ * @param mired The colour temperature in mireds as uint16_t.
+ * 
+ * @return Returns the 256ths of the output to go to the cool channel as
+ * uint16_t.
+ */
+uint16_t CircadianCurve::miredToMix(uint16_t mired) {
+    if (warmMired <= coolMired || mired >= warmMired) {
+        // Warmest there is, or the channels make no range
+
+        return 0;
+    }
+    if (mired <= coolMired) {
+
+        return CIRCADIAN_MIX_FULL;
+    }
+
+    return ((uint32_t)(warmMired - mired) * CIRCADIAN_MIX_FULL) / (warmMired - coolMired);
+}
@@ -0,0 +1,48 @@
+#ifndef CircadianCurve_h
+    #define CircadianCurve_h
+
+    #include <Arduino.h>
+
+    #define CIRCADIAN_SLOTS 48
+    #define CIRCADIAN_SLOT_MINUTES 30
+    #define CIRCADIAN_MIX_FULL 256 // <-- Same scale as the dimmer's mix
+
+    /**
+     * The CircadianCurve class follows the colour temperature and
+     * brightness of daylight over the day, from a warm dim glow at night
+     * to cool white through the middle of the day, for fixtures with warm
+     * and cool white channels.
+     * 
+     * The shape of the day is a handful of points in flash. Interpolating
+     * between those in mireds, on a fixture's pair of channels, is done
+     * once by build() into a table of CIRCADIAN_SLOTS half hour slots,
+     * each holding the mix of the two channels and the brightness. Asking
+     * for a minute of the day then only interpolates between two slots,
+     * all in integers, so nothing about colour is worked out while the
+     * lights run.
+     * 
+     * Colour temperatures beyond what the fixture's channels can make are
+     * held at the nearest channel.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class CircadianCurve {
+        private:
+            uint16_t       mixes        [CIRCADIAN_SLOTS]      ;
+            uint8_t        percents     [CIRCADIAN_SLOTS]      ;
+            uint16_t       warmMired                           ;
+            uint16_t       coolMired                           ;
+
+            uint16_t miredToMix(uint16_t mired);
+
+        public:
+            CircadianCurve();
+
+            void build(uint16_t warmKelvin, uint16_t coolKelvin);
+            uint16_t getMix(uint16_t minuteOfDay);
+            uint8_t getPercent(uint16_t minuteOfDay);
+            uint16_t mixToKelvin(uint16_t mix);
+    };
+
+#endif
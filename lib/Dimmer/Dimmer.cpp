@@ -0,0 +1,157 @@
+/*
+    Dimmer - A class that fades the lights toward a target brightness
+    using PWM.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "Dimmer.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+Dimmer::Dimmer() {
+    pin = 0;
+    level = 0;
+    targetLevel = 0;
+    targetPercent = 0;
+    coolPin = DIMMER_NO_PIN;
+    mix = 0;
+    targetMix = 0;
+    lastTickAt = 0;
+}
+
+/**
+ * Sets up PWM on the pin and outputs the given brightness right away,
+ * without fading to it.
+ * 
+ * @param pin The pin driving the lights, or their warm channel, as uint8_t.
+ * @param coolPin The pin driving the cool channel, or DIMMER_NO_PIN, as
+ * uint8_t.
+ * @param percent The brightness to start at, 0 being off, as uint8_t.
+ */
+void Dimmer::begin(uint8_t pin, uint8_t coolPin, uint8_t percent) {
+    this->pin = pin;
+    this->coolPin = coolPin;
+    analogWriteRange(DIMMER_PWM_RANGE);
+    setTarget(percent);
+    level = targetLevel;
+    write();
+    lastTickAt = millis();
+}
+
+/**
+ * Sets the brightness to fade to.
+ * 
+ * @param percent The brightness, 0 being off, as uint8_t.
+ */
+void Dimmer::setTarget(uint8_t percent) {
+    targetPercent = min(percent, (uint8_t)100);
+    targetLevel = percentToLevel(targetPercent);
+}
+
+uint8_t Dimmer::getTarget() {
+
+    return targetPercent;
+}
+
+/**
+ * Sets the mix of warm and cool white to fade to.
+ * 
+ * @param mix The 256ths of the output to go to the cool channel as uint16_t.
+ */
+void Dimmer::setMix(uint16_t mix) {
+    targetMix = min(mix, (uint16_t)DIMMER_MIX_FULL);
+}
+
+uint16_t Dimmer::getMix() {
+
+    return targetMix;
+}
+
+uint16_t Dimmer::getLevel() {
+
+    return level;
+}
+
+bool Dimmer::isFading() {
+
+    return level != targetLevel || mix != targetMix;
+}
+
+/**
+ * Moves the output a step toward the target once every tick. Should be
+ * called every time through the main loop.
+ */
+void Dimmer::handle() {
+    if (!isFading() || millis() - lastTickAt < DIMMER_TICK_MS) {
+
+        return;
+    }
+    lastTickAt = millis();
+    level = stepToward(level, targetLevel);
+    mix = stepToward(mix, targetMix);
+    write();
+}
+
+/**
+ * Maps a brightness onto the PWM range along a square law curve. Anything
+ * above 0 percent gives at least the lowest level.
+ * 
+ * @param percent The brightness as uint8_t.
+ * 
+ * @return Returns the PWM level as uint16_t.
+ */
+uint16_t Dimmer::percentToLevel(uint8_t percent) {
+    if (percent == 0) {
+
+        return 0;
+    }
+    uint32_t level = ((uint32_t)percent * percent * DIMMER_PWM_RANGE + 5000UL) / 10000UL;
+
+    return max(level, (uint32_t)1);
+}
+
+/**
+ * Works out the level one tick closer to the target, covering 1/8th of
+ * the way left but always at least one step.
+ * 
+ * @param level The current level as uint16_t.
+ * @param targetLevel The level being faded to as uint16_t.
+ * 
+ * @return Returns the next level as uint16_t.
+ */
+uint16_t Dimmer::stepToward(uint16_t level, uint16_t targetLevel) {
+    if (level < targetLevel) {
+
+        return level + max((targetLevel - level) >> DIMMER_FADE_SHIFT, 1);
+    }
+    if (level > targetLevel) {
+
+        return level - max((level - targetLevel) >> DIMMER_FADE_SHIFT, 1);
+    }
+
+    return level;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Outputs the current level to the pin, split by the mix when there is a
+ * cool channel.
+ */
+void Dimmer::write() {
+    if (coolPin == DIMMER_NO_PIN) {
+        analogWrite(pin, level);
+
+        return;
+    }
+    uint16_t coolLevel = ((uint32_t)level * mix) >> DIMMER_MIX_SHIFT;
+    analogWrite(pin, level - coolLevel);
+    analogWrite(coolPin, coolLevel);
+}
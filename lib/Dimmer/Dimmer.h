@@ -0,0 +1,63 @@
+#ifndef Dimmer_h
+    #define Dimmer_h
+
+    #include <Arduino.h>
+
+    #define DIMMER_PWM_RANGE 1023
+    #define DIMMER_TICK_MS 10UL
+    #define DIMMER_FADE_SHIFT 3 // <-- Each tick covers 1/8th of the way left
+    #define DIMMER_MIX_SHIFT 8
+    #define DIMMER_MIX_FULL (1 << DIMMER_MIX_SHIFT) // <-- Mix putting all output on the cool channel
+    #define DIMMER_NO_PIN 0xFF
+
+    /**
+     * The Dimmer class drives the lights with PWM so they can be dimmed.
+     * 
+     * The brightness asked for is only a target, the output is moved
+     * toward it once every DIMMER_TICK_MS, covering 1/8th of the way left
+     * each tick. Changes therefore fade in smoothly, and however often the
+     * target changes between ticks only the latest one is ever acted on.
+     * 
+     * Brightness is given in percent and mapped onto the PWM range along
+     * a square law curve, which looks close to even steps to the eye.
+     * 
+     * Fixtures with warm and cool white channels have the cool one on a
+     * second pin. The output is split between them by a mix, in 256ths
+     * going to the cool channel, so the shade changes while the total
+     * stays the same. The mix fades toward its target along with the
+     * level, and the split is a multiply and a shift per tick. Without a
+     * second pin all the output stays on the first.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class Dimmer {
+        private:
+            uint8_t        pin              ;
+            uint16_t       level            ; // current PWM level
+            uint16_t       targetLevel      ;
+            uint8_t        targetPercent    ;
+            uint8_t        coolPin          ;
+            uint16_t       mix              ; // current 256ths on the cool channel
+            uint16_t       targetMix        ;
+            unsigned long  lastTickAt       ;
+
+            void write();
+
+        public:
+            Dimmer();
+
+            void begin(uint8_t pin, uint8_t coolPin, uint8_t percent);
+            void setTarget(uint8_t percent);
+            uint8_t getTarget();
+            void setMix(uint16_t mix);
+            uint16_t getMix();
+            uint16_t getLevel();
+            bool isFading();
+            void handle();
+
+            static uint16_t percentToLevel(uint8_t percent);
+            static uint16_t stepToward(uint16_t level, uint16_t targetLevel);
+    };
+
+#endif
@@ -0,0 +1,96 @@
+/*
+    Discovery - A class that answers UDP fleet discovery probes with a 
+    single prebuilt packet describing the device.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "Discovery.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+Discovery::Discovery() {
+    firmwareVersion = "";
+    payload[0] = '\0';
+    payloadLen = 0;
+    lightsOn = false;
+    timerOn = false;
+    ip = 0;
+}
+
+/**
+ * Starts listening for discovery probes.
+ * 
+ * @param deviceId The ID of this device as String.
+ * @param firmwareVersion The running firmware version as const char pointer.
+ */
+void Discovery::begin(String deviceId, const char *firmwareVersion) {
+    this->deviceId = deviceId;
+    this->firmwareVersion = firmwareVersion;
+    buildPayload();
+    udp.begin(DISCOVERY_PORT);
+}
+
+/**
+ * Updates the state described by the reply. The reply is only
+ * rebuilt if something actually changed.
+ * 
+ * @param lightsOn Indicates if the lights are on as bool.
+ * @param timerOn Indicates if the timer is enabled as bool.
+ * @param ip The address the device can be reached at as IPAddress.
+ */
+void Discovery::setState(bool lightsOn, bool timerOn, IPAddress ip) {
+    if (lightsOn != this->lightsOn || timerOn != this->timerOn || (uint32_t)ip != this->ip) {
+        this->lightsOn = lightsOn;
+        this->timerOn = timerOn;
+        this->ip = (uint32_t)ip;
+        buildPayload();
+    }
+}
+
+/**
+ * Answers any probe that has arrived. Anything else sent to the 
+ * discovery port is ignored.
+ */
+void Discovery::handle() {
+    int size = udp.parsePacket();
+    if (size <= 0) {
+
+        return;
+    }
+
+    char probe[sizeof(DISCOVERY_PROBE)];
+    int len = udp.read(probe, sizeof(probe));
+    if (len == (int)strlen(DISCOVERY_PROBE) && memcmp(probe, DISCOVERY_PROBE, len) == 0) {
+        udp.beginPacket(udp.remoteIP(), udp.remotePort());
+        udp.write((const uint8_t *)payload, payloadLen);
+        udp.endPacket();
+    }
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Renders the reply packet into the payload buffer.
+ */
+void Discovery::buildPayload() {
+    int len = snprintf(
+        payload, 
+        sizeof(payload), 
+        "{\"id\":\"%s\",\"fw\":\"%s\",\"ip\":\"%u.%u.%u.%u\",\"light\":%d,\"timer\":%d}",
+        deviceId.c_str(),
+        firmwareVersion,
+        (unsigned int)(ip & 0xFF), (unsigned int)((ip >> 8) & 0xFF), (unsigned int)((ip >> 16) & 0xFF), (unsigned int)(ip >> 24),
+        lightsOn ? 1 : 0,
+        timerOn ? 1 : 0
+    );
+    payloadLen = len < 0 ? 0 : min((size_t)len, sizeof(payload) - 1);
+}
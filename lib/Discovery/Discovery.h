@@ -0,0 +1,47 @@
+#ifndef Discovery_h
+    #define Discovery_h
+
+    #include <Arduino.h>
+    #include <WiFiUdp.h>
+    #include <IPAddress.h>
+
+    #define DISCOVERY_PORT 42100
+    #define DISCOVERY_PROBE "LUMEN?"
+    #define DISCOVERY_PAYLOAD_SIZE 160
+
+    /**
+     * The Discovery class answers fleet discovery probes sent over UDP. A 
+     * probe is the text "LUMEN?" sent, usually broadcast, to DISCOVERY_PORT.
+     * Every device that hears it replies to the sender with a single packet
+     * of JSON describing itself, for example:
+     * 
+     *   {"id":"A1B2C3","fw":"1.1.2","ip":"192.168.0.20","light":1,"timer":0}
+     * 
+     * The reply is prebuilt and only rebuilt when the state it describes
+     * changes, so answering a probe is nothing more than sending a buffer.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class Discovery {
+        private:
+            WiFiUDP        udp                                        ;
+            String         deviceId                                   ;
+            const char     *firmwareVersion                           ;
+            char           payload      [DISCOVERY_PAYLOAD_SIZE]      ;
+            size_t         payloadLen                                 ;
+            bool           lightsOn                                   ;
+            bool           timerOn                                    ;
+            uint32_t       ip                                         ;
+
+            void buildPayload();
+
+        public:
+            Discovery();
+
+            void begin(String deviceId, const char *firmwareVersion);
+            void setState(bool lightsOn, bool timerOn, IPAddress ip);
+            void handle();
+    };
+
+#endif
@@ -0,0 +1,254 @@
+/*
+    EventLog - A class that keeps a fixed size history of changes to the
+    state of the lights, saved to flash lazily.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "EventLog.h"
+
+static const char PROGMEM SOURCE_NAMES[EVENT_SOURCE_COUNT][8] = {
+    "boot", "button", "web", "api", "group", "udp", "socket", "coap", "mqtt", "timer", "ambient", "motion"
+};
+
+static const char PROGMEM KIND_NAMES[EVENT_KIND_COUNT][9] = {
+    "boot", "light", "level", "timer", "vacation"
+};
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+EventLog::EventLog() {
+    memset(events, 0, sizeof(events));
+    head = 0;
+    count = 0;
+    nextSeq = 0;
+    isMounted = false;
+    isDirty = false;
+    dirtySince = 0;
+    lastRecordAt = 0;
+}
+
+/**
+ * Mounts the file system and loads the log saved in it, if any.
+ *
+ * @return Returns true if a saved log was loaded otherwise false as bool.
+ */
+bool EventLog::begin() {
+    isMounted = LittleFS.begin();
+    if (!isMounted) {
+        Serial.println(F("Unable to mount file system, event log is not saved!"));
+
+        return false;
+    }
+
+    return load();
+}
+
+/**
+ * Saves the log once it is due. Should be called every time through the
+ * main loop.
+ */
+void EventLog::handle() {
+    if (isDirty && millis() - dirtySince >= EVENT_FLUSH_DELAY) {
+        flush();
+    }
+}
+
+/**
+ * Saves the log to flash now, if anything changed since last saved.
+ *
+ * @return Returns true if the log is saved otherwise false as bool.
+ */
+bool EventLog::flush() {
+    if (!isDirty) {
+
+        return true;
+    }
+    if (!isMounted) {
+        isDirty = false;
+
+        return false;
+    }
+
+    File file = LittleFS.open(EVENT_LOG_TEMP, "w");
+    if (!file) {
+        // Try again later
+        dirtySince = millis();
+
+        return false;
+    }
+
+    FileHeader header = { EVENT_LOG_MAGIC, nextSeq, count, 0 };
+    bool ok = file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+
+    // Oldest first, in up to two runs either side of the end of the ring
+    uint16_t firstRun = min<uint16_t>(count, EVENT_LOG_SIZE - head);
+    ok = ok && file.write((const uint8_t *)&events[head], firstRun * sizeof(Event)) == firstRun * sizeof(Event);
+    ok = ok && file.write((const uint8_t *)events, (count - firstRun) * sizeof(Event)) == (count - firstRun) * sizeof(Event);
+    file.close();
+
+    ok = ok && LittleFS.rename(EVENT_LOG_TEMP, EVENT_LOG_FILE);
+    if (ok) {
+        isDirty = false;
+    } else {
+        dirtySince = millis();
+    }
+
+    return ok;
+}
+
+/**
+ * Records an event, overwriting the oldest once the log is full.
+ *
+ * @param time When the event happened in seconds as uint32_t.
+ * @param isUptime Indicates the time is since boot rather than epoch as bool.
+ * @param source What made the change, an EVENT_SOURCE as uint8_t.
+ * @param kind What changed, an EVENT_KIND as uint8_t.
+ * @param from The value before the change as uint8_t.
+ * @param to The value after the change as uint8_t.
+ */
+void EventLog::record(uint32_t time, bool isUptime, uint8_t source, uint8_t kind, uint8_t from, uint8_t to) {
+    uint8_t flaggedKind = kind | (isUptime ? EVENT_FLAG_UPTIME : 0);
+
+    if (kind == EVENT_KIND_LEVEL && count > 0 && millis() - lastRecordAt < EVENT_MERGE_MS) {
+        Event &last = events[(head + count - 1) % EVENT_LOG_SIZE];
+        if (last.kind == flaggedKind && last.source == source) {
+            // Same slider still moving
+            last.time = time;
+            last.to = to;
+            lastRecordAt = millis();
+            if (!isDirty) {
+                isDirty = true;
+                dirtySince = millis();
+            }
+
+            return;
+        }
+    }
+
+    Event event = { time, source, flaggedKind, from, to };
+    if (count < EVENT_LOG_SIZE) {
+        events[(head + count) % EVENT_LOG_SIZE] = event;
+        count++;
+    } else {
+        events[head] = event;
+        head = (head + 1) % EVENT_LOG_SIZE;
+    }
+    nextSeq++;
+    lastRecordAt = millis();
+    if (!isDirty) {
+        isDirty = true;
+        dirtySince = millis();
+    }
+}
+
+/**
+ * Gets the event with the given sequence number.
+ *
+ * @param seq The sequence number of the event as uint32_t.
+ * @param event Set to the event as Event&.
+ *
+ * @return Returns true if the event is still in the log otherwise false as bool.
+ */
+bool EventLog::get(uint32_t seq, Event &event) {
+    if (seq < getFirstSeq() || seq >= nextSeq) {
+
+        return false;
+    }
+    event = events[(head + (seq - getFirstSeq())) % EVENT_LOG_SIZE];
+
+    return true;
+}
+
+/**
+ * Formats the event with the given sequence number as a JSON object, such
+ * as {"seq":7,"t":1760000000,"src":"button","kind":"light","from":0,"to":1}.
+ * When the time is since boot "up":true is added.
+ *
+ * @param seq The sequence number of the event as uint32_t.
+ * @param buffer Where to write the JSON as char*.
+ * @param size The size of the buffer as size_t.
+ *
+ * @return Returns the length of the JSON or 0 if the event is not in the
+ * log as size_t.
+ */
+size_t EventLog::format(uint32_t seq, char *buffer, size_t size) {
+    Event event;
+    if (!get(seq, event) || event.source >= EVENT_SOURCE_COUNT || (event.kind & EVENT_KIND_MASK) >= EVENT_KIND_COUNT) {
+
+        return 0;
+    }
+
+    char source[8];
+    char kind[9];
+    strcpy_P(source, SOURCE_NAMES[event.source]);
+    strcpy_P(kind, KIND_NAMES[event.kind & EVENT_KIND_MASK]);
+
+    int length = snprintf_P(
+        buffer,
+        size,
+        PSTR("{\"seq\":%lu,\"t\":%lu,%s\"src\":\"%s\",\"kind\":\"%s\",\"from\":%u,\"to\":%u}"),
+        (unsigned long)seq,
+        (unsigned long)event.time,
+        (event.kind & EVENT_FLAG_UPTIME) ? "\"up\":true," : "",
+        source,
+        kind,
+        event.from,
+        event.to
+    );
+
+    return length > 0 && (size_t)length < size ? length : 0;
+}
+
+uint32_t EventLog::getFirstSeq() {
+
+    return nextSeq - count;
+}
+
+uint32_t EventLog::getNextSeq() {
+
+    return nextSeq;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Loads the log saved in flash, leaving the log empty if there is none or
+ * it isn't valid.
+ *
+ * @return Returns true if loaded otherwise false as bool.
+ */
+bool EventLog::load() {
+    File file = LittleFS.open(EVENT_LOG_FILE, "r");
+    if (!file) {
+
+        return false;
+    }
+
+    FileHeader header;
+    bool ok = (
+        file.read((uint8_t *)&header, sizeof(header)) == sizeof(header)
+        && header.magic == EVENT_LOG_MAGIC
+        && header.count <= EVENT_LOG_SIZE
+        && header.count <= header.nextSeq
+        && file.read((uint8_t *)events, header.count * sizeof(Event)) == header.count * sizeof(Event)
+    );
+    file.close();
+
+    head = 0;
+    if (ok) {
+        count = header.count;
+        nextSeq = header.nextSeq;
+    } else {
+        count = 0;
+        nextSeq = 0;
+    }
+
+    return ok;
+}
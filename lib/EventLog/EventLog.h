@@ -0,0 +1,104 @@
+#ifndef EventLog_h
+    #define EventLog_h
+
+    #include <Arduino.h>
+    #include <LittleFS.h>
+
+    #define EVENT_LOG_SIZE 128
+    #define EVENT_LOG_FILE "/events.bin"
+    #define EVENT_LOG_TEMP "/events.tmp"
+    #define EVENT_LOG_MAGIC 0x4C45564EUL
+    #define EVENT_FLUSH_DELAY 300000UL // <-- Events written to flash this long after the first unsaved one (ms)
+    #define EVENT_MERGE_MS 3000UL // <------- Level events from one source merged when this close together (ms)
+
+    #define EVENT_SOURCE_BOOT 0
+    #define EVENT_SOURCE_BUTTON 1
+    #define EVENT_SOURCE_WEB 2
+    #define EVENT_SOURCE_API 3
+    #define EVENT_SOURCE_GROUP 4
+    #define EVENT_SOURCE_UDP 5
+    #define EVENT_SOURCE_SOCKET 6
+    #define EVENT_SOURCE_COAP 7
+    #define EVENT_SOURCE_MQTT 8
+    #define EVENT_SOURCE_TIMER 9
+    #define EVENT_SOURCE_AMBIENT 10
+    #define EVENT_SOURCE_MOTION 11
+    #define EVENT_SOURCE_COUNT 12
+
+    #define EVENT_KIND_BOOT 0 // <---- from is the reset reason, to is the restored light state
+    #define EVENT_KIND_LIGHT 1
+    #define EVENT_KIND_LEVEL 2
+    #define EVENT_KIND_TIMER 3
+    #define EVENT_KIND_VACATION 4
+    #define EVENT_KIND_COUNT 5
+    #define EVENT_KIND_MASK 0x7F
+    #define EVENT_FLAG_UPTIME 0x80 // <-- Time is seconds since boot as the clock was not set
+
+    /**
+     * An entry in the event log, 8 bytes.
+     */
+    struct Event {
+        uint32_t       time             ; // epoch seconds, or uptime seconds if flagged
+        uint8_t        source           ;
+        uint8_t        kind             ; // kind | flags
+        uint8_t        from             ;
+        uint8_t        to               ;
+    };
+
+    /**
+     * The EventLog class keeps a history of changes to the state of the
+     * lights, recording what changed, from what to what, when and what
+     * made the change (the button, a web page, the timer and so on). It is
+     * there to answer "why did the lights come on by themselves".
+     *
+     * The log is a fixed ring of EVENT_LOG_SIZE entries in RAM, the oldest
+     * being overwritten once full. Each entry has a sequence number that
+     * keeps counting across restarts, which is what pages are asked for by.
+     *
+     * The log is written to LittleFS lazily, EVENT_FLUSH_DELAY after the
+     * first event not yet saved, so a burst of changes costs one write.
+     * It goes to a temporary file renamed over the last one, so losing
+     * power mid-write leaves the previous log intact. A restart should be
+     * preceded by flush() so nothing is lost with it.
+     *
+     * Dragging a brightness slider would fill the log with level events,
+     * so level events from the same source within EVENT_MERGE_MS of the
+     * last one update it instead of adding another.
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class EventLog {
+        private:
+            struct FileHeader {
+                uint32_t       magic            ;
+                uint32_t       nextSeq          ;
+                uint16_t       count            ;
+                uint16_t       reserved         ;
+            };
+
+            Event              events       [EVENT_LOG_SIZE]   ;
+            uint16_t           head                            ; // index of the oldest event
+            uint16_t           count                           ;
+            uint32_t           nextSeq                         ;
+            bool               isMounted                       ;
+            bool               isDirty                         ;
+            unsigned long      dirtySince                      ;
+            unsigned long      lastRecordAt                    ;
+
+            bool load();
+
+        public:
+            EventLog();
+
+            bool begin();
+            void handle();
+            bool flush();
+            void record(uint32_t time, bool isUptime, uint8_t source, uint8_t kind, uint8_t from, uint8_t to);
+            bool get(uint32_t seq, Event &event);
+            size_t format(uint32_t seq, char *buffer, size_t size);
+            uint32_t getFirstSeq();
+            uint32_t getNextSeq();
+    };
+
+#endif
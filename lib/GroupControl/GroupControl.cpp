@@ -0,0 +1,245 @@
+/*
+    GroupControl - A class that sends and receives compact multicast 
+    commands so a group of controllers can be switched together.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "GroupControl.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+GroupControl::GroupControl() {
+    memset(senders, 0, sizeof(senders));
+    listening = false;
+    interfaceIp = 0;
+    groupId = 0;
+    memset(senderId, 0, sizeof(senderId));
+    bootNonce = 0;
+    nextSeq = 1;
+    copiesLeft = 0;
+    lastCopyAt = 0;
+}
+
+/**
+ * Sets up the identity this device sends commands with.
+ * 
+ * @param deviceId The six hex char ID of this device as String.
+ * @param bootNonce A value that differs from boot to boot as uint16_t.
+ */
+void GroupControl::begin(String deviceId, uint16_t bootNonce) {
+    for (int i = 0; i < 3; i++) {
+        senderId[i] = (uint8_t)strtoul(deviceId.substring(i * 2, (i * 2) + 2).c_str(), nullptr, 16);
+    }
+    this->bootNonce = bootNonce;
+}
+
+/**
+ * Sets the group this device belongs to, zero leaves all groups.
+ * 
+ * @param groupId The ID of the group as uint16_t.
+ */
+void GroupControl::setGroupId(uint16_t groupId) {
+    this->groupId = groupId;
+    if (groupId == 0 && listening) {
+        udp.stop();
+        listening = false;
+    }
+}
+
+/**
+ * Tells the group control about the state of the STA interface. The
+ * multicast group is (re)joined whenever the interface comes up or
+ * its address changes.
+ * 
+ * @param connected Indicates if the STA interface is connected as bool.
+ * @param ip The address of the STA interface as IPAddress.
+ */
+void GroupControl::setInterface(bool connected, IPAddress ip) {
+    if (!connected || groupId == 0) {
+        if (listening) {
+            udp.stop();
+            listening = false;
+        }
+        
+        return;
+    }
+    if (!listening || (uint32_t)ip != interfaceIp) {
+        udp.stop();
+        listening = udp.beginMulticast(ip, GROUP_MULTICAST_IP, GROUP_PORT) == 1;
+        interfaceIp = (uint32_t)ip;
+    }
+}
+
+/**
+ * Sends the given command to the group. The first copy goes out 
+ * immediately, the rest are sent by handle().
+ * 
+ * @param command The command to send as uint8_t.
+ * 
+ * @return Returns true if sent otherwise false as bool.
+ */
+bool GroupControl::send(uint8_t command) {
+    if (!listening) {
+
+        return false;
+    }
+    encode(outPacket, command, groupId, senderId, bootNonce, nextSeq);
+    nextSeq = (nextSeq + 1) & 0xFFFFFF;
+    if (nextSeq == 0) {
+        // Zero marks an unused sender entry on the receiving end
+        nextSeq = 1;
+    }
+    copiesLeft = GROUP_SEND_COPIES;
+    sendCopy();
+
+    return true;
+}
+
+/**
+ * Sends any pending copies of the last command and reads the next
+ * received packet, if any.
+ * 
+ * @return Returns the command to act on or GROUP_CMD_NONE as uint8_t.
+ */
+uint8_t GroupControl::handle() {
+    if (!listening) {
+
+        return GROUP_CMD_NONE;
+    }
+    if (copiesLeft > 0 && millis() - lastCopyAt >= 15UL) {
+        sendCopy();
+    }
+
+    if (udp.parsePacket() <= 0) {
+
+        return GROUP_CMD_NONE;
+    }
+    uint8_t packet[GROUP_PACKET_SIZE];
+    int len = udp.read(packet, sizeof(packet));
+
+    uint8_t command;
+    uint16_t packetGroupId;
+    uint8_t senderKey[5];
+    uint32_t seq;
+    if (
+        len <= 0
+        || !decode(packet, len, command, packetGroupId, senderKey, seq) 
+        || packetGroupId != groupId
+        || seq == 0
+        || (memcmp(senderKey, senderId, 3) == 0 && (senderKey[3] | (senderKey[4] << 8)) == bootNonce)
+        || isDuplicate(senderKey, seq, millis())
+    ) {
+        // Not for us, our own echo, or a copy already acted on
+
+        return GROUP_CMD_NONE;
+    }
+
+    return command;
+}
+
+/**
+ * Builds a command packet.
+ * 
+ * @return Returns the size of the packet as size_t.
+ */
+size_t GroupControl::encode(uint8_t *packet, uint8_t command, uint16_t groupId, const uint8_t *senderId, uint16_t bootNonce, uint32_t seq) {
+    packet[0] = 'L';
+    packet[1] = 'G';
+    packet[2] = 1;
+    packet[3] = command;
+    packet[4] = groupId & 0xFF;
+    packet[5] = groupId >> 8;
+    memcpy(packet + 6, senderId, 3);
+    packet[9] = bootNonce & 0xFF;
+    packet[10] = bootNonce >> 8;
+    packet[11] = seq & 0xFF;
+    packet[12] = (seq >> 8) & 0xFF;
+    packet[13] = (seq >> 16) & 0xFF;
+
+    return GROUP_PACKET_SIZE;
+}
+
+/**
+ * Parses a command packet.
+ * 
+ * @param senderKey Receives the sender ID and boot nonce as 5 bytes.
+ * 
+ * @return Returns true if the packet is a valid command otherwise false as bool.
+ */
+bool GroupControl::decode(const uint8_t *packet, size_t len, uint8_t &command, uint16_t &groupId, uint8_t *senderKey, uint32_t &seq) {
+    if (len != GROUP_PACKET_SIZE || packet[0] != 'L' || packet[1] != 'G' || packet[2] != 1) {
+
+        return false;
+    }
+    command = packet[3];
+    if (command != GROUP_CMD_ON && command != GROUP_CMD_OFF) {
+
+        return false;
+    }
+    groupId = packet[4] | (packet[5] << 8);
+    memcpy(senderKey, packet + 6, 5);
+    seq = packet[11] | (packet[12] << 8) | ((uint32_t)packet[13] << 16);
+
+    return true;
+}
+
+/**
+ * Used to determine if a command has already been seen, recording it if not.
+ * A sequence number counts as new when it is ahead of the last one seen from
+ * the same sender and boot, allowing for the 24 bit counter wrapping. When
+ * the table is full the sender heard from least recently is forgotten.
+ * 
+ * @param senderKey The sender ID and boot nonce as 5 bytes.
+ * @param seq The sequence number of the command as uint32_t.
+ * @param now The current millis as unsigned long.
+ * 
+ * @return Returns true if already seen otherwise false as bool.
+ */
+bool GroupControl::isDuplicate(const uint8_t *senderKey, uint32_t seq, unsigned long now) {
+    SenderEntry *oldest = &senders[0];
+    for (int i = 0; i < GROUP_MAX_SENDERS; i++) {
+        SenderEntry &entry = senders[i];
+        if (entry.lastSeq != 0 && memcmp(entry.id, senderKey, 5) == 0) {
+            uint32_t ahead = (seq - entry.lastSeq) & 0xFFFFFF;
+            if (ahead == 0 || ahead >= 0x800000) {
+
+                return true;
+            }
+            entry.lastSeq = seq;
+            entry.lastSeen = now;
+
+            return false;
+        }
+        if (oldest->lastSeq != 0 && (entry.lastSeq == 0 || now - entry.lastSeen > now - oldest->lastSeen)) {
+            oldest = &entry;
+        }
+    }
+
+    memcpy(oldest->id, senderKey, 5);
+    oldest->lastSeq = seq;
+    oldest->lastSeen = now;
+
+    return false;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Sends one copy of the pending command packet.
+ */
+void GroupControl::sendCopy() {
+    udp.beginPacketMulticast(GROUP_MULTICAST_IP, GROUP_PORT, IPAddress(interfaceIp), 1);
+    udp.write(outPacket, GROUP_PACKET_SIZE);
+    udp.endPacket();
+    copiesLeft--;
+    lastCopyAt = millis();
+}
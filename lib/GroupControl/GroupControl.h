@@ -0,0 +1,75 @@
+#ifndef GroupControl_h
+    #define GroupControl_h
+
+    #include <Arduino.h>
+    #include <WiFiUdp.h>
+    #include <IPAddress.h>
+
+    #define GROUP_PORT 42101
+    #define GROUP_MULTICAST_IP IPAddress(239, 255, 76, 77)
+    #define GROUP_PACKET_SIZE 14
+    #define GROUP_MAX_SENDERS 8
+    #define GROUP_SEND_COPIES 3
+
+    #define GROUP_CMD_NONE 0
+    #define GROUP_CMD_ON 1
+    #define GROUP_CMD_OFF 2
+
+    /**
+     * The GroupControl class lets one command switch every controller in a 
+     * group at the same time. Commands are sent as a single small packet to
+     * a multicast address, so the whole group hears it at once no matter how
+     * many members there are.
+     * 
+     * A packet is 14 bytes (multi byte values little endian):
+     *   0  'L', 'G' magic
+     *   2  protocol version (1)
+     *   3  command (GROUP_CMD_ON or GROUP_CMD_OFF)
+     *   4  group ID as uint16
+     *   6  sender ID as 3 bytes (the device ID in binary)
+     *   9  sender boot nonce as uint16
+     *   11 sequence number as uint24
+     * 
+     * Since UDP may drop packets each command is sent GROUP_SEND_COPIES times
+     * a few milliseconds apart. Receivers remember the last sequence number
+     * seen from each sender and boot, so the copies are only acted on once.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class GroupControl {
+        private:
+            struct SenderEntry {
+                uint8_t        id           [5]    ; // sender ID + boot nonce
+                uint32_t       lastSeq             ;
+                unsigned long  lastSeen            ;
+            } senders[GROUP_MAX_SENDERS];
+
+            WiFiUDP        udp                                  ;
+            bool           listening                            ;
+            uint32_t       interfaceIp                          ;
+            uint16_t       groupId                              ;
+            uint8_t        senderId     [3]                     ;
+            uint16_t       bootNonce                            ;
+            uint32_t       nextSeq                              ;
+            uint8_t        outPacket    [GROUP_PACKET_SIZE]     ;
+            uint8_t        copiesLeft                           ;
+            unsigned long  lastCopyAt                           ;
+
+            void sendCopy();
+
+        public:
+            GroupControl();
+
+            void begin(String deviceId, uint16_t bootNonce);
+            void setGroupId(uint16_t groupId);
+            void setInterface(bool connected, IPAddress ip);
+            bool send(uint8_t command);
+            uint8_t handle();
+
+            static size_t encode(uint8_t *packet, uint8_t command, uint16_t groupId, const uint8_t *senderId, uint16_t bootNonce, uint32_t seq);
+            static bool decode(const uint8_t *packet, size_t len, uint8_t &command, uint16_t &groupId, uint8_t *senderKey, uint32_t &seq);
+            bool isDuplicate(const uint8_t *senderKey, uint32_t seq, unsigned long now);
+    };
+
+#endif
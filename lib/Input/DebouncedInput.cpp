@@ -0,0 +1,75 @@
+/*
+    DebouncedInput - A class that debounces a digital input into edges.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "DebouncedInput.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+DebouncedInput::DebouncedInput() {
+    pin = 0;
+    debounceMs = 0;
+    level = false;
+    lastRead = false;
+    lastReadChangeAt = 0;
+}
+
+/**
+ * Sets up the pin as an input, taking the level it is at as settled so
+ * an input already high at boot gives no edge.
+ * 
+ * @param pin The pin to read as uint8_t.
+ * @param debounceMs How long a new level must hold to count (ms) as
+ * unsigned long.
+ */
+void DebouncedInput::begin(uint8_t pin, unsigned long debounceMs) {
+    this->pin = pin;
+    this->debounceMs = debounceMs;
+    pinMode(pin, INPUT);
+    level = digitalRead(pin) == HIGH;
+    lastRead = level;
+    lastReadChangeAt = millis();
+}
+
+/**
+ * Reads the input. Should be called every time through the main loop.
+ * 
+ * @return Returns the INPUT_EDGE_ seen as uint8_t.
+ */
+uint8_t DebouncedInput::handle() {
+
+    return update(digitalRead(pin) == HIGH);
+}
+
+/**
+ * Takes a reading of the input.
+ * 
+ * @param read The level read as bool.
+ * 
+ * @return Returns the INPUT_EDGE_ seen as uint8_t.
+ */
+uint8_t DebouncedInput::update(bool read) {
+    if (read != lastRead) {
+        // Still bouncing, start timing again
+        lastRead = read;
+        lastReadChangeAt = millis();
+
+        return INPUT_EDGE_NONE;
+    }
+    if (read == level || millis() - lastReadChangeAt < debounceMs) {
+
+        return INPUT_EDGE_NONE;
+    }
+    level = read;
+
+    return level ? INPUT_EDGE_RISE : INPUT_EDGE_FALL;
+}
+
+bool DebouncedInput::isHigh() {
+
+    return level;
+}
@@ -0,0 +1,37 @@
+#ifndef DebouncedInput_h
+    #define DebouncedInput_h
+
+    #include <Arduino.h>
+
+    #define INPUT_EDGE_NONE 0
+    #define INPUT_EDGE_RISE 1
+    #define INPUT_EDGE_FALL 2
+
+    /**
+     * The DebouncedInput class turns a digital input into clean edges. A
+     * new level only counts once it has held for the debounce time, so the
+     * bounce of a button's contacts or a glitch on a sensor's line gives a
+     * single edge. It is polled from the main loop and never waits for the
+     * input to settle or be released.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class DebouncedInput {
+        private:
+            uint8_t        pin              ;
+            unsigned long  debounceMs       ;
+            bool           level            ; // debounced level
+            bool           lastRead         ;
+            unsigned long  lastReadChangeAt ;
+
+        public:
+            DebouncedInput();
+
+            void begin(uint8_t pin, unsigned long debounceMs);
+            uint8_t handle();
+            uint8_t update(bool read);
+            bool isHigh();
+    };
+
+#endif
@@ -0,0 +1,93 @@
+/*
+    Occupancy - A class that switches the lights with a motion or occupancy
+    sensor, timing them out once the room is empty.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "Occupancy.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+Occupancy::Occupancy() {
+    timeoutMs = 300000UL;
+    isOccupied = false;
+    isOwner = false;
+    vacantSince = 0;
+}
+
+/**
+ * Sets how long the room must be empty before the lights go off.
+ * 
+ * @param timeoutMs The time (ms) as unsigned long.
+ */
+void Occupancy::setTimeout(unsigned long timeoutMs) {
+    this->timeoutMs = timeoutMs;
+}
+
+/**
+ * Notes the room becoming occupied.
+ * 
+ * @param isLightsOn Indicates the lights are on already as bool.
+ * 
+ * @return Returns the OCCUPANCY_ACTION_ to take as uint8_t.
+ */
+uint8_t Occupancy::occupied(bool isLightsOn) {
+    isOccupied = true;
+    if (isLightsOn) {
+        // Someone else's lights, or ours being kept on
+
+        return OCCUPANCY_ACTION_NONE;
+    }
+    isOwner = true;
+
+    return OCCUPANCY_ACTION_ON;
+}
+
+/**
+ * Notes the room becoming empty, starting the count down.
+ */
+void Occupancy::vacant() {
+    isOccupied = false;
+    vacantSince = millis();
+}
+
+/**
+ * Gives up the lights, as something else switched them.
+ */
+void Occupancy::release() {
+    isOwner = false;
+}
+
+/**
+ * Counts down once the room is empty. Should be called every time through
+ * the main loop.
+ * 
+ * @return Returns the OCCUPANCY_ACTION_ to take as uint8_t.
+ */
+uint8_t Occupancy::handle() {
+    if (!isTiming() || millis() - vacantSince < timeoutMs) {
+
+        return OCCUPANCY_ACTION_NONE;
+    }
+    isOwner = false;
+
+    return OCCUPANCY_ACTION_OFF;
+}
+
+bool Occupancy::isRoomOccupied() {
+
+    return isOccupied;
+}
+
+/**
+ * Determines if the lights are counting down to going off.
+ * 
+ * @return Returns true if counting down otherwise false as bool.
+ */
+bool Occupancy::isTiming() {
+
+    return isOwner && !isOccupied;
+}
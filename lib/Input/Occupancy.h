@@ -0,0 +1,49 @@
+#ifndef Occupancy_h
+    #define Occupancy_h
+
+    #include <Arduino.h>
+
+    #define OCCUPANCY_ACTION_NONE 0
+    #define OCCUPANCY_ACTION_ON 1
+    #define OCCUPANCY_ACTION_OFF 2
+
+    /**
+     * The Occupancy class decides when a motion or occupancy sensor should
+     * switch the lights. They are switched on as the room becomes occupied
+     * and off once it has been empty for the timeout, counted down from
+     * the main loop.
+     * 
+     * It only ever switches off lights it switched on itself. Anything else
+     * switching the lights, the button, the timer or a command, is to call
+     * release(), after which the lights are theirs and left alone. Turning
+     * the lights off by hand in an occupied room therefore sticks until
+     * the room has emptied and someone comes in again. In the same way the
+     * timer switching off beats the sensor, which the timer switching on
+     * also does as its lights are never timed out.
+     * 
+     * Only edges act, the sensor being occupied when the lights go off by
+     * other means doesn't bring them back.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class Occupancy {
+        private:
+            unsigned long  timeoutMs        ;
+            bool           isOccupied       ;
+            bool           isOwner          ; // lights on because of the sensor
+            unsigned long  vacantSince      ;
+
+        public:
+            Occupancy();
+
+            void setTimeout(unsigned long timeoutMs);
+            uint8_t occupied(bool isLightsOn);
+            void vacant();
+            void release();
+            uint8_t handle();
+            bool isRoomOccupied();
+            bool isTiming();
+    };
+
+#endif
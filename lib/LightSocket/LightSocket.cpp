@@ -0,0 +1,141 @@
+/*
+    LightSocket - A class that serves a WebSocket control channel for
+    switching and dimming the lights.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "LightSocket.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+LightSocket::LightSocket() : server(LIGHT_SOCKET_PORT) {
+    hasPower = false;
+    power = false;
+    hasLevel = false;
+    level = 0;
+    memset(state, 0, sizeof(state));
+    state[0] = LIGHT_SOCKET_STATE;
+    isPushPending = false;
+    lastPushAt = 0;
+}
+
+/**
+ * Starts serving WebSocket connections.
+ */
+void LightSocket::begin() {
+    server.onEvent([this](uint8_t num, WStype_t type, uint8_t *payload, size_t length) {
+        onEvent(num, type, payload, length);
+    });
+    server.begin();
+}
+
+/**
+ * Serves the connected clients and pushes the state if it has changed.
+ * Should be called every time through the main loop.
+ */
+void LightSocket::handle() {
+    server.loop();
+    if (isPushPending && millis() - lastPushAt >= LIGHT_SOCKET_PUSH_MS) {
+        server.broadcastBIN(state, sizeof(state));
+        isPushPending = false;
+        lastPushAt = millis();
+    }
+}
+
+/**
+ * Sets the state pushed to clients. Nothing is pushed unless it differs
+ * from the last state.
+ * 
+ * @param lightsOn Indicates the lights are on as bool.
+ * @param brightness The brightness in percent as uint8_t.
+ * @param timerOn Indicates the timer is on as bool.
+ */
+void LightSocket::setState(bool lightsOn, uint8_t brightness, bool timerOn) {
+    uint8_t newState[LIGHT_SOCKET_STATE_SIZE] = { LIGHT_SOCKET_STATE, lightsOn, brightness, timerOn };
+    if (memcmp(state, newState, sizeof(state)) != 0) {
+        memcpy(state, newState, sizeof(state));
+        isPushPending = true;
+    }
+}
+
+/**
+ * Takes the latest power command received, if any.
+ * 
+ * @param on Set to true if the lights should be on as bool&.
+ * 
+ * @return Returns true if there was a command to take otherwise false as bool.
+ */
+bool LightSocket::takePower(bool &on) {
+    if (!hasPower) {
+
+        return false;
+    }
+    on = power;
+    hasPower = false;
+
+    return true;
+}
+
+/**
+ * Takes the latest level command received, if any. Earlier ones that were
+ * never taken are lost.
+ * 
+ * @param percent Set to the brightness asked for as uint8_t&.
+ * 
+ * @return Returns true if there was a command to take otherwise false as bool.
+ */
+bool LightSocket::takeLevel(uint8_t &percent) {
+    if (!hasLevel) {
+
+        return false;
+    }
+    percent = level;
+    hasLevel = false;
+
+    return true;
+}
+
+uint8_t LightSocket::getClientCount() {
+
+    return server.connectedClients();
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Called by the WebSockets library for each event on a connection. New
+ * clients are sent the state straight away, commands are kept until taken.
+ * 
+ * @param num The client the event is for as uint8_t.
+ * @param type The type of event as WStype_t.
+ * @param payload The frame received as uint8_t*.
+ * @param length The length of the frame as size_t.
+ */
+void LightSocket::onEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length) {
+    switch (type) {
+        case WStype_CONNECTED:
+            server.sendBIN(num, state, sizeof(state));
+            break;
+        case WStype_BIN:
+            if (length != 2) {
+                break;
+            }
+            if (payload[0] == LIGHT_SOCKET_CMD_POWER) {
+                power = payload[1] != 0;
+                hasPower = true;
+            } else if (payload[0] == LIGHT_SOCKET_CMD_LEVEL && payload[1] >= 1 && payload[1] <= 100) {
+                level = payload[1];
+                hasLevel = true;
+            }
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef LightSocket_h
+    #define LightSocket_h
+
+    #include <Arduino.h>
+    #include <WebSocketsServer.h>
+
+    #define LIGHT_SOCKET_PORT 81
+    #define LIGHT_SOCKET_PUSH_MS 50UL // <-- State pushes are at most this often
+    #define LIGHT_SOCKET_STATE_SIZE 4
+
+    #define LIGHT_SOCKET_CMD_POWER 0x01
+    #define LIGHT_SOCKET_CMD_LEVEL 0x02
+    #define LIGHT_SOCKET_STATE 0x80
+
+    /**
+     * The LightSocket class is a WebSocket control channel for the lights,
+     * letting a brightness slider be dragged without an HTTP request per
+     * step. Frames are binary and tiny.
+     * 
+     * Commands from a client are 2 bytes:
+     *   0x01 power, then 0 for off or 1 for on
+     *   0x02 level, then brightness in percent (1 to 100)
+     * 
+     * The state is pushed to every client as 4 bytes:
+     *   0x80, lights on (0 or 1), brightness in percent, timer on (0 or 1)
+     * 
+     * A level command only replaces the level waiting to be taken, so a
+     * slider sending faster than the device applies changes only ever has
+     * its latest position acted on. Pushes are likewise held back to one
+     * every LIGHT_SOCKET_PUSH_MS, carrying the latest state. 
+     * 
+     * The number of sessions is capped by the WebSockets library at build
+     * time (WEBSOCKETS_SERVER_CLIENT_MAX in platformio.ini), each one having
+     * its slot set aside up front.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class LightSocket {
+        private:
+            WebSocketsServer   server                                  ;
+            bool               hasPower                                ;
+            bool               power                                   ;
+            bool               hasLevel                                ;
+            uint8_t            level                                   ;
+            uint8_t            state        [LIGHT_SOCKET_STATE_SIZE]  ;
+            bool               isPushPending                           ;
+            unsigned long      lastPushAt                              ;
+
+            void onEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length);
+
+        public:
+            LightSocket();
+
+            void begin();
+            void handle();
+            void setState(bool lightsOn, uint8_t brightness, bool timerOn);
+            bool takePower(bool &on);
+            bool takeLevel(uint8_t &percent);
+            uint8_t getClientCount();
+    };
+
+#endif
@@ -0,0 +1,482 @@
+/*
+    MqttLink - A class that connects the device to an MQTT broker for Home
+    Assistant, with discovery and diff-only state publishing.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "MqttLink.h"
+
+/*
+    Discovery config templates, each filled in with the device ID, base
+    topic, device ID twice more and the firmware version, in that order.
+*/
+static const char PROGMEM LIGHT_TOPIC[] = "homeassistant/light/lumen_%s/light/config";
+static const char PROGMEM LIGHT_CONFIG[] = {
+    "{\"name\":\"Lights\",\"uniq_id\":\"lumen_%s_light\",\"~\":\"%s\","
+    "\"schema\":\"json\",\"sup_clrm\":[\"brightness\"],\"bri_scl\":100,"
+    "\"stat_t\":\"~/state\",\"cmd_t\":\"~/light/set\",\"avty_t\":\"~/availability\","
+    "\"dev\":{\"ids\":[\"lumen_%s\"],\"name\":\"Lumen %s\",\"mf\":\"Scott Griffis\",\"mdl\":\"Lumen Lighting Controller\",\"sw\":\"%s\"}}"
+};
+static const char PROGMEM TIMER_TOPIC[] = "homeassistant/switch/lumen_%s/timer/config";
+static const char PROGMEM TIMER_CONFIG[] = {
+    "{\"name\":\"Timer\",\"uniq_id\":\"lumen_%s_timer\",\"~\":\"%s\","
+    "\"stat_t\":\"~/state\",\"val_tpl\":\"{{value_json.timer}}\",\"cmd_t\":\"~/timer/set\",\"avty_t\":\"~/availability\","
+    "\"ic\":\"mdi:timer-outline\","
+    "\"dev\":{\"ids\":[\"lumen_%s\"],\"name\":\"Lumen %s\",\"mf\":\"Scott Griffis\",\"mdl\":\"Lumen Lighting Controller\",\"sw\":\"%s\"}}"
+};
+
+static const struct {
+    PGM_P topic;
+    PGM_P config;
+} DISCOVERY[] = {
+    { LIGHT_TOPIC, LIGHT_CONFIG },
+    { TIMER_TOPIC, TIMER_CONFIG }
+};
+
+#define DISCOVERY_COUNT (sizeof(DISCOVERY) / sizeof(DISCOVERY[0]))
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+MqttLink::MqttLink() : client(net) {
+    host[0] = '\0';
+    port = 1883;
+    user[0] = '\0';
+    pwd[0] = '\0';
+    deviceId[0] = '\0';
+    base[0] = '\0';
+    version = "";
+    message[0] = '\0';
+    state[0] = '\0';
+    published[0] = '\0';
+    isSessionUp = false;
+    isSettled = false;
+    discoveryNext = 0;
+    connectedAt = 0;
+    changedAt = 0;
+    pendingSince = 0;
+    lastAttemptAt = 0;
+    retryDelay = MQTT_RETRY_MIN;
+    retryWait = 0;
+    hasPower = false;
+    power = false;
+    hasLevel = false;
+    level = 0;
+    hasTimer = false;
+    timer = false;
+    publishCount = 0;
+    suppressedCount = 0;
+}
+
+/**
+ * Prepares the link, nothing is connected until a broker is set.
+ *
+ * @param deviceId The ID of this device as String&.
+ * @param version The firmware version as const char*.
+ */
+void MqttLink::begin(const String &deviceId, const char *version) {
+    strlcpy(this->deviceId, deviceId.c_str(), sizeof(this->deviceId));
+    snprintf_P(base, sizeof(base), PSTR("lumen/%s"), this->deviceId);
+    this->version = version;
+
+    net.setTimeout(MQTT_CONNECT_TIMEOUT);
+    client.setCallback([this](char *topic, uint8_t *payload, unsigned int length) {
+        onMessage(topic, payload, length);
+    });
+}
+
+/**
+ * Sets the broker to connect to, an empty host turning MQTT off. Any
+ * current connection is dropped so the next one uses the new broker.
+ *
+ * @param host The name or IP of the broker as String&.
+ * @param port The port of the broker as int.
+ * @param user The user to connect as, empty for none as String&.
+ * @param pwd The password to connect with as String&.
+ */
+void MqttLink::setBroker(const String &host, int port, const String &user, const String &pwd) {
+    if (
+        host.equals(this->host) && port == this->port
+        && user.equals(this->user) && pwd.equals(this->pwd)
+    ) {
+        // Nothing changed
+
+        return;
+    }
+    strlcpy(this->host, host.c_str(), sizeof(this->host));
+    this->port = port;
+    strlcpy(this->user, user.c_str(), sizeof(this->user));
+    strlcpy(this->pwd, pwd.c_str(), sizeof(this->pwd));
+
+    if (client.connected()) {
+        client.disconnect();
+    }
+    client.setServer(this->host, this->port);
+    retryDelay = MQTT_RETRY_MIN;
+    retryWait = 0;
+}
+
+/**
+ * Keeps the connection to the broker up and does the publishing that is
+ * due. Should be called every time through the main loop.
+ *
+ * @param isNetworkUp Indicates the network the broker is on is up as bool.
+ */
+void MqttLink::handle(bool isNetworkUp) {
+    if (host[0] == '\0' || !isNetworkUp) {
+        if (client.connected()) {
+            client.disconnect();
+        }
+        isSessionUp = false;
+
+        return;
+    }
+
+    /* Connect If Not Connected */
+    if (!client.connected()) {
+        if (isSessionUp) {
+            // Lost the broker, spread out the reconnects of a fleet
+            Serial.println(F("MQTT connection lost."));
+            isSessionUp = false;
+            retryDelay = MQTT_RETRY_MIN;
+            retryWait = random(MQTT_RETRY_MIN);
+            lastAttemptAt = millis();
+        }
+        if (millis() - lastAttemptAt >= retryWait) {
+            connect();
+        }
+
+        return;
+    }
+    client.loop();
+
+    /* Announce To Home Assistant */
+    if (discoveryNext < DISCOVERY_COUNT) {
+        publishDiscovery(discoveryNext++);
+
+        return;
+    }
+
+    /* Learn What State The Broker Holds */
+    if (!isSettled) {
+        if (millis() - connectedAt < MQTT_SETTLE_MS) {
+
+            return;
+        }
+        char topic[MQTT_TOPIC_SIZE];
+        makeTopic(topic, "state");
+        client.unsubscribe(topic);
+        isSettled = true;
+        if (strcmp(state, published) == 0) {
+            suppressedCount++;
+        }
+    }
+
+    /* Publish State Once It Settles */
+    if (
+        strcmp(state, published) != 0
+        && (millis() - changedAt >= MQTT_COALESCE_MS || millis() - pendingSince >= MQTT_COALESCE_MAX_MS)
+    ) {
+        char topic[MQTT_TOPIC_SIZE];
+        makeTopic(topic, "state");
+        if (publish(topic, state, strlen(state))) {
+            strcpy(published, state);
+        }
+    }
+}
+
+/**
+ * Sets the state published to the broker. Nothing is published unless it
+ * differs from what the broker holds.
+ *
+ * @param lightsOn Indicates the lights are on as bool.
+ * @param brightness The brightness in percent as uint8_t.
+ * @param timerOn Indicates the timer is on as bool.
+ */
+void MqttLink::setState(bool lightsOn, uint8_t brightness, bool timerOn) {
+    char newState[MQTT_STATE_SIZE];
+    snprintf_P(
+        newState,
+        sizeof(newState),
+        PSTR("{\"state\":\"%s\",\"brightness\":%d,\"timer\":\"%s\"}"),
+        lightsOn ? "ON" : "OFF",
+        brightness,
+        timerOn ? "ON" : "OFF"
+    );
+    if (strcmp(state, newState) != 0) {
+        if (strcmp(state, published) == 0) {
+            // First change since the last publish
+            pendingSince = millis();
+        }
+        strcpy(state, newState);
+        changedAt = millis();
+    }
+}
+
+/**
+ * Takes the latest power command received, if any.
+ *
+ * @param on Set to true if the lights should be on as bool&.
+ *
+ * @return Returns true if there was a command to take otherwise false as bool.
+ */
+bool MqttLink::takePower(bool &on) {
+    if (!hasPower) {
+
+        return false;
+    }
+    on = power;
+    hasPower = false;
+
+    return true;
+}
+
+/**
+ * Takes the latest brightness command received, if any.
+ *
+ * @param percent Set to the brightness asked for as uint8_t&.
+ *
+ * @return Returns true if there was a command to take otherwise false as bool.
+ */
+bool MqttLink::takeLevel(uint8_t &percent) {
+    if (!hasLevel) {
+
+        return false;
+    }
+    percent = level;
+    hasLevel = false;
+
+    return true;
+}
+
+/**
+ * Takes the latest timer command received, if any.
+ *
+ * @param on Set to true if the timer should be enabled as bool&.
+ *
+ * @return Returns true if there was a command to take otherwise false as bool.
+ */
+bool MqttLink::takeTimer(bool &on) {
+    if (!hasTimer) {
+
+        return false;
+    }
+    on = timer;
+    hasTimer = false;
+
+    return true;
+}
+
+bool MqttLink::isConnected() {
+
+    return client.connected();
+}
+
+uint32_t MqttLink::getPublishCount() {
+
+    return publishCount;
+}
+
+uint32_t MqttLink::getSuppressedCount() {
+
+    return suppressedCount;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Makes one attempt at connecting to the broker. Once connected the
+ * device is marked available, its command topics are subscribed to and
+ * so is its state topic, for the broker to hand back the retained state.
+ */
+void MqttLink::connect() {
+    char clientId[MQTT_CRED_SIZE + 6];
+    char topic[MQTT_TOPIC_SIZE];
+    snprintf_P(clientId, sizeof(clientId), PSTR("lumen-%s"), deviceId);
+    makeTopic(topic, "availability");
+
+    lastAttemptAt = millis();
+    bool ok = client.connect(
+        clientId,
+        user[0] == '\0' ? nullptr : user,
+        user[0] == '\0' ? nullptr : pwd,
+        topic,
+        0,
+        true,
+        "offline"
+    );
+    if (!ok) {
+        Serial.printf("MQTT connect failed, state %d\n", client.state());
+        retryWait = retryDelay + random(retryDelay / 2);
+        retryDelay = min(retryDelay * 2, MQTT_RETRY_MAX);
+
+        return;
+    }
+
+    Serial.println(F("MQTT connected."));
+    isSessionUp = true;
+    isSettled = false;
+    discoveryNext = 0;
+    published[0] = '\0';
+    connectedAt = millis();
+    retryDelay = MQTT_RETRY_MIN;
+
+    client.publish(topic, "online", true);
+    makeTopic(topic, "light/set");
+    client.subscribe(topic);
+    makeTopic(topic, "timer/set");
+    client.subscribe(topic);
+    makeTopic(topic, "state");
+    client.subscribe(topic);
+}
+
+/**
+ * Publishes the given payload, retained. The payload is streamed out so
+ * it needs no room in the client's buffer.
+ *
+ * @param topic The topic to publish to as char*.
+ * @param payload The payload to publish as char*.
+ * @param length The length of the payload as size_t.
+ *
+ * @return Returns true if published otherwise false as bool.
+ */
+bool MqttLink::publish(const char *topic, const char *payload, size_t length) {
+    bool ok = client.beginPublish(topic, length, true);
+    ok = ok && client.write((const uint8_t *)payload, length) == length;
+    ok = ok && client.endPublish() == 1;
+    if (ok) {
+        publishCount++;
+    }
+
+    return ok;
+}
+
+/**
+ * Builds a discovery config from its template and publishes it, retained,
+ * for Home Assistant.
+ *
+ * @param index The index of the discovery config as uint8_t.
+ */
+void MqttLink::publishDiscovery(uint8_t index) {
+    char topic[MQTT_TOPIC_SIZE];
+    snprintf_P(topic, sizeof(topic), DISCOVERY[index].topic, deviceId);
+    int length = snprintf_P(message, sizeof(message), DISCOVERY[index].config, deviceId, base, deviceId, deviceId, version);
+    if (length < 0 || (size_t)length >= sizeof(message)) {
+        Serial.println(F("MQTT discovery config too big!"));
+
+        return;
+    }
+    publish(topic, message, length);
+}
+
+/**
+ * Called by the MQTT client for each message received. Commands are kept
+ * until taken and the retained state is noted as what the broker holds.
+ *
+ * @param topic The topic of the message as char*.
+ * @param payload The payload of the message as uint8_t*.
+ * @param length The length of the payload as unsigned int.
+ */
+void MqttLink::onMessage(char *topic, uint8_t *payload, unsigned int length) {
+    size_t baseLength = strlen(base);
+    if (strncmp(topic, base, baseLength) != 0 || topic[baseLength] != '/') {
+
+        return;
+    }
+    const char *suffix = topic + baseLength + 1;
+
+    if (strcmp_P(suffix, PSTR("state")) == 0) {
+        if (!isSettled && length < sizeof(published)) {
+            memcpy(published, payload, length);
+            published[length] = '\0';
+        }
+
+        return;
+    }
+
+    char command[MQTT_COMMAND_SIZE];
+    if (length >= sizeof(command)) {
+
+        return;
+    }
+    memcpy(command, payload, length);
+    command[length] = '\0';
+
+    if (strcmp_P(suffix, PSTR("light/set")) == 0) {
+        onLightCommand(command);
+    } else if (strcmp_P(suffix, PSTR("timer/set")) == 0) {
+        if (strcmp_P(command, PSTR("ON")) == 0 || strcmp_P(command, PSTR("OFF")) == 0) {
+            timer = command[1] == 'N';
+            hasTimer = true;
+        }
+    }
+}
+
+/**
+ * Acts on a JSON light command, such as {"state":"ON","brightness":50}.
+ * A plain "ON" or "OFF" is taken as well.
+ *
+ * @param command The command as char*.
+ */
+void MqttLink::onLightCommand(const char *command) {
+    const char *value = findValue(command, PSTR("\"state\""));
+    if (value == nullptr && (strcmp_P(command, PSTR("ON")) == 0 || strcmp_P(command, PSTR("OFF")) == 0)) {
+        value = command;
+    }
+    if (value != nullptr && strncmp_P(value, PSTR("ON"), 2) == 0) {
+        power = true;
+        hasPower = true;
+    } else if (value != nullptr && strncmp_P(value, PSTR("OFF"), 3) == 0) {
+        power = false;
+        hasPower = true;
+    }
+
+    value = findValue(command, PSTR("\"brightness\""));
+    if (value != nullptr) {
+        int percent = atoi(value);
+        if (percent >= 1 && percent <= 100) {
+            level = percent;
+            hasLevel = true;
+        }
+    }
+}
+
+/**
+ * Finds the value of a key in flat JSON, skipping past the colon, spaces
+ * and any opening quote.
+ *
+ * @param json The JSON to look in as char*.
+ * @param key The key, quotes included, as PGM_P.
+ *
+ * @return Returns where the value starts or nullptr if the key is not
+ * there as const char*.
+ */
+const char *MqttLink::findValue(const char *json, PGM_P key) {
+    const char *at = strstr_P(json, key);
+    if (at == nullptr) {
+
+        return nullptr;
+    }
+    at += strlen_P(key);
+    while (*at == ' ' || *at == ':' || *at == '"') {
+        at++;
+    }
+
+    return at;
+}
+
+/**
+ * Makes a topic under the base topic.
+ *
+ * @param topic Where to make the topic, MQTT_TOPIC_SIZE long as char*.
+ * @param suffix The topic under the base topic as char*.
+ */
+void MqttLink::makeTopic(char *topic, const char *suffix) {
+    snprintf_P(topic, MQTT_TOPIC_SIZE, PSTR("%s/%s"), base, suffix);
+}
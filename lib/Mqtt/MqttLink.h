@@ -0,0 +1,107 @@
+#ifndef MqttLink_h
+    #define MqttLink_h
+
+    #include <Arduino.h>
+    #include <ESP8266WiFi.h>
+    #include <PubSubClient.h>
+
+    #define MQTT_HOST_SIZE 64
+    #define MQTT_CRED_SIZE 33
+    #define MQTT_BASE_SIZE (MQTT_CRED_SIZE + 6)
+    #define MQTT_TOPIC_SIZE 80
+    #define MQTT_MESSAGE_SIZE 512
+    #define MQTT_STATE_SIZE 48
+    #define MQTT_COMMAND_SIZE 64
+
+    #define MQTT_CONNECT_TIMEOUT 1500UL // <-- Longest the loop is held up connecting (ms)
+    #define MQTT_RETRY_MIN 2000UL // <-------- Wait before retrying a failed connect, doubled each failure (ms)
+    #define MQTT_RETRY_MAX 60000UL // <------- Wait before retrying is never doubled past (ms)
+    #define MQTT_SETTLE_MS 500UL // <--------- Time the broker has to hand back retained state on connect (ms)
+    #define MQTT_COALESCE_MS 250UL // <------- State published once it has stopped changing for (ms)
+    #define MQTT_COALESCE_MAX_MS 1000UL // <-- State published this long after a change even if still changing (ms)
+
+    /**
+     * The MqttLink class connects the device to an MQTT broker for Home
+     * Assistant, announcing itself through MQTT discovery as a dimmable
+     * light and a timer switch.
+     *
+     * Topics are under lumen/<device id>:
+     *   availability   "online", or "offline" as the broker's last will
+     *   state          {"state":"ON","brightness":80,"timer":"OFF"}
+     *   light/set      JSON light commands, {"state":"ON","brightness":50}
+     *   timer/set      "ON" or "OFF"
+     *
+     * Discovery configs are built from PROGMEM templates and published,
+     * retained, once per broker session, one per call to handle() so no
+     * single pass through the loop carries them all.
+     *
+     * The state is only published when it differs from what the broker
+     * holds. On connect the retained state is read back from the broker
+     * first, so a reconnect with nothing changed publishes nothing. Changes
+     * are coalesced, the state going out once it has stopped changing for
+     * MQTT_COALESCE_MS, so dragging a slider doesn't publish every step.
+     *
+     * Connecting blocks for at most MQTT_CONNECT_TIMEOUT, plus any DNS
+     * lookup of the broker's name. Failed connects are retried with a
+     * doubling, randomized wait so a fleet of units losing the broker at
+     * once don't all come back at the same moment.
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class MqttLink {
+        private:
+            WiFiClient         net                                 ;
+            PubSubClient       client                              ;
+            char               host         [MQTT_HOST_SIZE]       ;
+            uint16_t           port                                ;
+            char               user         [MQTT_CRED_SIZE]       ;
+            char               pwd          [MQTT_CRED_SIZE]       ;
+            char               deviceId     [MQTT_CRED_SIZE]       ;
+            char               base         [MQTT_BASE_SIZE]       ;
+            const char        *version                             ;
+            char               message      [MQTT_MESSAGE_SIZE]    ;
+            char               state        [MQTT_STATE_SIZE]      ;
+            char               published    [MQTT_STATE_SIZE]      ;
+            bool               isSessionUp                         ;
+            bool               isSettled                           ;
+            uint8_t            discoveryNext                       ;
+            unsigned long      connectedAt                         ;
+            unsigned long      changedAt                           ;
+            unsigned long      pendingSince                        ;
+            unsigned long      lastAttemptAt                       ;
+            unsigned long      retryDelay                          ;
+            unsigned long      retryWait                           ;
+            bool               hasPower                            ;
+            bool               power                               ;
+            bool               hasLevel                            ;
+            uint8_t            level                               ;
+            bool               hasTimer                            ;
+            bool               timer                               ;
+            uint32_t           publishCount                        ;
+            uint32_t           suppressedCount                     ;
+
+            void connect();
+            bool publish(const char *topic, const char *payload, size_t length);
+            void publishDiscovery(uint8_t index);
+            void onMessage(char *topic, uint8_t *payload, unsigned int length);
+            void onLightCommand(const char *command);
+            const char *findValue(const char *json, PGM_P key);
+            void makeTopic(char *topic, const char *suffix);
+
+        public:
+            MqttLink();
+
+            void begin(const String &deviceId, const char *version);
+            void setBroker(const String &host, int port, const String &user, const String &pwd);
+            void handle(bool isNetworkUp);
+            void setState(bool lightsOn, uint8_t brightness, bool timerOn);
+            bool takePower(bool &on);
+            bool takeLevel(uint8_t &percent);
+            bool takeTimer(bool &on);
+            bool isConnected();
+            uint32_t getPublishCount();
+            uint32_t getSuppressedCount();
+    };
+
+#endif
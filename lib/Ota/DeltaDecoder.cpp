@@ -0,0 +1,292 @@
+/*
+    DeltaDecoder - A class that rebuilds a firmware image in a streaming 
+    fashion from a binary delta against the currently running image.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "DeltaDecoder.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ * 
+ * @param backend The FlashBackend used to read the running image.
+ */
+DeltaDecoder::DeltaDecoder(FlashBackend &backend) : backend(backend) {
+    begin(nullptr);
+}
+
+/**
+ * Used to determine if the given start of an image is a delta.
+ * 
+ * @param data The first bytes of the image as const uint8_t pointer.
+ * @param len The number of bytes given as size_t.
+ * 
+ * @return Returns true if a delta otherwise false as bool.
+ */
+bool DeltaDecoder::isDelta(const uint8_t *data, size_t len) {
+
+    return len >= 4 && memcmp(data, DELTA_MAGIC, 4) == 0;
+}
+
+/**
+ * Prepares to decode a new delta.
+ * 
+ * @param output The function the rebuilt image is passed to as OutputFunction.
+ */
+void DeltaDecoder::begin(OutputFunction output) {
+    this->output = output;
+    state = STATE_HEADER;
+    headerFill = 0;
+    argsFill = 0;
+    argsNeeded = 0;
+    addRemaining = 0;
+    baseSize = 0;
+    targetSize = 0;
+    outputSize = 0;
+    error = "";
+    md5.begin();
+}
+
+/**
+ * Feeds the next piece of the delta to the decoder.
+ * 
+ * @param data The delta bytes as const uint8_t pointer.
+ * @param len The number of bytes as size_t.
+ * 
+ * @return Returns true if all is well otherwise false as bool.
+ */
+bool DeltaDecoder::feed(const uint8_t *data, size_t len) {
+    while (len > 0) {
+        switch (state) {
+            case STATE_HEADER: {
+                size_t count = min(len, (size_t)(DELTA_HEADER_SIZE - headerFill));
+                memcpy(header + headerFill, data, count);
+                headerFill += count;
+                data += count;
+                len -= count;
+                if (headerFill == DELTA_HEADER_SIZE) {
+                    if (!checkHeader()) {
+
+                        return false;
+                    }
+                    state = STATE_OP;
+                }
+                break;
+            }
+            case STATE_OP:
+                op = *data++;
+                len--;
+                argsFill = 0;
+                if (op == DELTA_OP_END) {
+                    state = STATE_DONE;
+                } else if (op == DELTA_OP_COPY) {
+                    argsNeeded = 8;
+                    state = STATE_ARGS;
+                } else if (op == DELTA_OP_ADD) {
+                    argsNeeded = 4;
+                    state = STATE_ARGS;
+                } else {
+
+                    return fail(F("Delta contains an unknown operation!"));
+                }
+                break;
+            case STATE_ARGS: {
+                size_t count = min(len, argsNeeded - argsFill);
+                memcpy(args + argsFill, data, count);
+                argsFill += count;
+                data += count;
+                len -= count;
+                if (argsFill == argsNeeded && !runOp()) {
+
+                    return false;
+                }
+                break;
+            }
+            case STATE_ADD_DATA: {
+                size_t count = min(len, (size_t)addRemaining);
+                if (!emit(data, count)) {
+
+                    return false;
+                }
+                addRemaining -= count;
+                data += count;
+                len -= count;
+                if (addRemaining == 0) {
+                    state = STATE_OP;
+                }
+                break;
+            }
+            case STATE_DONE:
+
+                return fail(F("Delta has data past its end!"));
+            case STATE_ERROR:
+
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Called once the whole delta has been fed to check that the 
+ * rebuilt image is complete and exactly what it should be.
+ * 
+ * @return Returns true if the image is good otherwise false as bool.
+ */
+bool DeltaDecoder::finish() {
+    if (state == STATE_ERROR) {
+
+        return false;
+    }
+    if (state != STATE_DONE) {
+
+        return fail(F("Delta ended early!"));
+    }
+    if (outputSize != targetSize) {
+
+        return fail(F("Rebuilt image has the wrong size!"));
+    }
+
+    uint8_t digest[16];
+    md5.calculate();
+    md5.getBytes(digest);
+    if (memcmp(digest, header + 32, 16) != 0) {
+
+        return fail(F("MD5 of the rebuilt image does not match!"));
+    }
+
+    return true;
+}
+
+String DeltaDecoder::getError() {
+
+    return error;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Validates the header and makes sure the delta was made against
+ * the image that is currently running.
+ * 
+ * @return Returns true if valid otherwise false as bool.
+ */
+bool DeltaDecoder::checkHeader() {
+    if (!isDelta(header, DELTA_HEADER_SIZE) || header[4] != DELTA_VERSION) {
+
+        return fail(F("Unsupported delta format!"));
+    }
+    baseSize = readUint32(header + 8);
+    targetSize = readUint32(header + 12);
+
+    String baseMd5 = "";
+    for (int i = 16; i < 32; i++) {
+        if (header[i] < 0x10) {
+            baseMd5.concat('0');
+        }
+        baseMd5.concat(String(header[i], HEX));
+    }
+    if (baseSize != backend.getCurrentSize() || !baseMd5.equalsIgnoreCase(backend.getCurrentMd5())) {
+
+        return fail(F("Delta was not made against the running firmware!"));
+    }
+
+    return true;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Runs the operation whose arguments have just been read.
+ * 
+ * @return Returns true if all is well otherwise false as bool.
+ */
+bool DeltaDecoder::runOp() {
+    if (op == DELTA_OP_ADD) {
+        addRemaining = readUint32(args);
+        state = addRemaining == 0 ? STATE_OP : STATE_ADD_DATA;
+
+        return true;
+    }
+
+    // Copy a run of the base image thru the window
+    uint32_t offset = readUint32(args);
+    uint32_t remaining = readUint32(args + 4);
+    if (offset > baseSize || remaining > baseSize - offset) {
+
+        return fail(F("Delta copies from outside the running firmware!"));
+    }
+    while (remaining > 0) {
+        size_t count = min((size_t)remaining, (size_t)DELTA_WINDOW_SIZE);
+        if (!backend.readCurrent(offset, window, count)) {
+
+            return fail(F("Unable to read the running firmware!"));
+        }
+        if (!emit(window, count)) {
+
+            return false;
+        }
+        offset += count;
+        remaining -= count;
+    }
+    state = STATE_OP;
+
+    return true;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Passes rebuilt image bytes on to the output.
+ * 
+ * @return Returns true if all is well otherwise false as bool.
+ */
+bool DeltaDecoder::emit(const uint8_t *data, size_t len) {
+    if (len > targetSize - outputSize) {
+
+        return fail(F("Rebuilt image is larger than expected!"));
+    }
+    md5.add(data, len);
+    outputSize += len;
+    if (!output(data, len)) {
+        // Output records its own error
+        state = STATE_ERROR;
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Records the given error.
+ * 
+ * @return Always returns false as bool.
+ */
+bool DeltaDecoder::fail(const __FlashStringHelper *message) {
+    error = message;
+    state = STATE_ERROR;
+
+    return false;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Reads a little endian uint32 from the given bytes.
+ */
+uint32_t DeltaDecoder::readUint32(const uint8_t *data) {
+
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
@@ -0,0 +1,90 @@
+#ifndef DeltaDecoder_h
+    #define DeltaDecoder_h
+
+    #include <functional>
+    #include <Arduino.h>
+    #include <MD5Builder.h>
+
+    #include "FlashBackend.h"
+
+    #define DELTA_MAGIC "LDLT"
+    #define DELTA_VERSION 1
+    #define DELTA_HEADER_SIZE 48
+    #define DELTA_WINDOW_SIZE 256
+
+    #define DELTA_OP_END 0x00
+    #define DELTA_OP_COPY 0x01
+    #define DELTA_OP_ADD 0x02
+
+    /**
+     * The DeltaDecoder class rebuilds a firmware image from a binary delta
+     * against the image that is currently running. It is fed the delta in 
+     * whatever sized pieces arrive and produces the new image as it goes,
+     * so nothing but a small fixed window is ever held in memory.
+     * 
+     * A delta starts with a 48 byte header (all values little endian):
+     *   0  "LDLT" magic
+     *   4  version (1) followed by 3 reserved bytes
+     *   8  size of the base image as uint32
+     *   12 size of the target image as uint32
+     *   16 MD5 of the base image as 16 raw bytes
+     *   32 MD5 of the target image as 16 raw bytes
+     * 
+     * It is followed by a list of operations, each starting with one byte:
+     *   0x01 COPY, uint32 offset, uint32 length: copy a run of the base image
+     *   0x02 ADD, uint32 length, then length bytes: literal new bytes
+     *   0x00 END: the image is complete
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class DeltaDecoder {
+        public:
+            typedef std::function<bool(const uint8_t *data, size_t len)> OutputFunction;
+
+        private:
+            enum DecoderState {
+                STATE_HEADER,
+                STATE_OP,
+                STATE_ARGS,
+                STATE_ADD_DATA,
+                STATE_DONE,
+                STATE_ERROR
+            };
+
+            FlashBackend    &backend                               ;
+            OutputFunction  output                                 ;
+            DecoderState    state                                  ;
+            uint8_t         header          [DELTA_HEADER_SIZE]    ;
+            size_t          headerFill                             ;
+            uint8_t         op                                     ;
+            uint8_t         args            [8]                    ;
+            size_t          argsFill                               ;
+            size_t          argsNeeded                             ;
+            uint32_t        addRemaining                           ;
+            uint32_t        baseSize                               ;
+            uint32_t        targetSize                             ;
+            uint32_t        outputSize                             ;
+            uint8_t         window          [DELTA_WINDOW_SIZE]    ;
+            MD5Builder      md5                                    ;
+            String          error                                  ;
+
+            bool checkHeader();
+            bool runOp();
+            bool emit(const uint8_t *data, size_t len);
+            bool fail(const __FlashStringHelper *message);
+            static uint32_t readUint32(const uint8_t *data);
+
+        public:
+            DeltaDecoder(FlashBackend &backend);
+
+            static bool isDelta(const uint8_t *data, size_t len);
+
+            void begin(OutputFunction output);
+            bool feed(const uint8_t *data, size_t len);
+            bool finish();
+
+            String         getError           ()    ;
+    };
+
+#endif
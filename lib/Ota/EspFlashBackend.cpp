@@ -0,0 +1,53 @@
+/*
+    EspFlashBackend - The FlashBackend implementation that writes firmware
+    images into the OTA partition of the ESP8266's flash.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "EspFlashBackend.h"
+
+bool EspFlashBackend::begin(size_t maxSize) {
+    if (Update.isRunning()) {
+        // Left over from a prior failed attempt
+        abort();
+    }
+
+    return Update.begin(maxSize, U_FLASH);
+}
+
+bool EspFlashBackend::write(const uint8_t *data, size_t len) {
+
+    return Update.write(const_cast<uint8_t *>(data), len) == len;
+}
+
+bool EspFlashBackend::commit() {
+    // The image is already verified so accept it even though it is 
+    // smaller than the space that was reserved for it
+    
+    return Update.end(true);
+}
+
+void EspFlashBackend::abort() {
+    // Ending an unfinished update without evenIfRemaining discards it
+    Update.end(false);
+    Update.clearError();
+}
+
+bool EspFlashBackend::readCurrent(size_t offset, uint8_t *data, size_t len) {
+    // The running sketch starts at the beginning of flash
+
+    return ESP.flashRead(offset, data, len);
+}
+
+size_t EspFlashBackend::getCurrentSize() {
+
+    return ESP.getSketchSize();
+}
+
+String EspFlashBackend::getCurrentMd5() {
+    // The core caches this after the first call
+
+    return ESP.getSketchMD5();
+}
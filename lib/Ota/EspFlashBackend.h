@@ -0,0 +1,28 @@
+#ifndef EspFlashBackend_h
+    #define EspFlashBackend_h
+
+    #include <Arduino.h>
+    #include <Updater.h>
+
+    #include "FlashBackend.h"
+
+    /**
+     * The EspFlashBackend class is the FlashBackend used on the device. It 
+     * writes into the OTA partition by way of the ESP8266 core's Updater,
+     * which also takes care of telling the bootloader to swap images.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class EspFlashBackend : public FlashBackend {
+        public:
+            bool begin(size_t maxSize) override;
+            bool write(const uint8_t *data, size_t len) override;
+            bool commit() override;
+            void abort() override;
+            bool readCurrent(size_t offset, uint8_t *data, size_t len) override;
+            size_t getCurrentSize() override;
+            String getCurrentMd5() override;
+    };
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef FlashBackend_h
+    #define FlashBackend_h
+
+    #include <stddef.h>
+    #include <stdint.h>
+    #include <WString.h>
+
+    /**
+     * The FlashBackend class is the interface thru which the OtaUpdater
+     * talks to the flash memory that receives a new firmware image. Keeping
+     * the flash behind this interface allows the OTA logic to be driven on
+     * the host against a fake backend that simply records what was written.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class FlashBackend {
+        public:
+            virtual ~FlashBackend() {}
+
+            /**
+             * Prepares the backend to receive an image of up to the given size.
+             * 
+             * @param maxSize The most bytes that may be written as size_t.
+             * 
+             * @return Returns true if the backend is ready otherwise false as bool.
+             */
+            virtual bool begin(size_t maxSize) = 0;
+
+            /**
+             * Writes the next chunk of the image. Chunks can be any size, the
+             * backend gathers them into whole sectors before writing flash.
+             * 
+             * @param data The bytes to write as const uint8_t pointer.
+             * @param len The number of bytes to write as size_t.
+             * 
+             * @return Returns true if written otherwise false as bool.
+             */
+            virtual bool write(const uint8_t *data, size_t len) = 0;
+
+            /**
+             * Marks the written image as the one to boot next.
+             * 
+             * @return Returns true if successful otherwise false as bool.
+             */
+            virtual bool commit() = 0;
+
+            /**
+             * Abandons the image being written.
+             */
+            virtual void abort() = 0;
+
+            /**
+             * Reads part of the firmware image that is currently running,
+             * which is the base image that deltas are applied against.
+             * 
+             * @param offset The offset into the running image as size_t.
+             * @param data The buffer to read into as uint8_t pointer.
+             * @param len The number of bytes to read as size_t.
+             * 
+             * @return Returns true if read otherwise false as bool.
+             */
+            virtual bool readCurrent(size_t offset, uint8_t *data, size_t len) = 0;
+
+            /**
+             * @return Returns the size of the running image as size_t.
+             */
+            virtual size_t getCurrentSize() = 0;
+
+            /**
+             * @return Returns the MD5 of the running image as hex String.
+             */
+            virtual String getCurrentMd5() = 0;
+    };
+
+#endif
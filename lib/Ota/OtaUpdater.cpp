@@ -0,0 +1,287 @@
+/*
+    OtaUpdater - A class that streams a full, gzip compressed or delta 
+    firmware image into flash as it arrives, verifying its MD5 hash 
+    before the new image is allowed to become the one that boots.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "OtaUpdater.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ * 
+ * @param backend The FlashBackend that receives the image.
+ */
+OtaUpdater::OtaUpdater(FlashBackend &backend) : backend(backend), delta(backend) {
+    format = FORMAT_UNKNOWN;
+    magicFill = 0;
+    bytesReceived = 0;
+    bytesWritten = 0;
+    startMillis = 0;
+    elapsedMillis = 0;
+    running = false;
+    expectedMd5[0] = '\0';
+}
+
+/**
+ * Starts receiving a new image.
+ * 
+ * @param md5Hex The expected MD5 of the uploaded file as 32 hex chars.
+ * @param maxSize The most bytes the image may have as size_t.
+ * 
+ * @return Returns true if the update was started otherwise false as bool.
+ */
+bool OtaUpdater::begin(const char *md5Hex, size_t maxSize) {
+    abort();
+    error = "";
+    format = FORMAT_UNKNOWN;
+    magicFill = 0;
+    bytesReceived = 0;
+    bytesWritten = 0;
+    elapsedMillis = 0;
+    startMillis = millis();
+
+    if (md5Hex == nullptr || strlen(md5Hex) != 32) {
+        fail(F("An MD5 hash of the image is required!"));
+
+        return false;
+    }
+    for (int i = 0; i < 32; i++) {
+        expectedMd5[i] = tolower(md5Hex[i]);
+    }
+    expectedMd5[32] = '\0';
+
+    if (!backend.begin(maxSize)) {
+        fail(F("Unable to prepare flash for the update!"));
+
+        return false;
+    }
+
+    md5.begin();
+    running = true;
+
+    return true;
+}
+
+/**
+ * Adds the next received bytes of the uploaded file. The format of
+ * the file is worked out from its first few bytes.
+ * 
+ * @param data The received bytes as const uint8_t pointer.
+ * @param len The number of received bytes as size_t.
+ * 
+ * @return Returns true if all is well otherwise false as bool.
+ */
+bool OtaUpdater::write(const uint8_t *data, size_t len) {
+    if (!running) {
+
+        return false;
+    }
+    md5.add(data, len);
+    bytesReceived += len;
+
+    if (format == FORMAT_UNKNOWN) {
+        // Hold back the first bytes until the format is known
+        while (len > 0 && magicFill < sizeof(magic)) {
+            magic[magicFill++] = *data++;
+            len--;
+        }
+        if (magicFill < sizeof(magic)) {
+
+            return true;
+        }
+        if (DeltaDecoder::isDelta(magic, magicFill)) {
+            format = FORMAT_DELTA;
+            delta.begin([this](const uint8_t *out, size_t outLen) { return writeImage(out, outLen); });
+        } else {
+            format = (magic[0] == 0x1F && magic[1] == 0x8B) ? FORMAT_GZIP : FORMAT_FULL;
+        }
+        if (!route(magic, magicFill)) {
+
+            return false;
+        }
+    }
+
+    return route(data, len);
+}
+
+/**
+ * Finishes the update by checking the image hash and then committing
+ * the image, which writes out its final partial sector, if it matched.
+ * 
+ * @return Returns true if the new image will boot next otherwise false as bool.
+ */
+bool OtaUpdater::end() {
+    if (!running) {
+
+        return false;
+    }
+    if (format == FORMAT_UNKNOWN && magicFill > 0) {
+        // Too short to have been sniffed
+        format = FORMAT_FULL;
+        if (!route(magic, magicFill)) {
+
+            return false;
+        }
+    }
+    if (format == FORMAT_DELTA && !delta.finish()) {
+        fail(delta.getError());
+
+        return false;
+    }
+    md5.calculate();
+    if (!md5.toString().equals(expectedMd5)) {
+        fail(F("MD5 of the uploaded file does not match!"));
+
+        return false;
+    }
+    if (!backend.commit()) {
+        fail(F("Unable to activate the new image!"));
+
+        return false;
+    }
+
+    elapsedMillis = millis() - startMillis;
+    running = false;
+
+    return true;
+}
+
+/**
+ * Abandons any update in progress.
+ */
+void OtaUpdater::abort() {
+    if (running) {
+        backend.abort();
+        elapsedMillis = millis() - startMillis;
+        running = false;
+    }
+}
+
+bool OtaUpdater::isRunning() {
+
+    return running;
+}
+
+bool OtaUpdater::hasError() {
+
+    return !error.isEmpty();
+}
+
+String OtaUpdater::getError() {
+
+    return error;
+}
+
+OtaUpdater::ImageFormat OtaUpdater::getFormat() {
+
+    return format;
+}
+
+String OtaUpdater::getFormatName() {
+    switch (format) {
+        case FORMAT_FULL:
+
+            return F("full");
+        case FORMAT_GZIP:
+
+            return F("gzip");
+        case FORMAT_DELTA:
+
+            return F("delta");
+        default:
+
+            return F("unknown");
+    }
+}
+
+size_t OtaUpdater::getBytesReceived() {
+
+    return bytesReceived;
+}
+
+size_t OtaUpdater::getBytesWritten() {
+
+    return bytesWritten;
+}
+
+unsigned long OtaUpdater::getElapsedMillis() {
+
+    return running ? millis() - startMillis : elapsedMillis;
+}
+
+/**
+ * @return Returns the average rate at which the uploaded file has
+ * been received in bytes per second as unsigned long.
+ */
+unsigned long OtaUpdater::getBytesPerSecond() {
+    unsigned long elapsed = getElapsedMillis();
+    if (elapsed == 0) {
+
+        return 0;
+    }
+
+    return (unsigned long)(((unsigned long long)bytesReceived * 1000ULL) / elapsed);
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Passes received bytes on according to the format of the file.
+ * 
+ * @return Returns true if all is well otherwise false as bool.
+ */
+bool OtaUpdater::route(const uint8_t *data, size_t len) {
+    if (format == FORMAT_DELTA) {
+        if (!delta.feed(data, len)) {
+            if (!hasError()) {
+                fail(delta.getError());
+            }
+
+            return false;
+        }
+
+        return true;
+    }
+
+    return writeImage(data, len);
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Hands bytes of the image being installed to the backend, which
+ * writes out each sector as soon as it has been filled.
+ * 
+ * @return Returns true if all is well otherwise false as bool.
+ */
+bool OtaUpdater::writeImage(const uint8_t *data, size_t len) {
+    if (len > 0 && !backend.write(data, len)) {
+        fail(F("Writing to flash failed!"));
+
+        return false;
+    }
+    bytesWritten += len;
+
+    return true;
+}
+
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Records the given error and abandons the update.
+ * 
+ * @param message The error message as flash string.
+ */
+void OtaUpdater::fail(const String &message) {
+    error = message;
+    abort();
+}
@@ -0,0 +1,78 @@
+#ifndef OtaUpdater_h
+    #define OtaUpdater_h
+
+    #include <Arduino.h>
+    #include <MD5Builder.h>
+
+    #include "FlashBackend.h"
+    #include "DeltaDecoder.h"
+
+    /**
+     * The OtaUpdater class streams a firmware image into flash as it arrives.
+     * Incoming bytes are handed straight to the FlashBackend, which gathers
+     * them into the one sector sized buffer the update needs so flash is 
+     * always erased and written a whole sector at a time. While a sector is
+     * being erased and written lwIP keeps receiving the following TCP 
+     * segments into its window, which overlaps network receive with the 
+     * flash work. 
+     * 
+     * The MD5 of the uploaded file is calculated on the fly and must match 
+     * the expected hash before the backend is allowed to switch partitions.
+     * 
+     * Besides full images two smaller forms are accepted to cut transfer 
+     * time. Gzip compressed images are written as is, the bootloader inflates
+     * them with its bounded window while installing them. Binary deltas 
+     * against the running image (see DeltaDecoder) are rebuilt on the fly so
+     * only the changed bytes cross the network.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class OtaUpdater {
+        public:
+            enum ImageFormat {
+                FORMAT_UNKNOWN,
+                FORMAT_FULL,
+                FORMAT_GZIP,
+                FORMAT_DELTA
+            };
+
+        private:
+            FlashBackend   &backend                   ;
+            DeltaDecoder   delta                      ;
+            ImageFormat    format                     ;
+            uint8_t        magic            [4]       ;
+            size_t         magicFill                  ;
+            size_t         bytesReceived              ;
+            size_t         bytesWritten               ;
+            unsigned long  startMillis                ;
+            unsigned long  elapsedMillis              ;
+            bool           running                    ;
+            char           expectedMd5      [33]      ;
+            MD5Builder     md5                        ;
+            String         error                      ;
+
+            bool route(const uint8_t *data, size_t len);
+            bool writeImage(const uint8_t *data, size_t len);
+            void fail(const String &message);
+
+        public:
+            OtaUpdater(FlashBackend &backend);
+
+            bool begin(const char *md5Hex, size_t maxSize);
+            bool write(const uint8_t *data, size_t len);
+            bool end();
+            void abort();
+
+            bool           isRunning          ()    ;
+            bool           hasError           ()    ;
+            String         getError           ()    ;
+            ImageFormat    getFormat          ()    ;
+            String         getFormatName      ()    ;
+            size_t         getBytesReceived   ()    ;
+            size_t         getBytesWritten    ()    ;
+            unsigned long  getElapsedMillis   ()    ;
+            unsigned long  getBytesPerSecond  ()    ;
+    };
+
+#endif
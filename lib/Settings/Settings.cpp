@@ -12,6 +12,12 @@
 
 #include "Settings.h"
 
+#define NV_END(field) (offsetof(NonVolatileSettings, field) + sizeof(((NonVolatileSettings *)0)->field))
+
+const size_t Settings::layouts[SETTINGS_LAYOUTS] = {
+    NV_END(lightsOn) // <------------------------ Before group control
+};
+
 /**
  * CLASS CONSTRUCTOR
  * 
@@ -42,14 +48,17 @@ bool Settings::factoryDefault() {
  * Used to load the settings from flash memory.
  * After the settings are loaded from flash memory the sentinel value is 
  * checked to ensure the integrity of the loaded data. If the sentinel 
- * value is wrong then the contents of the memory are deemed invalid and
- * the memory is wiped and then a factory default is instead performed.
+ * value is wrong, or nothing is stored in the current layout, settings
+ * saved by older firmware are looked for and brought forward. Failing
+ * that, memory that was deemed invalid is wiped and then a factory 
+ * default is instead performed.
  * 
  * @return Returns true if data was loaded from memory and the sentinel 
  * value was valid.
  */
 bool Settings::loadSettings() {
     bool ok = false;
+    bool isCorrupt = false;
     // Setup EEPROM for loading and saving
     EEPROM.begin(sizeof(NonVolatileSettings));
 
@@ -62,10 +71,8 @@ bool Settings::loadSettings() {
         Serial.println(F("\nLoading settings from EEPROM..."));
         EEPROM.get(0, nvSettings);
         if (strcmp(nvSettings.sentinel, hashNvSettings(nvSettings).c_str()) != 0) { 
-            // Memory is corrupt
-            EEPROM.wipe();
-            factoryDefault();
-            Serial.println("Stored settings footprint invalid, stored settings have been wiped and defaulted!");
+            // Memory is corrupt or from older firmware
+            isCorrupt = true;
         } else { 
             // Memory seems ok
             Serial.print(F("Percent of ESP Flash currently used is: "));
@@ -77,17 +84,29 @@ bool Settings::loadSettings() {
     
     EEPROM.end();
 
+    /* Bring Forward Settings From Older Firmware */
+    if (!ok && migrateSettings()) {
+        Serial.println(F("Stored settings were from older firmware and have been brought forward."));
+        ok = true;
+    } else if (isCorrupt) {
+        factoryDefault();
+        Serial.println("Stored settings footprint invalid, stored settings have been wiped and defaulted!");
+    }
+
     return ok;
 }
 
 /**
- * Used to provide a hash of the given NonVolatileSettings.
+ * Used to provide a hash of the given NonVolatileSettings. Settings in an
+ * older layout are hashed as that layout's firmware did, with just their
+ * fields.
  * 
  * @param nvSet An instance of NonVolatileSettings to calculate a hash for.
+ * @param length The length of the fields in the layout as size_t.
  * 
  * @return Returns the calculated hash value as String.
  */
-String Settings::hashNvSettings(NonVolatileSettings nvSet) {
+String Settings::hashNvSettings(NonVolatileSettings nvSet, size_t length) {
     String content = "";
     content = content + String(nvSet.ssid);
     content = content + String(nvSet.pwd);
@@ -98,6 +117,27 @@ String Settings::hashNvSettings(NonVolatileSettings nvSet) {
     content = content + String(nvSet.onTime);
     content = content + String(nvSet.offTime);
     content = content + (nvSet.lightsOn ? "true" : "false");
+    if (length > NV_END(lightsOn)) {
+        content = content + String(nvSet.groupId);
+        content = content + String(nvSet.brightness);
+        content = content + String(nvSet.controlKey);
+        content = content + String(nvSet.mqttHost);
+        content = content + String(nvSet.mqttPort);
+        content = content + String(nvSet.mqttUser);
+        content = content + String(nvSet.mqttPwd);
+        content = content + (nvSet.vacationOn ? "true" : "false");
+        content = content + String(nvSet.vacationOnFrom);
+        content = content + String(nvSet.vacationOnTo);
+        content = content + String(nvSet.vacationOffFrom);
+        content = content + String(nvSet.vacationOffTo);
+        content = content + (nvSet.ambientOn ? "true" : "false");
+        content = content + String(nvSet.ambientThreshold);
+        content = content + (nvSet.occupancyOn ? "true" : "false");
+        content = content + String(nvSet.occupancyTimeout);
+        content = content + (nvSet.circadianOn ? "true" : "false");
+        content = content + String(nvSet.warmKelvin);
+        content = content + String(nvSet.coolKelvin);
+    }
     
     MD5Builder builder = MD5Builder();
     builder.begin();
@@ -149,7 +189,8 @@ String Settings::getSsid() {
 }
 
 void Settings::setSsid(const char *ssid) {
-    if (sizeof(ssid) <= sizeof(nvSettings.ssid)) {
+    if (ssid != nullptr && strlen(ssid) < sizeof(nvSettings.ssid)) {
+        // Fits along with its null terminator
         strcpy(nvSettings.ssid, ssid);
     }
 }
@@ -161,7 +202,8 @@ String Settings::getPwd() {
 }
 
 void Settings::setPwd(const char *pwd) {
-    if (sizeof(pwd) <= sizeof(nvSettings.pwd)) {
+    if (pwd != nullptr && strlen(pwd) < sizeof(nvSettings.pwd)) {
+        // Fits along with its null terminator
         strcpy(nvSettings.pwd, pwd);
     }
 }
@@ -232,7 +274,8 @@ String Settings::getAdminUser() {
 
 void Settings::setAdminUser(const char *user) {
 
-    if (sizeof(user) <= sizeof(nvSettings.adminUser)) {
+    if (user != nullptr && strlen(user) < sizeof(nvSettings.adminUser)) {
+        // Fits along with its null terminator
         strcpy(nvSettings.adminUser, user);
     }
 }
@@ -244,14 +287,16 @@ String Settings::getAdminPwd() {
 }
 
 void Settings::setAdminPwd(const char *pwd) {
-    if (sizeof(pwd) <= sizeof(nvSettings.adminPwd)) {
+    if (pwd != nullptr && strlen(pwd) < sizeof(nvSettings.adminPwd)) {
+        // Fits along with its null terminator
         strcpy(nvSettings.adminPwd, pwd);
     }
 }
 
 
 void Settings::setApPwd(const char *pwd) {
-    if (sizeof(pwd) <= sizeof(nvSettings.apPwd)) {
+    if (pwd != nullptr && strlen(pwd) < sizeof(nvSettings.apPwd)) {
+        // Fits along with its null terminator
         strcpy(nvSettings.apPwd, pwd);
     }
 }
@@ -298,6 +343,208 @@ void Settings::setLightsOn(bool lightsOn) {
 }
 
 
+int Settings::getBrightness() {
+
+    return nvSettings.brightness;
+}
+
+void Settings::setBrightness(int percent) {
+    nvSettings.brightness = constrain(percent, 1, 100);
+}
+
+
+int Settings::getGroupId() {
+
+    return nvSettings.groupId;
+}
+
+void Settings::setGroupId(int groupId) {
+    nvSettings.groupId = groupId;
+}
+
+
+String Settings::getControlKey() {
+
+    return String(nvSettings.controlKey);
+}
+
+void Settings::setControlKey(const char *key) {
+    if (key != nullptr && strlen(key) < sizeof(nvSettings.controlKey)) {
+        // Fits along with its null terminator
+        strcpy(nvSettings.controlKey, key);
+    }
+}
+
+
+String Settings::getMqttHost() {
+
+    return String(nvSettings.mqttHost);
+}
+
+void Settings::setMqttHost(const char *host) {
+    if (host != nullptr && strlen(host) < sizeof(nvSettings.mqttHost)) {
+        // Fits along with its null terminator
+        strcpy(nvSettings.mqttHost, host);
+    }
+}
+
+
+int Settings::getMqttPort() {
+
+    return nvSettings.mqttPort;
+}
+
+void Settings::setMqttPort(int port) {
+    nvSettings.mqttPort = constrain(port, 1, 65535);
+}
+
+
+String Settings::getMqttUser() {
+
+    return String(nvSettings.mqttUser);
+}
+
+void Settings::setMqttUser(const char *user) {
+    if (user != nullptr && strlen(user) < sizeof(nvSettings.mqttUser)) {
+        // Fits along with its null terminator
+        strcpy(nvSettings.mqttUser, user);
+    }
+}
+
+
+String Settings::getMqttPwd() {
+
+    return String(nvSettings.mqttPwd);
+}
+
+void Settings::setMqttPwd(const char *pwd) {
+    if (pwd != nullptr && strlen(pwd) < sizeof(nvSettings.mqttPwd)) {
+        // Fits along with its null terminator
+        strcpy(nvSettings.mqttPwd, pwd);
+    }
+}
+
+
+bool Settings::isVacationOn() {
+
+    return nvSettings.vacationOn;
+}
+
+void Settings::setVacationOn(bool on) {
+    nvSettings.vacationOn = on;
+}
+
+
+int Settings::getVacationOnFrom() {
+
+    return nvSettings.vacationOnFrom;
+}
+
+void Settings::setVacationOnFrom(int time24) {
+    nvSettings.vacationOnFrom = time24;
+}
+
+
+int Settings::getVacationOnTo() {
+
+    return nvSettings.vacationOnTo;
+}
+
+void Settings::setVacationOnTo(int time24) {
+    nvSettings.vacationOnTo = time24;
+}
+
+
+int Settings::getVacationOffFrom() {
+
+    return nvSettings.vacationOffFrom;
+}
+
+void Settings::setVacationOffFrom(int time24) {
+    nvSettings.vacationOffFrom = time24;
+}
+
+
+int Settings::getVacationOffTo() {
+
+    return nvSettings.vacationOffTo;
+}
+
+void Settings::setVacationOffTo(int time24) {
+    nvSettings.vacationOffTo = time24;
+}
+
+
+bool Settings::isAmbientOn() {
+
+    return nvSettings.ambientOn;
+}
+
+void Settings::setAmbientOn(bool on) {
+    nvSettings.ambientOn = on;
+}
+
+
+int Settings::getAmbientThreshold() {
+
+    return nvSettings.ambientThreshold;
+}
+
+void Settings::setAmbientThreshold(int level) {
+    nvSettings.ambientThreshold = constrain(level, 0, 1023);
+}
+
+
+bool Settings::isOccupancyOn() {
+
+    return nvSettings.occupancyOn;
+}
+
+void Settings::setOccupancyOn(bool on) {
+    nvSettings.occupancyOn = on;
+}
+
+
+int Settings::getOccupancyTimeout() {
+
+    return nvSettings.occupancyTimeout;
+}
+
+void Settings::setOccupancyTimeout(int minutes) {
+    nvSettings.occupancyTimeout = constrain(minutes, 1, 240);
+}
+
+
+bool Settings::isCircadianOn() {
+
+    return nvSettings.circadianOn;
+}
+
+void Settings::setCircadianOn(bool on) {
+    nvSettings.circadianOn = on;
+}
+
+
+int Settings::getWarmKelvin() {
+
+    return nvSettings.warmKelvin;
+}
+
+void Settings::setWarmKelvin(int kelvin) {
+    nvSettings.warmKelvin = constrain(kelvin, 1000, 10000);
+}
+
+
+int Settings::getCoolKelvin() {
+
+    return nvSettings.coolKelvin;
+}
+
+void Settings::setCoolKelvin(int kelvin) {
+    nvSettings.coolKelvin = constrain(kelvin, 1000, 10000);
+}
+
+
 String Settings::getDefaultSsid() {
 
     return String(factorySettings.ssid);
@@ -315,6 +562,51 @@ Private Functions
 =================================================================
 */
 
+/**
+ * PRIVATE FUNCTION
+ * 
+ * Looks for settings saved by older firmware in each layout of the layouts
+ * table, newest first. The stored fields are taken as they are and any 
+ * added since are left at their factory defaults. Settings found are saved
+ * again in the current layout.
+ * 
+ * @return Returns true if settings were brought forward otherwise false as bool.
+ */
+bool Settings::migrateSettings() {
+    for (int i = SETTINGS_LAYOUTS - 1; i >= 0; i--) {
+        size_t length = layouts[i];
+        EEPROM.begin((length + sizeof(nvSettings.sentinel) + 3) & ~3);
+        if (EEPROM.percentUsed() < 0) {
+            // Nothing stored in this layout
+            EEPROM.end();
+            continue;
+        }
+
+        /* Read The Stored Fields Over The Defaults */
+        defaultSettings();
+        uint8_t *fields = (uint8_t *)&nvSettings;
+        for (size_t b = 0; b < length; b++) {
+            fields[b] = EEPROM.read(b);
+        }
+        char sentinel[sizeof(nvSettings.sentinel)];
+        for (size_t b = 0; b < sizeof(sentinel); b++) {
+            sentinel[b] = EEPROM.read(length + b);
+        }
+        sentinel[sizeof(sentinel) - 1] = '\0';
+        EEPROM.end();
+
+        if (strcmp(sentinel, hashNvSettings(nvSettings, length).c_str()) == 0) {
+            // Found them
+            saveSettings();
+
+            return true;
+        }
+    }
+    defaultSettings();
+
+    return false;
+}
+
 /**
  * PRIVATE FUNCTION
  * 
@@ -335,5 +627,24 @@ void Settings::defaultSettings() {
     nvSettings.onTime = factorySettings.onTime;
     nvSettings.offTime = factorySettings.offTime;
     nvSettings.lightsOn = factorySettings.lightsOn;
+    nvSettings.groupId = factorySettings.groupId;
+    nvSettings.brightness = factorySettings.brightness;
+    strcpy(nvSettings.controlKey, factorySettings.controlKey);
+    strcpy(nvSettings.mqttHost, factorySettings.mqttHost);
+    nvSettings.mqttPort = factorySettings.mqttPort;
+    strcpy(nvSettings.mqttUser, factorySettings.mqttUser);
+    strcpy(nvSettings.mqttPwd, factorySettings.mqttPwd);
+    nvSettings.vacationOn = factorySettings.vacationOn;
+    nvSettings.vacationOnFrom = factorySettings.vacationOnFrom;
+    nvSettings.vacationOnTo = factorySettings.vacationOnTo;
+    nvSettings.vacationOffFrom = factorySettings.vacationOffFrom;
+    nvSettings.vacationOffTo = factorySettings.vacationOffTo;
+    nvSettings.ambientOn = factorySettings.ambientOn;
+    nvSettings.ambientThreshold = factorySettings.ambientThreshold;
+    nvSettings.occupancyOn = factorySettings.occupancyOn;
+    nvSettings.occupancyTimeout = factorySettings.occupancyTimeout;
+    nvSettings.circadianOn = factorySettings.circadianOn;
+    nvSettings.warmKelvin = factorySettings.warmKelvin;
+    nvSettings.coolKelvin = factorySettings.coolKelvin;
     strcpy(nvSettings.sentinel, hashNvSettings(factorySettings).c_str());
 }
\ No newline at end of file
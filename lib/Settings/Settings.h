@@ -2,12 +2,15 @@
     #define Settings_h
 
     #include <string.h> // NEEDED by ESP_EEPROM and MUST appear before WString
+    #include <stddef.h>
     #include <ESP_EEPROM.h>
     #include <WString.h>
     #include <core_esp8266_features.h>
     #include <HardwareSerial.h>
     #include <MD5Builder.h>
 
+    #define SETTINGS_LAYOUTS 1
+
     /**
      * The Settings class instantiates into an object which is intended to be the gateway
      * thru which the software interacts with all settings, including those persisted to
@@ -19,7 +22,9 @@
     class Settings {
         private:
             // *****************************************************************************
-            // Structure used for storing of settings related data and persisted into flash
+            // Structure used for storing of settings related data and persisted into flash.
+            // New fields only ever go just before the sentinel, so settings saved by older
+            // firmware, whose layouts are in the layouts table, can be brought forward.
             // *****************************************************************************
             struct NonVolatileSettings {
                 char           ssid             [33]  ; // 32 chars is max size + 1 null
@@ -33,6 +38,25 @@
                 int            onTime                 ;
                 int            offTime                ;
                 bool           lightsOn               ;
+                int            groupId                ; // 0 means not in a group
+                int            brightness             ; // 1 to 100 percent
+                char           controlKey       [33]  ; // Empty turns UDP control off
+                char           mqttHost         [64]  ; // Empty turns MQTT off
+                int            mqttPort               ;
+                char           mqttUser         [33]  ;
+                char           mqttPwd          [33]  ;
+                bool           vacationOn             ; // Timer follows a made up schedule
+                int            vacationOnFrom         ;
+                int            vacationOnTo           ;
+                int            vacationOffFrom        ;
+                int            vacationOffTo          ;
+                bool           ambientOn              ; // Timer held off while light out
+                int            ambientThreshold       ; // 0 to 1023, dark at or below
+                bool           occupancyOn            ; // Lights follow the occupancy input
+                int            occupancyTimeout       ; // Minutes empty before off
+                bool           circadianOn            ; // White follows the time of day
+                int            warmKelvin             ; // Of the warm white channel
+                int            coolKelvin             ; // Of the cool white channel
                 char           sentinel         [33]  ; // Holds a 32 MD5 hash + 1
             } nvSettings;
 
@@ -48,9 +72,34 @@
                 1700, // <--------------------------- onTime
                 2200, // <--------------------------- offTime
                 false, // <-------------------------- lightsOn
+                0, // <------------------------------ groupId
+                100, // <---------------------------- brightness
+                "", // <----------------------------- controlKey
+                "", // <----------------------------- mqttHost
+                1883, // <--------------------------- mqttPort
+                "", // <----------------------------- mqttUser
+                "", // <----------------------------- mqttPwd
+                false, // <-------------------------- vacationOn
+                1730, // <--------------------------- vacationOnFrom
+                1930, // <--------------------------- vacationOnTo
+                2200, // <--------------------------- vacationOffFrom
+                2345, // <--------------------------- vacationOffTo
+                false, // <-------------------------- ambientOn
+                300, // <---------------------------- ambientThreshold
+                false, // <-------------------------- occupancyOn
+                5, // <------------------------------ occupancyTimeout
+                false, // <-------------------------- circadianOn
+                2700, // <--------------------------- warmKelvin
+                6500, // <--------------------------- coolKelvin
                 "NA" // <---------------------------- sentinel
             };
 
+            // *****************************************************************************
+            // Every older layout the settings have been saved in, oldest first, each being
+            // the length of the fields of the current layout that it had.
+            // *****************************************************************************
+            static const size_t layouts[SETTINGS_LAYOUTS];
+
             // ******************************************************************
             // Structure used for storing of settings related data NOT persisted
             // ******************************************************************
@@ -77,7 +126,8 @@
             };
             
             void defaultSettings();
-            String hashNvSettings(NonVolatileSettings nvSet);
+            bool migrateSettings();
+            String hashNvSettings(NonVolatileSettings nvSet, size_t length = sizeof(NonVolatileSettings));
 
 
         public:
@@ -128,6 +178,58 @@
             // Used for ligthing functionality
             void           setLightsOn         (bool on)                ;
             bool           isLightsOn          ()                       ;
+            void           setBrightness       (int percent)            ;
+            int            getBrightness       ()                       ;
+
+            // Used for group control functionality
+            void           setGroupId          (int groupId)            ;
+            int            getGroupId          ()                       ;
+
+            // Used for UDP control functionality
+            void           setControlKey       (const char *key)        ;
+            String         getControlKey       ()                       ;
+
+            // Used for MQTT functionality
+            void           setMqttHost         (const char *host)       ;
+            String         getMqttHost         ()                       ;
+            void           setMqttPort         (int port)               ;
+            int            getMqttPort         ()                       ;
+            void           setMqttUser         (const char *user)       ;
+            String         getMqttUser         ()                       ;
+            void           setMqttPwd          (const char *pwd)        ;
+            String         getMqttPwd          ()                       ;
+
+            // Used for vacation functionality
+            void           setVacationOn       (bool on)                ;
+            bool           isVacationOn        ()                       ;
+            void           setVacationOnFrom   (int time24)             ;
+            int            getVacationOnFrom   ()                       ;
+            void           setVacationOnTo     (int time24)             ;
+            int            getVacationOnTo     ()                       ;
+            void           setVacationOffFrom  (int time24)             ;
+            int            getVacationOffFrom  ()                       ;
+            void           setVacationOffTo    (int time24)             ;
+            int            getVacationOffTo    ()                       ;
+
+            // Used for ambient light functionality
+            void           setAmbientOn        (bool on)                ;
+            bool           isAmbientOn         ()                       ;
+            void           setAmbientThreshold (int level)              ;
+            int            getAmbientThreshold ()                       ;
+
+            // Used for occupancy functionality
+            void           setOccupancyOn      (bool on)                ;
+            bool           isOccupancyOn       ()                       ;
+            void           setOccupancyTimeout (int minutes)            ;
+            int            getOccupancyTimeout ()                       ;
+
+            // Used for tunable white functionality
+            void           setCircadianOn      (bool on)                ;
+            bool           isCircadianOn       ()                       ;
+            void           setWarmKelvin       (int kelvin)             ;
+            int            getWarmKelvin       ()                       ;
+            void           setCoolKelvin       (int kelvin)             ;
+            int            getCoolKelvin       ()                       ;
             
             // WiFi AP Settings
             String       getHostname       (String deviceId)    ;
@@ -0,0 +1,270 @@
+/*
+    PageTemplate - A class that streams PROGMEM pages with their 
+    place-holders filled in, knowing the exact length up front.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "PageTemplate.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ * 
+ * @param source The page with its ${name} place-holders as PGM_P.
+ */
+PageTemplate::PageTemplate(PGM_P source) {
+    this->source = source;
+    parsed = false;
+    overflowed = false;
+    segmentCount = 0;
+    slotCount = 0;
+    setSlots = 0;
+    literalLength = 0;
+}
+
+/**
+ * Sets the value of a place-holder. The value is sent as is, so it must
+ * already be escaped as needed.
+ * 
+ * @param name The name of the place-holder without the ${} as __FlashStringHelper*.
+ * @param value The value to send in place of the place-holder as String.
+ * 
+ * @return Returns true if the page has the place-holder otherwise false as bool.
+ */
+bool PageTemplate::set(const __FlashStringHelper *name, const String &value) {
+    parse();
+    int slot = findSlot((PGM_P)name, strlen_P((PGM_P)name));
+    if (slot == -1) {
+
+        return false;
+    }
+    values[slot] = value;
+    setSlots |= (uint64_t)1 << slot;
+
+    return true;
+}
+
+/**
+ * Empties the values of all the place-holders.
+ */
+void PageTemplate::clear() {
+    for (size_t i = 0; i < slotCount; i++) {
+        values[i] = "";
+    }
+}
+
+/**
+ * Checks the whole page fit in the segment table when it was split up.
+ * 
+ * @return Returns true if every place-holder has its slot otherwise false as bool.
+ */
+bool PageTemplate::isValid() {
+    parse();
+
+    return !overflowed;
+}
+
+/**
+ * Checks every place-holder in the page has been set, logging the name
+ * of each one that has not.
+ * 
+ * @return Returns true if every place-holder has a value otherwise false as bool.
+ */
+bool PageTemplate::isComplete() {
+    parse();
+    bool complete = true;
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        if (setSlots & ((uint64_t)1 << slot)) {
+            continue;
+        }
+        char name[TEMPLATE_MAX_NAME + 1];
+        memcpy_P(name, source + slotNames[slot].offset, slotNames[slot].length);
+        name[slotNames[slot].length] = '\0';
+        Serial.printf("Page place-holder ${%s} was never set!\n", name);
+        complete = false;
+    }
+
+    return complete;
+}
+
+/**
+ * Counts how many bytes sending the page would take with the current
+ * values. No part of the page is generated to do this.
+ * 
+ * @return Returns the length of the page as size_t.
+ */
+size_t PageTemplate::getLength() {
+    parse();
+    size_t length = literalLength;
+    for (size_t i = 0; i < segmentCount; i++) {
+        if (segments[i].slot != TEMPLATE_LITERAL) {
+            length += values[segments[i].slot].length();
+        }
+    }
+
+    return length;
+}
+
+size_t PageTemplate::getSegmentCount() {
+    parse();
+
+    return segmentCount;
+}
+
+/**
+ * Sends the page with the current values as the response to the current
+ * request, its Content-Length set to the exact length of the page. A page
+ * that did not fit the template, or has a place-holder that was never set,
+ * is answered with a 500 instead.
+ * 
+ * @param web The web server handling the request as ESP8266WebServer&.
+ * @param code The HTTP status code to respond with as int.
+ * @param contentType The content type of the page as __FlashStringHelper*.
+ */
+void PageTemplate::send(ESP8266WebServer &web, int code, const __FlashStringHelper *contentType) {
+    if (!isValid() || !isComplete()) {
+        // Never send a page with place-holders left in it
+        web.send(500, F("text/plain"), F("Page could not be filled in!"));
+
+        return;
+    }
+    web.setContentLength(getLength());
+    web.send(code, contentType, "");
+
+    char buffer[TEMPLATE_SEND_BUFFER];
+    size_t used = 0;
+    for (size_t i = 0; i < segmentCount; i++) {
+        bool isLiteral = segments[i].slot == TEMPLATE_LITERAL;
+        const char *from = isLiteral ? source + segments[i].offset : values[segments[i].slot].c_str();
+        size_t length = isLiteral ? segments[i].length : values[segments[i].slot].length();
+        size_t done = 0;
+        while (done < length) {
+            size_t n = std::min(length - done, (size_t)TEMPLATE_SEND_BUFFER - used);
+            if (isLiteral) {
+                memcpy_P(buffer + used, from + done, n);
+            } else {
+                memcpy(buffer + used, from + done, n);
+            }
+            used += n;
+            done += n;
+            if (used == TEMPLATE_SEND_BUFFER) {
+                // Buffer full so send it on
+                web.sendContent(buffer, used);
+                used = 0;
+            }
+        }
+    }
+    if (used > 0) {
+        web.sendContent(buffer, used);
+    }
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Splits the page into its segment table, on first use only. Should the
+ * page have more place-holders than the table has room for the page is
+ * marked as overflowed, which isValid() reports and send() refuses.
+ */
+void PageTemplate::parse() {
+    if (parsed) {
+
+        return;
+    }
+    parsed = true;
+
+    size_t length = strlen_P(source);
+    size_t literalStart = 0;
+    size_t i = 0;
+    while (i + 1 < length) {
+        if (pgm_read_byte(source + i) != '$' || pgm_read_byte(source + i + 1) != '{') {
+            i++;
+            continue;
+        }
+
+        /* Find The End Of The Name */
+        size_t nameStart = i + 2;
+        size_t nameEnd = nameStart;
+        while (nameEnd < length && nameEnd - nameStart <= TEMPLATE_MAX_NAME && pgm_read_byte(source + nameEnd) != '}') {
+            nameEnd++;
+        }
+        if (nameEnd >= length || nameEnd == nameStart || nameEnd - nameStart > TEMPLATE_MAX_NAME) {
+            // Not a place-holder
+            i++;
+            continue;
+        }
+
+        /* Find Or Add The Slot For Its Value */
+        int slot = findSlot(source + nameStart, nameEnd - nameStart);
+        if (slot == -1 && slotCount < TEMPLATE_MAX_SLOTS) {
+            slotNames[slotCount].offset = nameStart;
+            slotNames[slotCount].length = nameEnd - nameStart;
+            slot = slotCount++;
+        }
+        if (slot == -1 || segmentCount + 3 > TEMPLATE_MAX_SEGMENTS) {
+            // Out of room
+            Serial.println(F("Page has too many place-holders for its template!"));
+            overflowed = true;
+            break;
+        }
+
+        addSegment(literalStart, i - literalStart, TEMPLATE_LITERAL);
+        addSegment(0, 0, slot);
+        i = nameEnd + 1;
+        literalStart = i;
+    }
+    addSegment(literalStart, length - literalStart, TEMPLATE_LITERAL);
+}
+
+/**
+ * Adds a segment to the end of the segment table. Empty runs of literal
+ * text are left out.
+ * 
+ * @param offset Where literal text starts in the page as uint16_t.
+ * @param length The length of literal text as uint16_t.
+ * @param slot The slot of a place-holder or TEMPLATE_LITERAL as int8_t.
+ */
+void PageTemplate::addSegment(uint16_t offset, uint16_t length, int8_t slot) {
+    if (slot == TEMPLATE_LITERAL) {
+        if (length == 0) {
+
+            return;
+        }
+        literalLength += length;
+    }
+    segments[segmentCount].offset = offset;
+    segments[segmentCount].length = length;
+    segments[segmentCount].slot = slot;
+    segmentCount++;
+}
+
+/**
+ * Finds the slot holding the value of the named place-holder.
+ * 
+ * @param name The name, which must be in PROGMEM, as PGM_P.
+ * @param nameLength The length of the name as size_t.
+ * 
+ * @return Returns the slot or -1 if there is none as int.
+ */
+int PageTemplate::findSlot(PGM_P name, size_t nameLength) {
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        if (slotNames[slot].length != nameLength) {
+            continue;
+        }
+        size_t i = 0;
+        while (i < nameLength && pgm_read_byte(source + slotNames[slot].offset + i) == pgm_read_byte(name + i)) {
+            i++;
+        }
+        if (i == nameLength) {
+
+            return slot;
+        }
+    }
+
+    return -1;
+}
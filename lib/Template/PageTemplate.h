@@ -0,0 +1,78 @@
+#ifndef PageTemplate_h
+    #define PageTemplate_h
+
+    #include <Arduino.h>
+    #include <ESP8266WebServer.h>
+
+    #define TEMPLATE_MAX_SLOTS 36 // The settings page has 27 place-holders, no more than 64
+    #define TEMPLATE_MAX_SEGMENTS 76 // Two per place-holder plus one
+    #define TEMPLATE_MAX_NAME 31
+    #define TEMPLATE_SEND_BUFFER 536
+    #define TEMPLATE_LITERAL -1
+
+    /**
+     * The PageTemplate class sends an HTML page kept in PROGMEM with its
+     * ${name} place-holders filled in, without ever building the page in RAM.
+     * 
+     * The page is split up once into a table of segments, each either a run
+     * of literal text (kept as an offset into the page) or a place-holder
+     * (kept as the slot holding its value). As the literal text never changes
+     * its total length is counted while splitting, so the exact length of the
+     * page is just that plus the length of each place-holder's value. That
+     * lets responses carry a Content-Length, rather than being chunked or
+     * ending with the connection, and still be streamed straight from flash.
+     * 
+     * While sending, literal text and values are gathered into a buffer of 
+     * TEMPLATE_SEND_BUFFER bytes, one TCP segment, so a page made of many 
+     * small pieces still goes out in a few full sized writes.
+     * 
+     * Values stay set until changed, so a page with unchanged values can be
+     * sent again with no work beyond the sending itself.
+     * 
+     * A page with more place-holders than TEMPLATE_MAX_SLOTS, or more pieces
+     * than TEMPLATE_MAX_SEGMENTS, is never sent part filled in. It is marked
+     * invalid when split up and sending it answers with an error instead.
+     * The same goes for a page with a place-holder that was never set, so a
+     * name misspelt in the page or the handler shows up the first time the
+     * page is asked for.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class PageTemplate {
+        private:
+            struct Segment {
+                uint16_t       offset          ; // into the page
+                uint16_t       length          ;
+                int8_t         slot            ; // TEMPLATE_LITERAL for literal text
+            };
+
+            PGM_P          source                                  ;
+            bool           parsed                                  ;
+            bool           overflowed                              ; // page outgrew the tables
+            Segment        segments     [TEMPLATE_MAX_SEGMENTS]    ;
+            size_t         segmentCount                            ;
+            Segment        slotNames    [TEMPLATE_MAX_SLOTS]       ;
+            String         values       [TEMPLATE_MAX_SLOTS]       ;
+            size_t         slotCount                               ;
+            uint64_t       setSlots                                ; // one bit per slot given a value
+            size_t         literalLength                           ;
+
+            void parse();
+            void addSegment(uint16_t offset, uint16_t length, int8_t slot);
+            int findSlot(PGM_P name, size_t nameLength);
+
+        public:
+            PageTemplate(PGM_P source);
+
+            bool set(const __FlashStringHelper *name, const String &value);
+            void clear();
+
+            bool isValid();
+            bool isComplete();
+            size_t getLength();
+            size_t getSegmentCount();
+            void send(ESP8266WebServer &web, int code, const __FlashStringHelper *contentType);
+    };
+
+#endif
@@ -0,0 +1,120 @@
+/*
+    DaySchedule - A class that resolves each day's schedule and runs the
+    timer on it.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "DaySchedule.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ *
+ * @param timer The timer to run as LightTimer&.
+ * @param calendar The calendar to resolve days against as LightCalendar&.
+ * @param vacation The planner to use while on vacation as VacationPlanner&.
+ */
+DaySchedule::DaySchedule(LightTimer &timer, LightCalendar &calendar, VacationPlanner &vacation) : timer(timer), calendar(calendar), vacation(vacation) {
+    day = -1L;
+    onTime = 0;
+    offTime = 0;
+    rule = -1;
+}
+
+/**
+ * Forgets the day's schedule so it is resolved again on the next pass, as
+ * when the schedule, calendar or vacation settings change.
+ */
+void DaySchedule::invalidate() {
+    day = -1L;
+}
+
+/**
+ * Resolves the schedule for the given day unless it already is. While on
+ * vacation the day is planned, otherwise the calendar may replace the
+ * usual times.
+ *
+ * @param epochDay The local day as days since 1970-01-01 as long.
+ * @param onTime The usual 24hour time to switch on at as int.
+ * @param offTime The usual 24hour time to switch off at as int.
+ * @param isVacationOn Indicates vacation mode is on as bool.
+ *
+ * @return Returns true if the schedule was resolved afresh otherwise false
+ * as bool.
+ */
+bool DaySchedule::resolve(long epochDay, int onTime, int offTime, bool isVacationOn) {
+    if (epochDay == day) {
+
+        return false;
+    }
+
+    day = epochDay;
+    this->onTime = onTime;
+    this->offTime = offTime;
+    rule = -1;
+    if (isVacationOn) {
+        // Nobody home so make up a schedule instead
+        vacation.plan((uint16_t)day, this->onTime, this->offTime);
+    } else {
+        rule = calendar.resolve((uint16_t)day, this->onTime, this->offTime);
+    }
+
+    return true;
+}
+
+/**
+ * Runs the timer on the day's schedule. When the timer isn't running, or
+ * the time isn't known, it is reset so it lines up with the schedule again
+ * once it resumes.
+ *
+ * @param time24 The local 24hour time, -1 if the clock isn't set, as int.
+ * @param isTimerOn Indicates the timer is enabled as bool.
+ * @param isVacationOn Indicates vacation mode is on as bool.
+ * @param isAmbientLight Indicates the ambient sensor says it is light out
+ * as bool.
+ *
+ * @return Returns the TIMER_ACTION to take as uint8_t.
+ */
+uint8_t DaySchedule::evaluate(int time24, bool isTimerOn, bool isVacationOn, bool isAmbientLight) {
+    if (!(isTimerOn || isVacationOn) || time24 < 0 || day == -1L) {
+        timer.reset();
+
+        return TIMER_ACTION_NONE;
+    }
+
+    timer.setSchedule(onTime, offTime);
+    uint8_t action = timer.evaluate(time24);
+    if (action == TIMER_ACTION_ON && isAmbientLight) {
+        // Still light out, the ambient sensor switches on once it is dark
+
+        return TIMER_ACTION_NONE;
+    }
+
+    return action;
+}
+
+bool DaySchedule::isResolved() {
+
+    return day != -1L;
+}
+
+long DaySchedule::getDay() {
+
+    return day;
+}
+
+int DaySchedule::getOnTime() {
+
+    return onTime;
+}
+
+int DaySchedule::getOffTime() {
+
+    return offTime;
+}
+
+int DaySchedule::getRule() {
+
+    return rule;
+}
@@ -0,0 +1,46 @@
+#ifndef DaySchedule_h
+    #define DaySchedule_h
+
+    #include <stdint.h>
+    #include "LightTimer.h"
+    #include "LightCalendar.h"
+    #include "VacationPlanner.h"
+
+    /**
+     * The DaySchedule class works out the schedule the timer follows each
+     * day and runs the timer on it. Once a day, or whenever it is told the
+     * inputs changed, the usual on and off times are resolved against the
+     * vacation plan or the calendar. In between the LightTimer is handed
+     * that schedule on each pass and its answer passed on, an on being held
+     * back while the ambient sensor says it is still light.
+     *
+     * It is shared by the firmware's loop and the host timer simulation so
+     * both run the very same steps.
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class DaySchedule {
+        private:
+            LightTimer     &timer                   ;
+            LightCalendar  &calendar                ;
+            VacationPlanner &vacation               ;
+            long           day                      ; // -1 until resolved
+            int            onTime                   ;
+            int            offTime                  ;
+            int            rule                     ;
+
+        public:
+            DaySchedule(LightTimer &timer, LightCalendar &calendar, VacationPlanner &vacation);
+
+            void invalidate();
+            bool resolve(long epochDay, int onTime, int offTime, bool isVacationOn);
+            uint8_t evaluate(int time24, bool isTimerOn, bool isVacationOn, bool isAmbientLight);
+            bool isResolved();
+            long getDay();
+            int getOnTime();
+            int getOffTime();
+            int getRule();
+    };
+
+#endif
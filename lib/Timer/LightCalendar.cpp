@@ -0,0 +1,379 @@
+/*
+    LightCalendar - A class that holds date based exceptions to the timer's
+    daily schedule and resolves them into a day's schedule.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "LightCalendar.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+LightCalendar::LightCalendar() {
+    memset(rules, 0, sizeof(rules));
+    count = 0;
+}
+
+/**
+ * Adds a rule, keeping the table sorted.
+ *
+ * @param rule The rule to add as CalendarRule&.
+ *
+ * @return Returns true if added or false if the rule isn't valid or the
+ * table is full as bool.
+ */
+bool LightCalendar::add(const CalendarRule &rule) {
+    if (count >= CALENDAR_MAX_RULES || !isValid(rule)) {
+
+        return false;
+    }
+
+    uint8_t at = count;
+    while (at > 0 && isBefore(rule, rules[at - 1])) {
+        // Make room further up
+        rules[at] = rules[at - 1];
+        at--;
+    }
+    rules[at] = rule;
+    count++;
+
+    return true;
+}
+
+/**
+ * Removes the rule at the given index.
+ *
+ * @param index The index of the rule as uint8_t.
+ *
+ * @return Returns true if removed otherwise false as bool.
+ */
+bool LightCalendar::remove(uint8_t index) {
+    if (index >= count) {
+
+        return false;
+    }
+    memmove(&rules[index], &rules[index + 1], (count - index - 1) * sizeof(CalendarRule));
+    count--;
+
+    return true;
+}
+
+void LightCalendar::clear() {
+    count = 0;
+}
+
+uint8_t LightCalendar::getCount() {
+
+    return count;
+}
+
+const CalendarRule &LightCalendar::getRule(uint8_t index) {
+
+    return rules[index];
+}
+
+/**
+ * Resolves the schedule for the given day. Dated rules are sorted by their
+ * start so those starting after the day are skipped without a look.
+ *
+ * @param epochDay The day as days since 1970-01-01 as uint16_t.
+ * @param onTime Set to the 24hour time to switch on at if a rule covers
+ * the day, otherwise left as is, as int&.
+ * @param offTime Set to the 24hour time to switch off at if a rule covers
+ * the day, otherwise left as is, as int&.
+ *
+ * @return Returns the index of the rule covering the day or -1 if there is
+ * none as int.
+ */
+int LightCalendar::resolve(uint16_t epochDay, int &onTime, int &offTime) {
+    int year, month, day;
+    fromEpochDay(epochDay, year, month, day);
+    uint16_t monthDay = (month * 100) + day;
+    uint8_t weekday = toWeekday(epochDay);
+
+    int found = -1;
+    uint8_t i = 0;
+    while (i < count) {
+        if (found != -1 && rules[i].kind != rules[found].kind) {
+            // Covered by a rule of a kind that wins
+
+            break;
+        }
+        if (rules[i].kind == CALENDAR_RULE_DATES && rules[i].start > epochDay) {
+            // Nor do any dated rules after it
+            while (i < count && rules[i].kind == CALENDAR_RULE_DATES) {
+                i++;
+            }
+            continue;
+        }
+        if (covers(rules[i], epochDay, monthDay, weekday) && (found == -1 || span(rules[i]) < span(rules[found]))) {
+            found = i;
+        }
+        i++;
+    }
+
+    if (found != -1) {
+        onTime = rules[found].onTime;
+        offTime = rules[found].offTime;
+    }
+
+    return found;
+}
+
+/**
+ * Replaces the rules, as when loading them from flash. Rules that aren't
+ * valid are dropped.
+ *
+ * @param rules The rules as CalendarRule*.
+ * @param count The number of rules as uint8_t.
+ *
+ * @return Returns true if all rules were taken otherwise false as bool.
+ */
+bool LightCalendar::setRules(const CalendarRule *rules, uint8_t count) {
+    bool ok = true;
+    clear();
+    for (uint8_t i = 0; i < count; i++) {
+        ok = add(rules[i]) && ok;
+    }
+
+    return ok;
+}
+
+/**
+ * Gets the table of rules, sorted, to be saved.
+ *
+ * @return Returns the first of getCount() rules as CalendarRule*.
+ */
+const CalendarRule *LightCalendar::getRules() {
+
+    return rules;
+}
+
+/**
+ * Determines if a rule makes sense.
+ *
+ * @param rule The rule to check as CalendarRule&.
+ *
+ * @return Returns true if valid otherwise false as bool.
+ */
+bool LightCalendar::isValid(const CalendarRule &rule) {
+    if (
+        rule.onTime < 0 || rule.onTime > 2359 || rule.onTime % 100 > 59
+        || rule.offTime < 0 || rule.offTime > 2359 || rule.offTime % 100 > 59
+    ) {
+
+        return false;
+    }
+
+    switch (rule.kind) {
+        case CALENDAR_RULE_DATES:
+
+            return rule.start <= rule.end;
+        case CALENDAR_RULE_YEARLY:
+
+            return (
+                rule.start / 100 >= 1 && rule.start / 100 <= 12 && rule.start % 100 >= 1 && rule.start % 100 <= 31
+                && rule.end / 100 >= 1 && rule.end / 100 <= 12 && rule.end % 100 >= 1 && rule.end % 100 <= 31
+            );
+        case CALENDAR_RULE_WEEKLY:
+
+            return (rule.days & 0x7F) != 0;
+        default:
+
+            return false;
+    }
+}
+
+/**
+ * Parses a date as YYYY-MM-DD, or as MM-DD for yearly rules.
+ *
+ * @param text The date as char*.
+ * @param isYearly Indicates the date is for a yearly rule as bool.
+ * @param date Set to the date as days since 1970-01-01, or month * 100 +
+ * day for yearly rules, as uint16_t&.
+ *
+ * @return Returns true if parsed otherwise false as bool.
+ */
+bool LightCalendar::parseDate(const char *text, bool isYearly, uint16_t &date) {
+    size_t length = strlen(text);
+    if (length != (isYearly ? 5U : 10U) || text[length - 3] != '-' || (!isYearly && text[4] != '-')) {
+
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] != '-' && (text[i] < '0' || text[i] > '9')) {
+
+            return false;
+        }
+    }
+
+    int year = isYearly ? 0 : atoi(text);
+    int month = atoi(text + length - 5);
+    int day = atoi(text + length - 2);
+    if (month < 1 || month > 12 || day < 1 || day > 31 || (!isYearly && (year < 1970 || year > 2149))) {
+
+        return false;
+    }
+    date = isYearly ? (month * 100) + day : toEpochDay(year, month, day);
+
+    return true;
+}
+
+/**
+ * Formats a date as YYYY-MM-DD, or as MM-DD for yearly rules.
+ *
+ * @param date The date as days since 1970-01-01, or month * 100 + day for
+ * yearly rules, as uint16_t.
+ * @param isYearly Indicates the date is for a yearly rule as bool.
+ * @param buffer Where to write the date, 11 chars or more, as char*.
+ * @param size The size of the buffer as size_t.
+ *
+ * @return Returns the length written as int.
+ */
+int LightCalendar::formatDate(uint16_t date, bool isYearly, char *buffer, size_t size) {
+    if (isYearly) {
+
+        return snprintf(buffer, size, "%02d-%02d", date / 100, date % 100);
+    }
+    int year, month, day;
+    fromEpochDay(date, year, month, day);
+
+    return snprintf(buffer, size, "%04d-%02d-%02d", year, month, day);
+}
+
+/**
+ * Converts a date into days since 1970-01-01.
+ *
+ * @param year The year as int.
+ * @param month The month from 1 to 12 as int.
+ * @param day The day of the month as int.
+ *
+ * @return Returns the number of days as uint16_t.
+ */
+uint16_t LightCalendar::toEpochDay(int year, int month, int day) {
+    long y = year - (month <= 2 ? 1 : 0);
+    long era = y / 400;
+    long yearOfEra = y - (era * 400);
+    long dayOfYear = ((153 * (month + (month > 2 ? -3 : 9))) + 2) / 5 + day - 1;
+    long dayOfEra = (yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear;
+
+    return (era * 146097) + dayOfEra - 719468;
+}
+
+/**
+ * Converts days since 1970-01-01 into a date.
+ *
+ * @param epochDay The number of days as uint16_t.
+ * @param year Set to the year as int&.
+ * @param month Set to the month from 1 to 12 as int&.
+ * @param day Set to the day of the month as int&.
+ */
+void LightCalendar::fromEpochDay(uint16_t epochDay, int &year, int &month, int &day) {
+    long z = epochDay + 719468L;
+    long era = z / 146097;
+    long dayOfEra = z - (era * 146097);
+    long yearOfEra = (dayOfEra - (dayOfEra / 1460) + (dayOfEra / 36524) - (dayOfEra / 146096)) / 365;
+    long dayOfYear = dayOfEra - ((365 * yearOfEra) + (yearOfEra / 4) - (yearOfEra / 100));
+    long monthIndex = ((5 * dayOfYear) + 2) / 153;
+
+    day = dayOfYear - (((153 * monthIndex) + 2) / 5) + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = yearOfEra + (era * 400) + (month <= 2 ? 1 : 0);
+}
+
+/**
+ * Gets the day of the week of a day.
+ *
+ * @param epochDay The day as days since 1970-01-01 as uint16_t.
+ *
+ * @return Returns the day of the week, 0 being Sunday, as uint8_t.
+ */
+uint8_t LightCalendar::toWeekday(uint16_t epochDay) {
+
+    return (epochDay + 4) % 7;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Determines if a rule covers the given day.
+ *
+ * @param rule The rule as CalendarRule&.
+ * @param epochDay The day as days since 1970-01-01 as uint16_t.
+ * @param monthDay The day as month * 100 + day as uint16_t.
+ * @param weekday The day of the week, 0 being Sunday, as uint8_t.
+ *
+ * @return Returns true if covered otherwise false as bool.
+ */
+bool LightCalendar::covers(const CalendarRule &rule, uint16_t epochDay, uint16_t monthDay, uint8_t weekday) {
+    switch (rule.kind) {
+        case CALENDAR_RULE_DATES:
+
+            return epochDay >= rule.start && epochDay <= rule.end;
+        case CALENDAR_RULE_YEARLY:
+            if (rule.start <= rule.end) {
+
+                return monthDay >= rule.start && monthDay <= rule.end;
+            }
+
+            // Range runs over the new year
+            return monthDay >= rule.start || monthDay <= rule.end;
+        case CALENDAR_RULE_WEEKLY:
+
+            return (rule.days & (1 << weekday)) != 0;
+        default:
+
+            return false;
+    }
+}
+
+/**
+ * Gives a measure of how many days a rule covers, for the narrower of two
+ * rules to win. Yearly rules are measured roughly, as if every month had
+ * 31 days, which is enough to compare them.
+ *
+ * @param rule The rule as CalendarRule&.
+ *
+ * @return Returns the measure as uint16_t.
+ */
+uint16_t LightCalendar::span(const CalendarRule &rule) {
+    if (rule.kind == CALENDAR_RULE_DATES) {
+
+        return rule.end - rule.start;
+    }
+    if (rule.kind == CALENDAR_RULE_YEARLY) {
+        int start = ((rule.start / 100) * 31) + (rule.start % 100);
+        int end = ((rule.end / 100) * 31) + (rule.end % 100);
+
+        return end >= start ? end - start : end + (12 * 31) - start;
+    }
+
+    return 0;
+}
+
+/**
+ * Determines the order of rules in the table, by kind, then start, then end.
+ *
+ * @param a The rule to check as CalendarRule&.
+ * @param b The rule to check against as CalendarRule&.
+ *
+ * @return Returns true if a goes before b otherwise false as bool.
+ */
+bool LightCalendar::isBefore(const CalendarRule &a, const CalendarRule &b) {
+    if (a.kind != b.kind) {
+
+        return a.kind < b.kind;
+    }
+    if (a.start != b.start) {
+
+        return a.start < b.start;
+    }
+
+    return a.end < b.end;
+}
@@ -0,0 +1,80 @@
+#ifndef LightCalendar_h
+    #define LightCalendar_h
+
+    #include <stdint.h>
+    #include <string.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+
+    #define CALENDAR_MAX_RULES 24
+
+    #define CALENDAR_RULE_DATES 0 // <--- A date, or a range of dates, of a given year
+    #define CALENDAR_RULE_YEARLY 1 // <-- A date, or a range of dates, every year
+    #define CALENDAR_RULE_WEEKLY 2 // <-- Days of the week
+    #define CALENDAR_RULE_KINDS 3
+
+    /**
+     * A rule of the calendar, 10 bytes.
+     */
+    struct CalendarRule {
+        uint16_t       start            ; // epoch day, or month * 100 + day when yearly
+        uint16_t       end              ; // inclusive, same as start for a single date
+        int16_t        onTime           ; // 24hour time, same as offTime for off all day
+        int16_t        offTime          ;
+        uint8_t        kind             ;
+        uint8_t        days             ; // bit per weekday, Sunday first, when weekly
+    };
+
+    /**
+     * The LightCalendar class holds exceptions to the timer's daily schedule,
+     * such as being off on holidays or on later on Fridays. Each rule gives
+     * the on and off times to use on the days it covers, an on time equal to
+     * the off time keeping the lights off all day.
+     *
+     * Rules are kept in a table sorted by kind and then start, which is also
+     * the order they are saved in. Where rules overlap the kind decides, a
+     * dated rule beating a yearly one beating a weekly one, and between two
+     * of the same kind the one covering fewer days wins. So a single date
+     * can be carved out of a holiday range.
+     *
+     * The calendar is meant to be resolved once a day into that day's
+     * schedule, which the timer then follows as usual, so the cost of the
+     * rules is paid once a day rather than on every tick. When the schedule
+     * changes at midnight the timer lines the lights up with it at once.
+     *
+     * Like LightTimer it depends on nothing but what it is handed, so it can
+     * be run on the host.
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class LightCalendar {
+        private:
+            CalendarRule   rules        [CALENDAR_MAX_RULES]   ;
+            uint8_t        count                               ;
+
+            bool covers(const CalendarRule &rule, uint16_t epochDay, uint16_t monthDay, uint8_t weekday);
+            uint16_t span(const CalendarRule &rule);
+            static bool isBefore(const CalendarRule &a, const CalendarRule &b);
+
+        public:
+            LightCalendar();
+
+            bool add(const CalendarRule &rule);
+            bool remove(uint8_t index);
+            void clear();
+            uint8_t getCount();
+            const CalendarRule &getRule(uint8_t index);
+            int resolve(uint16_t epochDay, int &onTime, int &offTime);
+            bool setRules(const CalendarRule *rules, uint8_t count);
+            const CalendarRule *getRules();
+
+            static bool isValid(const CalendarRule &rule);
+            static bool parseDate(const char *text, bool isYearly, uint16_t &date);
+            static int formatDate(uint16_t date, bool isYearly, char *buffer, size_t size);
+            static uint16_t toEpochDay(int year, int month, int day);
+            static void fromEpochDay(uint16_t epochDay, int &year, int &month, int &day);
+            static uint8_t toWeekday(uint16_t epochDay);
+    };
+
+#endif
@@ -0,0 +1,87 @@
+/*
+    LightTimer - A class that decides when the daily timer should switch 
+    the lights on or off.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "LightTimer.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+LightTimer::LightTimer() {
+    onTime = 0;
+    offTime = 0;
+    lastInOnZone = -1;
+}
+
+/**
+ * Sets the schedule the timer follows. If it differs from the current
+ * one the timer is reset so the lights follow the new schedule at once.
+ * 
+ * @param onTime The 24hour time to switch on at as int.
+ * @param offTime The 24hour time to switch off at as int.
+ */
+void LightTimer::setSchedule(int onTime, int offTime) {
+    if (onTime != this->onTime || offTime != this->offTime) {
+        this->onTime = onTime;
+        this->offTime = offTime;
+        reset();
+    }
+}
+
+/**
+ * Forgets the last zone so that the next evaluation brings the lights
+ * in line with the schedule.
+ */
+void LightTimer::reset() {
+    lastInOnZone = -1;
+}
+
+/**
+ * Evaluates the timer at the given time.
+ * 
+ * @param time24 The local time in 24 hour format as an int.
+ * 
+ * @return Returns the TIMER_ACTION_ to take as uint8_t.
+ */
+uint8_t LightTimer::evaluate(int time24) {
+    int8_t curInOnZone = inOnZone(time24) ? 1 : 0;
+    if (curInOnZone == lastInOnZone) {
+
+        return TIMER_ACTION_NONE;
+    }
+    lastInOnZone = curInOnZone;
+
+    return curInOnZone ? TIMER_ACTION_ON : TIMER_ACTION_OFF;
+}
+
+/**
+ * This function id used to determine if the given time is
+ * located within the On Zone as defined by the on and off 
+ * time settings of the timer.
+ * 
+ * @param time24 The given time in 24 hour format as an int.
+ * 
+ * @return Returns a bool true if given time falls in the On Zone
+ * otherwise a false is returned.
+ */
+bool LightTimer::inOnZone(int time24) {
+
+    return (
+        (
+            onTime < offTime 
+            && time24 >= onTime 
+            && time24 < offTime
+        )
+        || (
+            onTime > offTime
+            && (
+                time24 >= onTime 
+                || time24 < offTime
+            )
+        )
+    );
+}
@@ -0,0 +1,38 @@
+#ifndef LightTimer_h
+    #define LightTimer_h
+
+    #include <stdint.h>
+
+    #define TIMER_ACTION_NONE 0
+    #define TIMER_ACTION_ON 1
+    #define TIMER_ACTION_OFF 2
+
+    /**
+     * The LightTimer class holds the decision logic of the daily timer. It is 
+     * given the local time and answers whether the lights should be switched,
+     * which only happens when the time crosses from the off zone into the on
+     * zone or back. In between the lights are left alone so that manual 
+     * changes stick until the next crossing.
+     * 
+     * It depends on nothing but the times it is handed, so it can be driven 
+     * by a virtual clock on the host just as well as by the device's clock.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class LightTimer {
+        private:
+            int            onTime          ;
+            int            offTime         ;
+            int8_t         lastInOnZone    ; // -1 until first evaluated
+
+        public:
+            LightTimer();
+
+            void setSchedule(int onTime, int offTime);
+            void reset();
+            uint8_t evaluate(int time24);
+            bool inOnZone(int time24);
+    };
+
+#endif
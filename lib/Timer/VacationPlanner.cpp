@@ -0,0 +1,108 @@
+/*
+    VacationPlanner - A class that makes up a varying daily schedule, within
+    set bounds, for while nobody is home.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "VacationPlanner.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+VacationPlanner::VacationPlanner() {
+    seed = 0;
+    onFrom = 1800;
+    onTo = 1800;
+    offFrom = 2300;
+    offTo = 2300;
+}
+
+/**
+ * Sets the seed the plans are made from, which should differ between
+ * devices so lights in different rooms don't move together.
+ * 
+ * @param seed The seed as uint32_t.
+ */
+void VacationPlanner::setSeed(uint32_t seed) {
+    this->seed = seed;
+}
+
+/**
+ * Sets the windows the on and off times are picked from. A window whose
+ * end is before its start runs past midnight.
+ * 
+ * @param onFrom The earliest 24hour time to switch on at as int.
+ * @param onTo The latest 24hour time to switch on at as int.
+ * @param offFrom The earliest 24hour time to switch off at as int.
+ * @param offTo The latest 24hour time to switch off at as int.
+ */
+void VacationPlanner::setBounds(int onFrom, int onTo, int offFrom, int offTo) {
+    this->onFrom = onFrom;
+    this->onTo = onTo;
+    this->offFrom = offFrom;
+    this->offTo = offTo;
+}
+
+/**
+ * Plans the given day.
+ * 
+ * @param epochDay The day as days since 1970-01-01 as uint16_t.
+ * @param onTime Set to the 24hour time to switch on at as int&.
+ * @param offTime Set to the 24hour time to switch off at as int&.
+ */
+void VacationPlanner::plan(uint16_t epochDay, int &onTime, int &offTime) {
+    uint32_t state = mix(seed ^ (epochDay * 0x9E3779B9UL));
+    onTime = pick(onFrom, onTo, state);
+    state = mix(state);
+    offTime = pick(offFrom, offTo, state);
+
+    if (offTime == onTime) {
+        // Would read as off all day, so stay on for a minute instead
+        offTime = onTime % 100 == 59 ? ((onTime / 100 + 1) % 24) * 100 : onTime + 1;
+    }
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Scrambles a value, being the finalizer of MurmurHash3, so that seeds
+ * a day apart give unrelated plans.
+ * 
+ * @param value The value to scramble as uint32_t.
+ * 
+ * @return Returns the scrambled value as uint32_t.
+ */
+uint32_t VacationPlanner::mix(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x85EBCA6BUL;
+    value ^= value >> 13;
+    value *= 0xC2B2AE35UL;
+    value ^= value >> 16;
+
+    return value;
+}
+
+/**
+ * Picks a minute within a window, the window running past midnight if
+ * its end is before its start.
+ * 
+ * @param from The start of the window as a 24hour time as int.
+ * @param to The end of the window, inclusive, as a 24hour time as int.
+ * @param random A random value as uint32_t.
+ * 
+ * @return Returns the 24hour time picked as int.
+ */
+int VacationPlanner::pick(int from, int to, uint32_t random) {
+    int fromMinute = ((from / 100) * 60) + (from % 100);
+    int toMinute = ((to / 100) * 60) + (to % 100);
+    int span = toMinute >= fromMinute ? toMinute - fromMinute : toMinute + 1440 - fromMinute;
+    int minute = (fromMinute + (random % (span + 1))) % 1440;
+
+    return ((minute / 60) * 100) + (minute % 60);
+}
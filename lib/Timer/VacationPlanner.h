@@ -0,0 +1,41 @@
+#ifndef VacationPlanner_h
+    #define VacationPlanner_h
+
+    #include <stdint.h>
+
+    /**
+     * The VacationPlanner class makes up a different on and off time for
+     * each day while nobody is home, so the lights don't give that away by
+     * switching at the same minute every day. The on time is picked from
+     * within one window of the evening and the off time from within
+     * another, either window being allowed to run past midnight.
+     * 
+     * The times come from a small PRNG seeded from the device's seed and
+     * the date, so a day is only planned once, at midnight, after which
+     * the timer follows the plan like any other schedule. The same seed
+     * and date always give the same plan, which is what lets a host test
+     * check it and a restart keep to the day's plan.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class VacationPlanner {
+        private:
+            uint32_t       seed            ;
+            int            onFrom          ;
+            int            onTo            ;
+            int            offFrom         ;
+            int            offTo           ;
+
+            static uint32_t mix(uint32_t value);
+            static int pick(int from, int to, uint32_t random);
+
+        public:
+            VacationPlanner();
+
+            void setSeed(uint32_t seed);
+            void setBounds(int onFrom, int onTo, int offFrom, int offTo);
+            void plan(uint16_t epochDay, int &onTime, int &offTime);
+    };
+
+#endif
@@ -0,0 +1,123 @@
+/*
+    RequestTrace - A class that records served web requests into a fixed
+    size ring buffer so production load can be replayed on demand.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "RequestTrace.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+RequestTrace::RequestTrace() {
+    records = nullptr;
+    capacity = 0;
+    count = 0;
+    next = 0;
+    startMillis = 0;
+}
+
+/**
+ * Starts a new capture, discarding any prior one.
+ * 
+ * @param capacity The number of records to keep as size_t.
+ * 
+ * @return Returns true if started otherwise false as bool.
+ */
+bool RequestTrace::start(size_t capacity) {
+    stop();
+    capacity = constrain(capacity, (size_t)1, (size_t)TRACE_MAX_RECORDS);
+    records = new (std::nothrow) TraceRecord[capacity];
+    if (records == nullptr) {
+
+        return false;
+    }
+    this->capacity = capacity;
+    startMillis = millis();
+
+    return true;
+}
+
+/**
+ * Stops capturing and frees the ring buffer.
+ */
+void RequestTrace::stop() {
+    if (records != nullptr) {
+        delete[] records;
+        records = nullptr;
+    }
+    capacity = 0;
+    count = 0;
+    next = 0;
+}
+
+bool RequestTrace::isCapturing() {
+
+    return records != nullptr;
+}
+
+/**
+ * Records a handled request, if capturing.
+ * 
+ * @param method The code of the request method as char.
+ * @param target The URI and url encoded args of the request as String.
+ * @param arrivedMillis The millis the request arrived at as unsigned long.
+ * @param durationMicros How long the request took to handle as uint32_t.
+ * @param freeHeap The free heap after handling as uint32_t.
+ */
+void RequestTrace::record(char method, const String &target, unsigned long arrivedMillis, uint32_t durationMicros, uint32_t freeHeap) {
+    if (records == nullptr) {
+
+        return;
+    }
+
+    TraceRecord &rec = records[next];
+    rec.atMillis = arrivedMillis - startMillis;
+    rec.durationMicros = durationMicros;
+    rec.freeHeap = freeHeap;
+    rec.method = method;
+    strncpy(rec.target, target.c_str(), sizeof(rec.target) - 1);
+    rec.target[sizeof(rec.target) - 1] = '\0';
+
+    next = (next + 1) % capacity;
+    if (count < capacity) {
+        count++;
+    }
+}
+
+size_t RequestTrace::getCount() {
+
+    return count;
+}
+
+/**
+ * Formats a record as a tab separated line of arrival millis, method,
+ * duration micros, free heap and target, oldest record first.
+ * 
+ * @param index The index of the record, 0 being the oldest as size_t.
+ * 
+ * @return Returns the formatted line as String.
+ */
+String RequestTrace::formatRecord(size_t index) {
+    if (index >= count) {
+
+        return "";
+    }
+
+    TraceRecord &rec = records[(next + capacity - count + index) % capacity];
+    char line[TRACE_TARGET_SIZE + 48];
+    snprintf(
+        line, 
+        sizeof(line), 
+        "%lu\t%c\t%lu\t%lu\t%s\n", 
+        (unsigned long)rec.atMillis, 
+        rec.method, 
+        (unsigned long)rec.durationMicros, 
+        (unsigned long)rec.freeHeap, 
+        rec.target
+    );
+
+    return String(line);
+}
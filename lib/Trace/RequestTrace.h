@@ -0,0 +1,55 @@
+#ifndef RequestTrace_h
+    #define RequestTrace_h
+
+    #include <new>
+    #include <Arduino.h>
+
+    #define TRACE_TARGET_SIZE 51
+    #define TRACE_DEFAULT_RECORDS 64
+    #define TRACE_MAX_RECORDS 128
+
+    /**
+     * The RequestTrace class records the web requests the device serves so
+     * that real world load can be replayed later (see tools/trace_replay.py).
+     * Each request is kept as a fixed size 64 byte record in a ring buffer,
+     * which only takes up RAM while a capture is running. Once the ring is
+     * full the oldest records are overwritten.
+     * 
+     * A record holds when the request arrived relative to the start of the
+     * capture, its method, how long it took to handle, the free heap after 
+     * it was handled and its target, being the URI and its args url encoded
+     * and cut short if needed. Only the values of args the firmware lists in
+     * TRACE_ARGS are recorded, any other arg is recorded by name only.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class RequestTrace {
+        private:
+            struct TraceRecord {
+                uint32_t       atMillis                            ;
+                uint32_t       durationMicros                      ;
+                uint32_t       freeHeap                            ;
+                char           method                              ; // G, P, H, U(PUT), A(PATCH), D or O
+                char           target       [TRACE_TARGET_SIZE]    ;
+            };
+
+            TraceRecord    *records        ;
+            size_t         capacity        ;
+            size_t         count           ;
+            size_t         next            ;
+            unsigned long  startMillis     ;
+
+        public:
+            RequestTrace();
+
+            bool start(size_t capacity);
+            void stop();
+            bool isCapturing();
+            void record(char method, const String &target, unsigned long arrivedMillis, uint32_t durationMicros, uint32_t freeHeap);
+
+            size_t getCount();
+            String formatRecord(size_t index);
+    };
+
+#endif
@@ -0,0 +1,202 @@
+/*
+    UdpControl - A class that serves an authenticated binary UDP protocol
+    for switching and dimming the lights from automation controllers.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "UdpControl.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+UdpControl::UdpControl() {
+    listening = false;
+    hasKey = false;
+    bootNonce = 0;
+    lastCounter = 0;
+    memset(response, 0, sizeof(response));
+    isReplyPending = false;
+    replyPort = 0;
+    commandCount = 0;
+    handleMicros = 0;
+}
+
+/**
+ * Sets the boot nonce commands must carry. Listening starts once a key
+ * is set.
+ * 
+ * @param bootNonce A random value picked at boot as uint32_t.
+ */
+void UdpControl::begin(uint32_t bootNonce) {
+    this->bootNonce = bootNonce;
+}
+
+/**
+ * Sets the control key packets are authenticated with. An empty key turns
+ * the protocol off.
+ * 
+ * @param key The control key as String.
+ */
+void UdpControl::setKey(const String &key) {
+    hasKey = !key.isEmpty();
+    if (hasKey) {
+        br_hmac_key_init(&keyContext, &br_sha256_vtable, key.c_str(), key.length());
+        if (!listening) {
+            listening = udp.begin(UDP_CONTROL_PORT);
+        }
+    } else if (listening) {
+        udp.stop();
+        listening = false;
+    }
+}
+
+/**
+ * Receives a request if there is one. A command returned must be carried
+ * out and then reply() called, which is also needed after UDP_CMD_NONE in
+ * case a request was refused.
+ * 
+ * @param arg Set to the command's argument as uint8_t&.
+ * 
+ * @return Returns the command to carry out, or UDP_CMD_NONE, as uint8_t.
+ */
+uint8_t UdpControl::handle(uint8_t &arg) {
+    arg = 0;
+    int size = listening ? udp.parsePacket() : 0;
+    if (size == 0) {
+
+        return UDP_CMD_NONE;
+    }
+    unsigned long start = micros();
+
+    /* Read And Authenticate */
+    uint8_t request[UDP_CONTROL_PACKET_SIZE];
+    int len = udp.read(request, sizeof(request));
+    if (
+        size != UDP_CONTROL_PACKET_SIZE
+        || len != UDP_CONTROL_PACKET_SIZE
+        || request[0] != 'L' 
+        || request[1] != 'C' 
+        || request[2] != UDP_CONTROL_VERSION 
+        || !verify(request)
+    ) {
+        // Not for us or not from a key holder so drop it
+        handleMicros += micros() - start;
+
+        return UDP_CMD_NONE;
+    }
+    uint8_t command = request[3];
+    uint32_t nonce = request[8] | (request[9] << 8) | (request[10] << 16) | ((uint32_t)request[11] << 24);
+    uint32_t counter = request[12] | (request[13] << 8) | (request[14] << 16) | ((uint32_t)request[15] << 24);
+
+    /* Decide What To Do */
+    uint8_t status = UDP_STATUS_OK;
+    if (command > UDP_CMD_STATUS || (command == UDP_CMD_LEVEL && (request[4] < 1 || request[4] > 100))) {
+        status = UDP_STATUS_BAD_COMMAND;
+        command = UDP_CMD_NONE;
+    } else if (command != UDP_CMD_HELLO && command != UDP_CMD_STATUS) {
+        if (nonce != bootNonce || counter <= lastCounter) {
+            // Replayed or sent before the controller caught up
+            status = UDP_STATUS_STALE;
+            command = UDP_CMD_NONE;
+        } else {
+            lastCounter = counter;
+            arg = request[4];
+        }
+    }
+
+    /* Prepare The Reply, Finished Once The Command Is Carried Out */
+    response[0] = 'L';
+    response[1] = 'C';
+    response[2] = UDP_CONTROL_VERSION;
+    response[3] = request[3] | 0x80;
+    response[4] = status;
+    response[7] = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        response[8 + i] = (bootNonce >> (8 * i)) & 0xFF;
+        response[12 + i] = (lastCounter >> (8 * i)) & 0xFF;
+    }
+    replyIp = udp.remoteIP();
+    replyPort = udp.remotePort();
+    isReplyPending = true;
+    commandCount++;
+    handleMicros += micros() - start;
+
+    return command;
+}
+
+/**
+ * Sends the reply to the last request, if one is owed, carrying the state
+ * of the lights after its command.
+ * 
+ * @param lightsOn Indicates the lights are on as bool.
+ * @param brightness The brightness in percent as uint8_t.
+ * @param timerOn Indicates the timer is on as bool.
+ */
+void UdpControl::reply(bool lightsOn, uint8_t brightness, bool timerOn) {
+    if (!isReplyPending) {
+
+        return;
+    }
+    unsigned long start = micros();
+    isReplyPending = false;
+    response[5] = (lightsOn ? 0x01 : 0x00) | (timerOn ? 0x02 : 0x00);
+    response[6] = brightness;
+    sign(response);
+    udp.beginPacket(replyIp, replyPort);
+    udp.write(response, sizeof(response));
+    udp.endPacket();
+    handleMicros += micros() - start;
+}
+
+uint32_t UdpControl::getCommandCount() {
+
+    return commandCount;
+}
+
+uint32_t UdpControl::getHandleMicros() {
+
+    return handleMicros;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Writes the MAC of a packet's first 16 bytes into the packet.
+ * 
+ * @param packet The packet to sign as uint8_t*.
+ */
+void UdpControl::sign(uint8_t *packet) {
+    uint8_t mac[32];
+    br_hmac_context context;
+    br_hmac_init(&context, &keyContext, 0);
+    br_hmac_update(&context, packet, UDP_CONTROL_SIGNED_SIZE);
+    br_hmac_out(&context, mac);
+    memcpy(packet + UDP_CONTROL_SIGNED_SIZE, mac, UDP_CONTROL_MAC_SIZE);
+}
+
+/**
+ * Checks a packet's MAC, taking the same time however much of it matches.
+ * 
+ * @param packet The packet to check as uint8_t*.
+ * 
+ * @return Returns true if the MAC is right otherwise false as bool.
+ */
+bool UdpControl::verify(const uint8_t *packet) {
+    uint8_t mac[32];
+    br_hmac_context context;
+    br_hmac_init(&context, &keyContext, 0);
+    br_hmac_update(&context, packet, UDP_CONTROL_SIGNED_SIZE);
+    br_hmac_out(&context, mac);
+    uint8_t diff = 0;
+    for (uint8_t i = 0; i < UDP_CONTROL_MAC_SIZE; i++) {
+        diff |= mac[i] ^ packet[UDP_CONTROL_SIGNED_SIZE + i];
+    }
+
+    return diff == 0;
+}
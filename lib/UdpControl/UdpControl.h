@@ -0,0 +1,88 @@
+#ifndef UdpControl_h
+    #define UdpControl_h
+
+    #include <Arduino.h>
+    #include <WiFiUdp.h>
+    #include <bearssl/bearssl.h>
+
+    #define UDP_CONTROL_PORT 42102
+    #define UDP_CONTROL_PACKET_SIZE 24
+    #define UDP_CONTROL_SIGNED_SIZE 16
+    #define UDP_CONTROL_MAC_SIZE 8
+    #define UDP_CONTROL_VERSION 1
+
+    #define UDP_CMD_NONE 0xFF
+    #define UDP_CMD_HELLO 0x00
+    #define UDP_CMD_POWER 0x01
+    #define UDP_CMD_LEVEL 0x02
+    #define UDP_CMD_TOGGLE 0x03
+    #define UDP_CMD_STATUS 0x04
+
+    #define UDP_STATUS_OK 0
+    #define UDP_STATUS_STALE 1
+    #define UDP_STATUS_BAD_COMMAND 2
+
+    /**
+     * The UdpControl class lets automation controllers, such as a PLC, switch
+     * and dim the lights with one small UDP packet and get the resulting
+     * state back in one small packet, rather than paying for HTTP.
+     * 
+     * Requests and responses are both 24 bytes (multi byte values little endian):
+     *   0  'L', 'C' magic
+     *   2  protocol version (1)
+     *   3  command, or'ed with 0x80 in a response
+     *   4  request: argument (POWER 0 or 1, LEVEL 1 to 100)
+     *      response: status (UDP_STATUS_*)
+     *   5  response: lights on (bit 0) and timer on (bit 1)
+     *   6  response: brightness in percent
+     *   7  reserved (0)
+     *   8  boot nonce as uint32
+     *   12 counter as uint32
+     *   16 first 8 bytes of HMAC-SHA256 of bytes 0 to 15, keyed with the
+     *      device's control key
+     * 
+     * Packets with a bad MAC are dropped without reply. To keep a captured
+     * packet from being replayed a command is only carried out if it has the
+     * device's current boot nonce and a counter above any accepted since boot.
+     * Otherwise the reply has the STALE status along with the current boot
+     * nonce and highest counter, so the controller can catch up and resend.
+     * HELLO and STATUS change nothing and so are answered whatever their 
+     * nonce and counter, which is how a controller learns them to start with.
+     * 
+     * Nothing is allocated while handling packets, the HMAC keys are set up
+     * once so each packet only costs a few SHA-256 blocks.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class UdpControl {
+        private:
+            WiFiUDP              udp                                        ;
+            bool                 listening                                  ;
+            bool                 hasKey                                     ;
+            br_hmac_key_context  keyContext                                 ;
+            uint32_t             bootNonce                                  ;
+            uint32_t             lastCounter                                ;
+            uint8_t              response     [UDP_CONTROL_PACKET_SIZE]     ;
+            bool                 isReplyPending                             ;
+            IPAddress            replyIp                                    ;
+            uint16_t             replyPort                                  ;
+            uint32_t             commandCount                               ;
+            uint32_t             handleMicros                               ;
+
+            void sign(uint8_t *packet);
+            bool verify(const uint8_t *packet);
+
+        public:
+            UdpControl();
+
+            void begin(uint32_t bootNonce);
+            void setKey(const String &key);
+            uint8_t handle(uint8_t &arg);
+            void reply(bool lightsOn, uint8_t brightness, bool timerOn);
+
+            uint32_t getCommandCount();
+            uint32_t getHandleMicros();
+    };
+
+#endif
@@ -0,0 +1,176 @@
+/*
+    UsageMeter - A class that counts on time, switch cycles and energy of
+    the lights, keeping them in RTC memory between the writes to flash.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include "UsageMeter.h"
+
+/**
+ * CLASS CONSTRUCTOR
+ */
+UsageMeter::UsageMeter() {
+    memset(&totals, 0, sizeof(totals));
+    memset(&flushed, 0, sizeof(flushed));
+    dutyRemainder = 0;
+    lastTickAt = 0;
+    lastFlushAt = 0;
+}
+
+/**
+ * Starts counting on from the totals last written to flash, or from the
+ * RTC copy if it counted on from those same totals.
+ *
+ * @param onSeconds The on seconds in flash as uint32_t.
+ * @param switchCycles The switch cycles in flash as uint32_t.
+ * @param fullOnSeconds The full on seconds in flash as uint32_t.
+ *
+ * @return Returns true if the RTC copy was used otherwise false as bool.
+ */
+bool UsageMeter::begin(uint32_t onSeconds, uint32_t switchCycles, uint32_t fullOnSeconds) {
+    totals.onSeconds = onSeconds;
+    totals.switchCycles = switchCycles;
+    totals.fullOnSeconds = fullOnSeconds;
+    flushed = totals;
+    dutyRemainder = 0;
+    lastTickAt = millis();
+    lastFlushAt = millis();
+
+    RtcRecord record;
+    bool isRestored = (
+        ESP.rtcUserMemoryRead(USAGE_RTC_BLOCK, (uint32_t *)&record, sizeof(record))
+        && record.magic == USAGE_RTC_MAGIC
+        && record.check == checksum(record)
+        && memcmp(&record.flushed, &flushed, sizeof(flushed)) == 0
+    );
+    if (isRestored) {
+        totals = record.totals;
+        dutyRemainder = record.dutyRemainder;
+    }
+    saveRtc();
+
+    return isRestored;
+}
+
+/**
+ * Counts the seconds gone by since last called. Should be called every
+ * time through the main loop.
+ *
+ * @param level The output level, 0 being off, as uint16_t.
+ *
+ * @return Returns true if the totals changed enough to be reported again
+ * otherwise false as bool.
+ */
+bool UsageMeter::handle(uint16_t level) {
+    if (millis() - lastTickAt < USAGE_TICK_MS) {
+
+        return false;
+    }
+
+    uint32_t reportedOn = totals.onSeconds / USAGE_REPORT_SECONDS;
+    uint32_t reportedFullOn = totals.fullOnSeconds / USAGE_REPORT_SECONDS;
+    while (millis() - lastTickAt >= USAGE_TICK_MS) {
+        // Catch up on any seconds the loop was held up for
+        lastTickAt += USAGE_TICK_MS;
+        if (level > 0) {
+            totals.onSeconds++;
+            dutyRemainder += level;
+            if (dutyRemainder >= USAGE_FULL_LEVEL) {
+                totals.fullOnSeconds++;
+                dutyRemainder -= USAGE_FULL_LEVEL;
+            }
+        }
+    }
+    if (level > 0) {
+        saveRtc();
+    }
+
+    return (
+        reportedOn != totals.onSeconds / USAGE_REPORT_SECONDS
+        || reportedFullOn != totals.fullOnSeconds / USAGE_REPORT_SECONDS
+    );
+}
+
+/**
+ * Counts the lights being switched on.
+ */
+void UsageMeter::countCycle() {
+    totals.switchCycles++;
+    saveRtc();
+}
+
+/**
+ * Determines if the totals should be written to flash, being that they
+ * have changed and have not been written for a while.
+ *
+ * @return Returns true if a write is due otherwise false as bool.
+ */
+bool UsageMeter::isFlushDue() {
+
+    return (
+        memcmp(&totals, &flushed, sizeof(totals)) != 0
+        && millis() - lastFlushAt >= USAGE_FLUSH_INTERVAL
+    );
+}
+
+/**
+ * Marks the current totals as written to flash.
+ */
+void UsageMeter::markFlushed() {
+    flushed = totals;
+    lastFlushAt = millis();
+    saveRtc();
+}
+
+uint32_t UsageMeter::getOnSeconds() {
+
+    return totals.onSeconds;
+}
+
+uint32_t UsageMeter::getSwitchCycles() {
+
+    return totals.switchCycles;
+}
+
+uint32_t UsageMeter::getFullOnSeconds() {
+
+    return totals.fullOnSeconds;
+}
+
+/*
+=================================================================
+Private Functions
+=================================================================
+*/
+
+/**
+ * Copies the totals into RTC memory.
+ */
+void UsageMeter::saveRtc() {
+    RtcRecord record;
+    record.magic = USAGE_RTC_MAGIC;
+    record.totals = totals;
+    record.flushed = flushed;
+    record.dutyRemainder = dutyRemainder;
+    record.check = checksum(record);
+    ESP.rtcUserMemoryWrite(USAGE_RTC_BLOCK, (uint32_t *)&record, sizeof(record));
+}
+
+/**
+ * Calculates the FNV-1a hash of an RTC record, leaving out its check.
+ *
+ * @param record The record to calculate the hash of as RtcRecord&.
+ *
+ * @return Returns the hash as uint32_t.
+ */
+uint32_t UsageMeter::checksum(const RtcRecord &record) {
+    const uint8_t *bytes = (const uint8_t *)&record;
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < offsetof(RtcRecord, check); i++) {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+
+    return hash;
+}
@@ -0,0 +1,77 @@
+#ifndef UsageMeter_h
+    #define UsageMeter_h
+
+    #include <Arduino.h>
+
+    #define USAGE_TICK_MS 1000UL
+    #define USAGE_FULL_LEVEL 1023 // <------------ Output level of full power, the dimmer's PWM range
+    #define USAGE_FLUSH_INTERVAL 3600000UL // <--- Changed totals written to flash no more often than (ms)
+    #define USAGE_REPORT_SECONDS 360UL // <------- Reported hours change in steps of a tenth
+    #define USAGE_RTC_BLOCK 32 // <--------------- RTC user memory block, clear of the 128 bytes OTA uses
+    #define USAGE_RTC_MAGIC 0x4C555347UL
+
+    /**
+     * The UsageMeter class keeps count of how the lights are used, for
+     * estimating LED lifetime and energy.
+     *
+     * Three totals are kept:
+     *   on seconds        Time the output has been on at all
+     *   switch cycles     Times the lights have been switched on
+     *   full on seconds   Time at full power that would use the same
+     *                     energy, each second on adding the fraction of
+     *                     full power the output was at. Multiplied by the
+     *                     fixture's wattage this gives its energy use.
+     *
+     * The totals are counted in RAM once a second and copied to RTC memory
+     * each time, which survives any restart short of losing power. Flash
+     * is only written when the totals have changed and USAGE_FLUSH_INTERVAL
+     * has passed since the last write, so at most an hour of use is lost
+     * with the power. Where they go in flash is up to the caller, who
+     * calls markFlushed() once they are written.
+     *
+     * On startup the RTC copy is only trusted if it was counting on from
+     * the totals now in flash, so a factory reset or a flash image from
+     * another device isn't overridden by stale RTC memory.
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class UsageMeter {
+        private:
+            struct Totals {
+                uint32_t       onSeconds        ;
+                uint32_t       switchCycles     ;
+                uint32_t       fullOnSeconds    ;
+            };
+
+            struct RtcRecord {
+                uint32_t       magic            ;
+                Totals         totals           ;
+                Totals         flushed          ;
+                uint32_t       dutyRemainder    ;
+                uint32_t       check            ;
+            };
+
+            Totals             totals           ;
+            Totals             flushed          ; // as last written to flash
+            uint32_t           dutyRemainder    ; // part of a full on second, in output levels
+            unsigned long      lastTickAt       ;
+            unsigned long      lastFlushAt      ;
+
+            void saveRtc();
+            static uint32_t checksum(const RtcRecord &record);
+
+        public:
+            UsageMeter();
+
+            bool begin(uint32_t onSeconds, uint32_t switchCycles, uint32_t fullOnSeconds);
+            bool handle(uint16_t level);
+            void countCycle();
+            bool isFlushDue();
+            void markFlushed();
+            uint32_t getOnSeconds();
+            uint32_t getSwitchCycles();
+            uint32_t getFullOnSeconds();
+    };
+
+#endif
@@ -6,6 +6,8 @@
     Date: .......... 04/10/2024
 */
 
+#include <ctype.h>
+
 #include "IpUtils.h"
 
 /**
@@ -14,23 +16,34 @@
  * 
  * @param ip The String IP Address in dot notation to convert.
  * 
- * @return Returns the converted IP Address as IPAddress.
+ * @return Returns the converted IP Address as IPAddress, or 0.0.0.0
+ * if the given String is not a valid IP Address.
  */
 IPAddress IpUtils::stringIPv4ToIPAddress(String ip) {
-    String oct[4];
+    int oct[4] = {0, 0, 0, 0};
 
     int curIndex = 0;
-    String temp = "";
     for (unsigned int i = 0; i < ip.length(); i++) {
-        if (ip.charAt(i) != '.') {
-            temp.concat(ip.charAt(i));
-        } else {
-            oct[curIndex] = String(temp);
-            temp = "";
+        char c = ip.charAt(i);
+        if (c == '.') {
             curIndex ++;
+            if (curIndex > 3) {
+                // Too many octets
+                
+                return IPAddress(0, 0, 0, 0);
+            }
+        } else if (isdigit(c) && oct[curIndex] <= 255) {
+            oct[curIndex] = (oct[curIndex] * 10) + (c - '0');
+        } else {
+            // Not a digit or octet too large
+
+            return IPAddress(0, 0, 0, 0);
         }
     }
-    oct[curIndex] = String(temp);
+    if (curIndex != 3 || oct[0] > 255 || oct[1] > 255 || oct[2] > 255 || oct[3] > 255) {
+
+        return IPAddress(0, 0, 0, 0);
+    }
 
-    return IPAddress(oct[0].toInt(), oct[1].toInt(), oct[2].toInt(), oct[3].toInt());
+    return IPAddress(oct[0], oct[1], oct[2], oct[3]);
 }
\ No newline at end of file
@@ -85,18 +85,31 @@ void Utils::signalIpAddress(int ledPin, String ipAddress, bool quick) {
  * 
  * @param time24 The 24hour String time in format "14:23".
  * 
- * @return Returns the 24hour int time.
+ * @return Returns the 24hour int time, or -1 if the given String
+ * is not a valid time.
  */
 int Utils::stringTimeToIntTime(String time24) {
   int sepIndex = time24.indexOf(":");
-  if (sepIndex != -1) {
-    int hours = time24.substring(0, sepIndex).toInt();
-    int mins = time24.substring(sepIndex + 1).toInt();
+  if (sepIndex < 1 || sepIndex > 2 || time24.length() != (unsigned int)(sepIndex + 3)) {
+    // Must be H:MM or HH:MM
 
-    return ((hours * 100) + mins);
+    return -1;
   }
+  for (unsigned int i = 0; i < time24.length(); i++) {
+    if ((int)i != sepIndex && !isdigit(time24.charAt(i))) {
 
-  return 0;
+      return -1;
+    }
+  }
+
+  int hours = time24.substring(0, sepIndex).toInt();
+  int mins = time24.substring(sepIndex + 1).toInt();
+  if (hours > 23 || mins > 59) {
+
+    return -1;
+  }
+
+  return ((hours * 100) + mins);
 }
 
 /**
@@ -149,6 +162,9 @@ String Utils::intTimeToStringTime(int time24) {
 int Utils::adjustIntTimeForTimezone(int time24, int timezone, bool isDst) {
   int mins = (time24 % 100);
   int hours = (time24 / 100) + timezone + (isDst ? 1 : 0);
+  
+  // Wrap around midnight in either direction
+  hours %= 24;
   if (hours < 0) {
     hours += 24;
   }
@@ -172,9 +188,12 @@ String Utils::intTimeToString12Time(int time24) {
   int m = time24 % 100;
   
   String ap = "AM";
+  if (h >= 12) {
+    // Noon hour is PM too
+    ap = "PM";
+  }
   if (h > 12) {
     h -= 12;
-    ap = "PM";
   } else if (h == 0) {
     h = 12;
   }
@@ -209,6 +228,89 @@ bool Utils::flipSafeHasTimeExpired(unsigned long startMillis, unsigned long expi
   return (((__LONG_MAX__ * 2UL + 1UL) - startMillis + now) >= expireInMillis);
 }
 
+/**
+ * HTML escapes the given string so it can be placed in page content or an
+ * attribute value without changing the page. The '$' is escaped as well so
+ * a value can never be mistaken for a template place-holder.
+ * 
+ * @param str The string to escape as String.
+ * 
+ * @return Returns the escaped string as String.
+ */
+String Utils::htmlEscape(String str) {
+  String result = "";
+  result.reserve(str.length());
+  for (unsigned int i = 0; i < str.length(); i++) {
+    char c = str.charAt(i);
+    switch (c) {
+      case '&': result.concat(F("&amp;")); break;
+      case '<': result.concat(F("&lt;")); break;
+      case '>': result.concat(F("&gt;")); break;
+      case '"': result.concat(F("&quot;")); break;
+      case '\'': result.concat(F("&#39;")); break;
+      case '$': result.concat(F("&#36;")); break;
+      default: result.concat(c); break;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * URL encodes the given string so it can be used as part of a query string.
+ * Letters, digits and "-_.~" are kept as is, everything else is %XX encoded.
+ * 
+ * @param str The string to encode as String.
+ * 
+ * @return Returns the encoded string as String.
+ */
+String Utils::urlEncode(String str) {
+  static const char hex[] = "0123456789ABCDEF";
+  String result = "";
+  result.reserve(str.length());
+  for (unsigned int i = 0; i < str.length(); i++) {
+    char c = str.charAt(i);
+    if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+      result.concat(c);
+    } else {
+      result.concat('%');
+      result.concat(hex[(c >> 4) & 0x0F]);
+      result.concat(hex[c & 0x0F]);
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Escapes the given string so it can be placed between quotes as a JSON
+ * string value. Control characters are \u00XX escaped.
+ * 
+ * @param str The string to escape as String.
+ * 
+ * @return Returns the escaped string as String.
+ */
+String Utils::jsonEscape(String str) {
+  static const char hex[] = "0123456789ABCDEF";
+  String result = "";
+  result.reserve(str.length());
+  for (unsigned int i = 0; i < str.length(); i++) {
+    char c = str.charAt(i);
+    if (c == '"' || c == '\\') {
+      result.concat('\\');
+      result.concat(c);
+    } else if ((uint8_t)c < 0x20) {
+      result.concat(F("\\u00"));
+      result.concat(hex[(c >> 4) & 0x0F]);
+      result.concat(hex[c & 0x0F]);
+    } else {
+      result.concat(c);
+    }
+  }
+
+  return result;
+}
+
 /**
  * Converts a given temperature in celcius to a farenheit value.
  * 
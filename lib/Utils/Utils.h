@@ -33,6 +33,9 @@
       static bool flipSafeHasTimeExpired(unsigned long startMillis, unsigned long expireInMillis);
       static int stringTimeToIntTime(String time24);
       static int adjustIntTimeForTimezone(int time24, int timezone, bool isDst);
+      static String urlEncode(String str);
+      static String htmlEscape(String str);
+      static String jsonEscape(String str);
   };
 
 #endif
\ No newline at end of file
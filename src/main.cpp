@@ -41,16 +41,64 @@
 #include <Settings.h>
 #include <IpUtils.h>
 #include <Utils.h>
+#include <EspFlashBackend.h>
+#include <OtaUpdater.h>
+#include <Discovery.h>
+#include <GroupControl.h>
+#include <DeviceClock.h>
+#include <SntpPeer.h>
+#include <LightTimer.h>
+#include <LightCalendar.h>
+#include <VacationPlanner.h>
+#include <DaySchedule.h>
+#include <RequestTrace.h>
+#include <PageTemplate.h>
+#include <Dimmer.h>
+#include <CircadianCurve.h>
+#include <LightSocket.h>
+#include <UdpControl.h>
+#include <CoapServer.h>
+#include <MqttLink.h>
+#include <UsageMeter.h>
+#include <EventLog.h>
+#include <AmbientSensor.h>
+#include <DebouncedInput.h>
+#include <Occupancy.h>
 #include <HtmlContent.h>
+#include <LittleFS.h>
 
 // =================================
 // Define Statements
 // =================================
 #define FIRMWARE_VERSION "1.1.2"
 
-#define LIGHT_PIN 5 // <----- D1
+#define LIGHT_PIN 5 // <----- D1, or warm white
+#define COOL_PIN 4 // <------ D2, cool white
 #define ON_OFF_PIN 14 // <--- D5 
 #define RESTORE_PIN 13 // <-- D7 
+#define AMBIENT_PIN A0 // <-- A0
+#define OCCUPANCY_PIN 12 // <- D6
+
+#define WEB_BACKLOG 1 // <---------------- Connections left waiting, what is left of lwIP's 5 TCP PCBs, see setup()
+#define WEB_PIPELINE_MAX 4 // <----------- Requests served back to back from one connection
+#define WEB_IDLE_TIMEOUT 2000UL // <------ Idle kept-alive connection dropped after (ms)
+#define WEB_IDLE_YIELD 100UL // <--------- Idle kept-alive connection dropped after when others wait (ms)
+#define BRIGHTNESS_SAVE_DELAY 5000UL // <- Brightness saved once left alone for (ms)
+#define BUTTON_DEBOUNCE_MS 30UL // <------ Button level must hold this long to count (ms)
+#define OCCUPANCY_DEBOUNCE_MS 100UL // <-- Occupancy level must hold this long to count (ms)
+
+#define CALENDAR_FILE "/calendar.bin"
+#define CALENDAR_TEMP "/calendar.tmp"
+#define CALENDAR_MAGIC 0x4C43414CUL
+
+#define USAGE_FILE "/usage.bin"
+#define USAGE_TEMP "/usage.tmp"
+#define USAGE_MAGIC 0x4C555346UL
+
+// Args whose values may be written to the request trace, credentials and the control key never are
+#define TRACE_ARGS ",do,t,md5,ssid,dst,timezone,onat,offat,group,mqtthost,mqttport," \
+  "vacation,vaconfrom,vaconto,vacofffrom,vacoffto,ambient,ambientthreshold,occupancy,occupancytimeout," \
+  "circadian,warmkelvin,coolkelvin,start,stop,count,before,kind,index,from,to,days,off,value,"
 
 // =================================
 // Function Prototypes
@@ -59,12 +107,65 @@ void initWiFiAPMode(void);
 void initWiFiSTAMode(void);
 void doCheckForFactoryReset(bool isPowerOn);
 void doDeviceTasks(void);
+void doWiFiTasks(void);
+void doWebTasks(void);
 void doTimerFunctions(void);
+void doGroupFunctions(void);
+void doChangeLightState(bool on, uint8_t source);
+void doChangeBrightness(uint8_t percent, uint8_t source);
+void doLightSocketFunctions(void);
+void doUdpControlFunctions(void);
+void doMqttFunctions(void);
+void doUsageFunctions(void);
+void doAmbientFunctions(void);
+void doOccupancyFunctions(void);
+void doCircadianFunctions(void);
+void doChangeTimerState(bool on, uint8_t source);
+void doChangeVacationState(bool on, uint8_t source);
+void doChangeSchedule(int onTime, int offTime);
+String doBuildStatusJson(void);
+const String &getDashboardEtag(void);
 void webHandleMainPage(void);
+void webHandleDashboard(void);
+void webHandleApiStatus(void);
+void webHandleApiCmd(void);
 void doHandleMainPage(String popupMessage);
+void doFillMainPage(void);
 void webHandleSettingsPage(void);
-void doHandleIncomingArgs(bool enabled);
-bool inOnZone(int time24);
+void webHandleClock(void);
+void webHandleTrace(void);
+void webHandleMetrics(void);
+void webHandleEvents(void);
+void webHandleCalendar(void);
+void webHandleCalendarCmd(void);
+void webHandleUpdatePage(void);
+void webHandleUpdateUpload(void);
+void webHandleUpdateDone(void);
+String doHandleIncomingArgs(bool enabled);
+void applyGroupSettings(void);
+void applyMqttSettings(void);
+void applyVacationSettings(void);
+void applyAmbientSettings(void);
+void applyOccupancySettings(void);
+void applyCircadianSettings(void);
+void loadUsage(void);
+bool saveUsage(void);
+void loadCalendar(void);
+bool saveCalendar(void);
+long getLocalEpochDay(void);
+int getLocalTime24(void);
+bool isAmbientLight(void);
+void logEvent(uint8_t source, uint8_t kind, uint8_t from, uint8_t to);
+void bumpStateVersion(void);
+uint8_t getClockSyncMode(void);
+size_t coapGetLight(char *buffer, size_t size);
+uint8_t coapPutLight(const char *payload, size_t length);
+size_t coapGetTimer(char *buffer, size_t size);
+uint8_t coapPutTimer(const char *payload, size_t length);
+size_t coapGetStatus(char *buffer, size_t size);
+const String &getStatusJson(void);
+ESP8266WebServer::THandlerFunction traced(ESP8266WebServer::THandlerFunction handler);
+bool isTraceableArg(const String &name);
 
 // =================================
 // Setup of Services
@@ -74,12 +175,72 @@ ESP8266WebServer web(80);
 DNSServer dns;
 WiFiUDP ntpUdp;
 NTPClient ntpClient(ntpUdp, "pool.ntp.org"); 
+EspFlashBackend flashBackend;
+OtaUpdater ota(flashBackend);
+Discovery discovery;
+GroupControl groupControl;
+DeviceClock deviceClock;
+SntpPeer sntpPeer(deviceClock);
+LightTimer lightTimer;
+LightCalendar lightCalendar;
+VacationPlanner vacationPlanner;
+DaySchedule daySchedule(lightTimer, lightCalendar, vacationPlanner);
+RequestTrace requestTrace;
+PageTemplate mainPage(MAIN_PAGE);
+Dimmer dimmer;
+CircadianCurve circadianCurve;
+LightSocket lightSocket;
+UdpControl udpControl;
+CoapServer coapServer;
+MqttLink mqttLink;
+UsageMeter usageMeter;
+EventLog eventLog;
+AmbientSensor ambientSensor;
+DebouncedInput button;
+DebouncedInput occupancySensor;
+Occupancy occupancy;
 
 // =================================
 // Worker Vars
 // =================================
 String deviceId = "";
+uint32_t bootNonce = 0;
 bool isSTAConnected = false;
+bool isSTAConnecting = false;
+bool isNtpStarted = false;
+unsigned long staConnectStart = 0UL;
+
+// WiFi reconfiguration is deferred so the triggering response gets sent first
+bool isApReconfigPending = false;
+bool isStaReconfigPending = false;
+unsigned long reconfigRequestedAt = 0UL;
+
+// Restart is deferred so the triggering response gets sent first
+bool isRestartPending = false;
+unsigned long restartRequestedAt = 0UL;
+bool isOtaAuthorized = false;
+
+// Brightness is saved lazily so dragging the slider doesn't wear the flash
+bool isBrightnessSavePending = false;
+unsigned long brightnessChangedAt = 0UL;
+
+// Connections are kept alive while idle, until timed out or others are waiting
+bool isWebClientIdle = false;
+unsigned long webClientIdleSince = 0UL;
+
+// Values set on the main page are valid while their version matches the state version
+uint32_t stateVersion = 1;
+uint32_t cachedPageVersion = 0;
+uint32_t renderCacheHits = 0;
+uint32_t renderCacheMisses = 0;
+String statusJson = "";
+uint32_t statusJsonVersion = 0;
+uint32_t coapNotifiedVersion = 0;
+String dashboardEtag = "";
+int lastClockMinute = -1;
+uint8_t lastClockSync = 0;
+int circadianMinute = -1;
+uint8_t circadianPercent = 100;
 
 /**
  * =================================
@@ -96,7 +257,8 @@ void setup() {
   // Initialize Pins
   pinMode(LIGHT_PIN, OUTPUT);
   pinMode(RESTORE_PIN, INPUT);
-  pinMode(ON_OFF_PIN, INPUT);
+  button.begin(ON_OFF_PIN, BUTTON_DEBOUNCE_MS);
+  occupancySensor.begin(OCCUPANCY_PIN, OCCUPANCY_DEBOUNCE_MS);
 
   // Initialize Serial
   Serial.begin(74880);
@@ -107,14 +269,23 @@ void setup() {
   settings.loadSettings();
 
   // Initialize Lights on/off status
-  if (settings.isLightsOn()) {
-    digitalWrite(LIGHT_PIN, HIGH);
-  } else {
-    digitalWrite(LIGHT_PIN, LOW);
-  }
+  dimmer.begin(LIGHT_PIN, COOL_PIN, settings.isLightsOn() ? settings.getBrightness() : 0);
+  applyCircadianSettings();
+
+  // Load event history and note what the lights were restored to
+  eventLog.begin();
+  logEvent(EVENT_SOURCE_BOOT, EVENT_KIND_BOOT, ESP.getResetInfoPtr()->reason, settings.isLightsOn());
+  loadUsage();
+  loadCalendar();
+  vacationPlanner.setSeed(ESP.getChipId());
+  applyVacationSettings();
+  ambientSensor.begin(AMBIENT_PIN);
+  applyAmbientSettings();
+  applyOccupancySettings();
 
   // Determine Device ID
   deviceId = Utils::genDeviceIdFromMacAddr(WiFi.macAddress()).c_str();
+  bootNonce = ESP.random();
   
   // Initialize Networking
   WiFi.setOutputPower(20.5F);
@@ -125,12 +296,51 @@ void setup() {
   initWiFiAPMode();
   initWiFiSTAMode();
 
+  // Prepare group control, joined once STA is connected
+  groupControl.begin(deviceId, (uint16_t)bootNonce);
+  applyGroupSettings();
+
+  // Prepare UDP control, only listening if there is a key
+  udpControl.begin(bootNonce);
+  udpControl.setKey(settings.getControlKey());
+
+  // Prepare MQTT, only connecting if there is a broker
+  mqttLink.begin(deviceId, FIRMWARE_VERSION);
+  applyMqttSettings();
+
   // Set page handlers for Web Server
-  web.on(F("/"), webHandleMainPage);
-  web.on(F("/admin"), webHandleSettingsPage);
-  web.onNotFound(webHandleMainPage);
+  web.on(F("/"), HTTP_GET, traced(webHandleDashboard));
+  web.on(F("/"), HTTP_POST, traced(webHandleMainPage));
+  web.on(F("/classic"), traced(webHandleMainPage));
+  web.on(F("/api/status"), HTTP_GET, traced(webHandleApiStatus));
+  web.on(F("/api/cmd"), HTTP_POST, traced(webHandleApiCmd));
+  web.on(F("/admin"), traced(webHandleSettingsPage));
+  web.on(F("/clock"), HTTP_POST, traced(webHandleClock));
+  web.on(F("/update"), HTTP_GET, traced(webHandleUpdatePage));
+  web.on(F("/update"), HTTP_POST, webHandleUpdateDone, webHandleUpdateUpload);
+  web.on(F("/trace"), webHandleTrace);
+  web.on(F("/metrics"), HTTP_GET, webHandleMetrics);
+  web.on(F("/api/events"), HTTP_GET, traced(webHandleEvents));
+  web.on(F("/api/calendar"), HTTP_GET, traced(webHandleCalendar));
+  web.on(F("/api/calendar"), HTTP_POST, traced(webHandleCalendarCmd));
+  web.onNotFound(traced(webHandleMainPage));
 
+  const char *headerKeys[] = { "If-None-Match" };
+  web.collectHeaders(headerKeys, 1);
+  web.keepAlive(true);
   web.begin();
+  // lwIP has 5 TCP PCBs: 1 for MQTT, 2 for light socket clients, 1 for the
+  // web connection being served and what is left for those waiting on it
+  web.getServer().begin(80, WEB_BACKLOG);
+  lightSocket.begin();
+
+  // Set resources for CoAP Server
+  coapServer.on("/light", coapGetLight, coapPutLight);
+  coapServer.on("/timer", coapGetTimer, coapPutTimer);
+  coapServer.on("/status", coapGetStatus);
+  coapServer.begin();
+  discovery.begin(deviceId, FIRMWARE_VERSION);
+  sntpPeer.begin();
 }
 
 /**
@@ -143,9 +353,13 @@ void setup() {
  * perform during its normal operation.
  */
 void loop() {
-  web.handleClient();
+  doWebTasks();
+  lightSocket.handle();
+  coapServer.handle();
   dns.processNextRequest();
+  doWiFiTasks();
   doDeviceTasks();
+  discovery.handle();
 
   yield();
 }
@@ -184,10 +398,14 @@ void initWiFiAPMode() {
 /**
  * INIT FUNCTION 
  * Initialize the WiFi for STA Mode so it can connect to
- * a WiFi network if configured to do so.
+ * a WiFi network if configured to do so. The connection is
+ * only started here, its outcome is tracked by doWiFiTasks()
+ * so the rest of the device keeps running while it connects.
  * 
  */
 void initWiFiSTAMode() {
+  isSTAConnected = false;
+  isSTAConnecting = false;
   if (
     !settings.getSsid().equals(settings.getDefaultSsid()) 
     && !settings.getPwd().equals(settings.getDefaultPwd())
@@ -195,22 +413,9 @@ void initWiFiSTAMode() {
     Serial.println(F("Attempting to connect to WiFi..."));
     WiFi.setAutoReconnect(true);
     WiFi.begin(settings.getSsid(), settings.getPwd());
-    unsigned long start = millis();
-    while (WiFi.status() != WL_CONNECTED && !Utils::flipSafeHasTimeExpired(start, 15000UL)) {
-      yield();
-    }
-
-    Serial.printf("WiFi connection was %s!\n", WiFi.status() == WL_CONNECTED ? "successful" : "failure");
-
-    if (WiFi.status() == WL_CONNECTED) {
-      // Connected
-      isSTAConnected = true;
-      ntpClient.begin();
-      
-      return;
-    }
+    staConnectStart = millis();
+    isSTAConnecting = true;
   }
-  isSTAConnected = false;
 }
 
 // ===============================================================
@@ -225,26 +430,135 @@ void initWiFiSTAMode() {
  */
 void doDeviceTasks() {
   doCheckForFactoryReset(false);
+  doGroupFunctions();
+  doUdpControlFunctions();
+
+  // Restart into new firmware once the response has gone out
+  if (isRestartPending && Utils::flipSafeHasTimeExpired(restartRequestedAt, 2000UL)) {
+    eventLog.flush();
+    ESP.restart();
+  }
+
   doTimerFunctions();
+  doAmbientFunctions();
   
-  // Toggle light state based on button press
-  if (digitalRead(ON_OFF_PIN) == HIGH) {
-    settings.setLightsOn(!settings.isLightsOn());
-    settings.saveSettings();
+  // Toggle light state as the button is pressed, holding it does nothing more
+  if (button.handle() == INPUT_EDGE_RISE) {
+    doChangeLightState(!settings.isLightsOn(), EVENT_SOURCE_BUTTON);
   }
+  doOccupancyFunctions();
+
+  doLightSocketFunctions();
+  doMqttFunctions();
 
-  // Set light to appropriate state
-  if (settings.isLightsOn() &&  digitalRead(LIGHT_PIN) == LOW) {
-    // Is Off but should be On
-    digitalWrite(LIGHT_PIN, HIGH);
-  } else if (!settings.isLightsOn() && digitalRead(LIGHT_PIN) == HIGH) {
-    // Is On but should be Off
-    digitalWrite(LIGHT_PIN, LOW);
+  // Fade light to appropriate state and shade of white
+  doCircadianFunctions();
+  uint8_t percent = max((settings.getBrightness() * circadianPercent) / 100, 1);
+  dimmer.setTarget(settings.isLightsOn() ? percent : 0);
+  dimmer.handle();
+  doUsageFunctions();
+  eventLog.handle();
+
+  // Push changes out to CoAP observers
+  if (coapNotifiedVersion != stateVersion) {
+    coapServer.notifyChanged();
+    coapNotifiedVersion = stateVersion;
   }
 
-  // Prevent multi-react to single long press
-  while (digitalRead(ON_OFF_PIN) == HIGH) {
-    yield();
+  // Keep the discovery reply describing the current state
+  discovery.setState(settings.isLightsOn(), settings.isTimerOn(), isSTAConnected ? WiFi.localIP() : WiFi.softAPIP());
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function looks after the WiFi interfaces during runtime.
+ * It tracks the outcome of STA connection attempts without blocking and
+ * applies any pending AP or STA reconfiguration once the response that
+ * requested it has had time to be sent. Only the affected interface is
+ * torn down, so the web server, lights and timer keep running.
+ * 
+ */
+void doWiFiTasks() {
+  bool wasSTAConnected = isSTAConnected;
+
+  /* Apply Pending Reconfiguration */
+  if ((isApReconfigPending || isStaReconfigPending) && Utils::flipSafeHasTimeExpired(reconfigRequestedAt, 500UL)) {
+    if (isApReconfigPending) {
+      // Restarting the soft AP with new credentials drops its clients
+      Serial.println(F("Reconfiguring WiFi AP..."));
+      if (!WiFi.softAP(settings.getApSsid(deviceId), settings.getApPwd())) {
+        Serial.println(F("Something went wrong; Unable to reconfigure AP!"));
+      }
+      isApReconfigPending = false;
+    }
+    if (isStaReconfigPending) {
+      Serial.println(F("Reconfiguring WiFi STA..."));
+      WiFi.disconnect();
+      initWiFiSTAMode();
+      isStaReconfigPending = false;
+    }
+  }
+
+  /* Track STA Connection */
+  if (isSTAConnecting) {
+    if (WiFi.status() == WL_CONNECTED) {
+      // Connected
+      isSTAConnecting = false;
+      isSTAConnected = true;
+      Serial.println(F("WiFi connection was successful!"));
+      if (!isNtpStarted) {
+        ntpClient.begin();
+        isNtpStarted = true;
+      }
+    } else if (Utils::flipSafeHasTimeExpired(staConnectStart, 15000UL)) {
+      // Gave up waiting, auto reconnect keeps trying in the background
+      isSTAConnecting = false;
+      Serial.println(F("WiFi connection was failure!"));
+    }
+  } else if (!settings.getSsid().equals(settings.getDefaultSsid())) {
+    // Follow drops and auto reconnects of an established connection
+    isSTAConnected = WiFi.status() == WL_CONNECTED;
+    if (isSTAConnected && !isNtpStarted) {
+      ntpClient.begin();
+      isNtpStarted = true;
+    }
+  }
+  // Keep the group membership on the current STA address
+  groupControl.setInterface(isSTAConnected, WiFi.localIP());
+
+  if (wasSTAConnected != isSTAConnected) {
+    // Main page shows the connection
+    bumpStateVersion();
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function serves the web clients. Connections are kept alive
+ * so a page and what it fetches after share one TCP handshake, and requests
+ * pipelined behind the current one are served right away. As only one
+ * connection is served at a time an idle one is dropped after a while, or
+ * almost at once should other clients be waiting their turn.
+ * 
+ */
+void doWebTasks() {
+  /* Serve The Current Request And Any Pipelined Behind It */
+  web.handleClient();
+  for (uint8_t i = 1; i < WEB_PIPELINE_MAX && web.client().available() > 0; i++) {
+    web.handleClient();
+  }
+
+  /* Drop Idle Kept-Alive Connection */
+  WiFiClient &client = web.client();
+  if (!client.connected() || client.available() > 0) {
+    // No connection or it has a request coming
+    isWebClientIdle = false;
+  } else if (!isWebClientIdle) {
+    isWebClientIdle = true;
+    webClientIdleSince = millis();
+  } else if (Utils::flipSafeHasTimeExpired(webClientIdleSince, web.getServer().hasClient() ? WEB_IDLE_YIELD : WEB_IDLE_TIMEOUT)) {
+    client.stop();
+    isWebClientIdle = false;
   }
 }
 
@@ -285,10 +599,19 @@ void doCheckForFactoryReset(bool isPowerOn) {
     /* Handle Factory Reset and Reboot */
     if (doReset) {
       Serial.printf("Factory Reset %s!", (settings.factoryDefault() ? "Successful" : "Failed"));
+      if (LittleFS.begin()) {
+        // Usage totals and the calendar go along with the settings
+        LittleFS.remove(USAGE_FILE);
+        LittleFS.remove(CALENDAR_FILE);
+      }
       if (!isPowerOn) {
         // Reboot is needed
+        eventLog.flush();
         ESP.restart();
-      } 
+      } else {
+        // Carrying on, so drop any rules already loaded
+        lightCalendar.clear();
+      }
     }
   }
 }
@@ -297,42 +620,347 @@ void doCheckForFactoryReset(bool isPowerOn) {
  * ACTION FUNCTION
  * This action function performs the processes related to 
  * the functionality of the timer function. The timer capabilities
- * of the firmware all reside here.
+ * of the firmware all reside here, including keeping the device clock
+ * set from NTP or, failing that, from peer devices over SNTP.
  * 
  */
 void doTimerFunctions() {
+  deviceClock.update();
   if (isSTAConnected) {
     // On a network so NTP Possible
-    ntpClient.update();
+    if (ntpClient.update() && ntpClient.isTimeSet()) {
+      // Internet time beats any other source, NTPClient only gives whole seconds so take mid-second
+      deviceClock.setTime(ntpClient.getEpochTime(), 500, CLOCK_SOURCE_NTP, 2, true);
+    }
+  }
+
+  // Serve the time to peers, or get it from them when NTP is out of reach
+  bool seekPeers = isSTAConnected && (
+    deviceClock.getSource() != CLOCK_SOURCE_NTP 
+    || deviceClock.getAgeMillis() > 7200000UL
+  );
+  sntpPeer.handle(seekPeers, WiFi.localIP(), WiFi.broadcastIP());
 
-    if (settings.isTimerOn() && ntpClient.isTimeSet()) {
-      // Timer is turned on and we can know the time
-      int time24 = (ntpClient.getHours() * 100) + ntpClient.getMinutes();
-      time24 = Utils::adjustIntTimeForTimezone(time24, settings.getTimeZone(), settings.isDst());
+  // Main page shows the time to the minute and asks for the time as needed
+  int clockMinute = deviceClock.isSet() ? deviceClock.getMinutes() : -1;
+  uint8_t clockSync = getClockSyncMode();
+  if (clockMinute != lastClockMinute || clockSync != lastClockSync) {
+    lastClockMinute = clockMinute;
+    lastClockSync = clockSync;
+    bumpStateVersion();
+  }
 
-      // Determine what on/off zone we are in
-      bool curInOnZone = inOnZone(time24);
-    
-      // Perform on/off change if applicable
-      static int timerLastUpdate = -1;
-      if (timerLastUpdate == -1 || inOnZone(timerLastUpdate) != curInOnZone) {
-        // Perform an update
-        if (curInOnZone) {
-          if (!settings.isLightsOn()) { 
-            // Light off and needs set to on
-            settings.setLightsOn(true);
-            settings.saveSettings();
-          }
-        } else {
-          if (settings.isLightsOn()) {
-            // Light on and needs set to off
-            settings.setLightsOn(false);
-            settings.saveSettings();
-          }
-        }
-        timerLastUpdate = time24;
+  if (
+    deviceClock.isSet() 
+    && daySchedule.resolve(getLocalEpochDay(), settings.getOnTime(), settings.getOffTime(), settings.isVacationOn())
+  ) {
+    // New day, or the schedule or calendar changed, so today's schedule was worked out again
+    bumpStateVersion();
+  }
+
+  // Perform on/off change if the time crossed into another zone, -1 while the time can't be known
+  int time24 = deviceClock.isSet() ? getLocalTime24() : -1;
+  switch (daySchedule.evaluate(time24, settings.isTimerOn(), settings.isVacationOn(), isAmbientLight())) {
+    case TIMER_ACTION_ON:
+      doChangeLightState(true, EVENT_SOURCE_TIMER);
+      break;
+    case TIMER_ACTION_OFF:
+      doChangeLightState(false, EVENT_SOURCE_TIMER);
+      break;
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function performs the processes related to the group
+ * control functionality. It finishes sending commands to the group and
+ * acts on commands sent to the group by other devices.
+ * 
+ */
+void doGroupFunctions() {
+  switch (groupControl.handle()) {
+    case GROUP_CMD_ON:
+      doChangeLightState(true, EVENT_SOURCE_GROUP);
+      break;
+    case GROUP_CMD_OFF:
+      doChangeLightState(false, EVENT_SOURCE_GROUP);
+      break;
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function performs the processes related to UDP control. It
+ * carries out commands from automation controllers and answers them with
+ * the resulting state of the lights.
+ * 
+ */
+void doUdpControlFunctions() {
+  uint8_t arg;
+  switch (udpControl.handle(arg)) {
+    case UDP_CMD_POWER:
+      doChangeLightState(arg != 0, EVENT_SOURCE_UDP);
+      break;
+    case UDP_CMD_LEVEL:
+      doChangeBrightness(arg, EVENT_SOURCE_UDP);
+      break;
+    case UDP_CMD_TOGGLE:
+      doChangeLightState(!settings.isLightsOn(), EVENT_SOURCE_UDP);
+      break;
+  }
+  udpControl.reply(settings.isLightsOn(), settings.getBrightness(), settings.isTimerOn());
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function performs the processes related to MQTT. It keeps
+ * the broker connection up, acts on commands from Home Assistant and keeps
+ * the state published to it current.
+ * 
+ */
+void doMqttFunctions() {
+  bool on;
+  uint8_t percent;
+  mqttLink.handle(isSTAConnected);
+  if (mqttLink.takeLevel(percent)) {
+    doChangeBrightness(percent, EVENT_SOURCE_MQTT);
+  }
+  if (mqttLink.takePower(on)) {
+    doChangeLightState(on, EVENT_SOURCE_MQTT);
+  }
+  if (mqttLink.takeTimer(on)) {
+    doChangeTimerState(on, EVENT_SOURCE_MQTT);
+  }
+
+  mqttLink.setState(settings.isLightsOn(), settings.getBrightness(), settings.isTimerOn());
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function counts the usage of the lights from their actual
+ * output, so fades are counted as they happen. The totals are written to
+ * flash once they have gone unsaved for a while.
+ * 
+ */
+void doUsageFunctions() {
+  if (usageMeter.handle(dimmer.getLevel())) {
+    // Status shows the totals
+    bumpStateVersion();
+  }
+  if (usageMeter.isFlushDue() && saveUsage()) {
+    usageMeter.markFlushed();
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function performs the processes related to the ambient
+ * light sensor, when turned on. While the timer has the lights in their
+ * on time they are switched on as it gets dark and off as it gets light,
+ * and are left alone otherwise so manual changes stick.
+ * 
+ */
+void doAmbientFunctions() {
+  if (!settings.isAmbientOn() || !ambientSensor.handle()) {
+
+    return;
+  }
+  bumpStateVersion();
+
+  bool isTimerRunning = (settings.isTimerOn() || settings.isVacationOn()) && deviceClock.isSet();
+  if (isTimerRunning && lightTimer.inOnZone(getLocalTime24())) {
+    doChangeLightState(ambientSensor.isDark(), EVENT_SOURCE_AMBIENT);
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function performs the processes related to the occupancy
+ * input, when turned on. The lights are switched on as the room becomes
+ * occupied, unless the ambient light sensor finds it light out, and off
+ * once it has been empty for the timeout. Lights switched by anything
+ * else are left alone, see doChangeLightState().
+ * 
+ */
+void doOccupancyFunctions() {
+  if (!settings.isOccupancyOn()) {
+
+    return;
+  }
+
+  switch (occupancySensor.handle()) {
+    case INPUT_EDGE_RISE:
+      // No need for the lights if they are on already or it is light out
+      if (occupancy.occupied(settings.isLightsOn() || isAmbientLight()) == OCCUPANCY_ACTION_ON) {
+        doChangeLightState(true, EVENT_SOURCE_MOTION);
       }
+      bumpStateVersion();
+      break;
+    case INPUT_EDGE_FALL:
+      occupancy.vacant();
+      bumpStateVersion();
+      break;
+  }
+
+  if (occupancy.handle() == OCCUPANCY_ACTION_OFF) {
+    doChangeLightState(false, EVENT_SOURCE_MOTION);
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function performs the processes related to tunable white,
+ * when turned on. Once a minute the shade of white and the brightness for
+ * the time of day are looked up, the brightness scaling the one asked
+ * for. The dimmer fades to them, so the minute steps don't show.
+ * 
+ */
+void doCircadianFunctions() {
+  if (!settings.isCircadianOn() || !deviceClock.isSet()) {
+    // All warm, at the brightness asked for
+    circadianMinute = -1;
+    circadianPercent = 100;
+    dimmer.setMix(0);
+
+    return;
+  }
+
+  int time24 = getLocalTime24();
+  int minute = ((time24 / 100) * 60) + (time24 % 100);
+  if (minute != circadianMinute) {
+    circadianMinute = minute;
+    circadianPercent = circadianCurve.getPercent(minute);
+    dimmer.setMix(circadianCurve.getMix(minute));
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function changes the on/off state of the lights, saving
+ * the change so it is remembered across power loss. Nothing is done if
+ * the lights are already in the requested state.
+ * 
+ * @param on Indicates the lights should be on if true as bool.
+ * @param source What made the change, an EVENT_SOURCE as uint8_t.
+ */
+void doChangeLightState(bool on, uint8_t source) {
+  if (source != EVENT_SOURCE_MOTION) {
+    // Whatever switched the lights now has them, so they aren't timed out
+    occupancy.release();
+  }
+  if (settings.isLightsOn() != on) {
+    logEvent(source, EVENT_KIND_LIGHT, settings.isLightsOn(), on);
+    settings.setLightsOn(on);
+    if (on) {
+      usageMeter.countCycle();
     }
+    settings.saveSettings();
+    bumpStateVersion();
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function changes the brightness of the lights, turning them
+ * on if they are off. As the brightness changes many times a second while
+ * a slider is dragged it is only saved once left alone for a while, see
+ * doLightSocketFunctions().
+ * 
+ * @param percent The brightness from 1 to 100 as uint8_t.
+ * @param source What made the change, an EVENT_SOURCE as uint8_t.
+ */
+void doChangeBrightness(uint8_t percent, uint8_t source) {
+  if (settings.getBrightness() != percent) {
+    logEvent(source, EVENT_KIND_LEVEL, settings.getBrightness(), percent);
+    settings.setBrightness(percent);
+    isBrightnessSavePending = true;
+    brightnessChangedAt = millis();
+    bumpStateVersion();
+  }
+  if (!settings.isLightsOn()) {
+    // Saves the brightness along with it
+    doChangeLightState(true, source);
+    isBrightnessSavePending = false;
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function performs the processes related to the light
+ * socket. It acts on the latest commands from its clients, saves the
+ * brightness once it has been left alone and keeps the state pushed to
+ * the clients current.
+ * 
+ */
+void doLightSocketFunctions() {
+  bool on;
+  uint8_t percent;
+  if (lightSocket.takeLevel(percent)) {
+    doChangeBrightness(percent, EVENT_SOURCE_SOCKET);
+  }
+  if (lightSocket.takePower(on)) {
+    doChangeLightState(on, EVENT_SOURCE_SOCKET);
+  }
+
+  if (isBrightnessSavePending && Utils::flipSafeHasTimeExpired(brightnessChangedAt, BRIGHTNESS_SAVE_DELAY)) {
+    // Slider left alone so save where it ended up
+    settings.saveSettings();
+    isBrightnessSavePending = false;
+  }
+
+  lightSocket.setState(settings.isLightsOn(), settings.getBrightness(), settings.isTimerOn());
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function enables or disables the timer, saving the change.
+ * Nothing is done if the timer is already in the requested state.
+ * 
+ * @param on Indicates the timer should be enabled if true as bool.
+ * @param source What made the change, an EVENT_SOURCE as uint8_t.
+ */
+void doChangeTimerState(bool on, uint8_t source) {
+  if (settings.isTimerOn() != on) {
+    logEvent(source, EVENT_KIND_TIMER, settings.isTimerOn(), on);
+    settings.setTimerOn(on);
+    settings.saveSettings();
+    bumpStateVersion();
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function turns vacation mode on or off, saving the change.
+ * While on the lights follow a schedule made up each day within the
+ * vacation bounds, whether or not the timer is enabled.
+ * 
+ * @param on Indicates vacation mode should be turned on if true as bool.
+ * @param source What made the change, an EVENT_SOURCE as uint8_t.
+ */
+void doChangeVacationState(bool on, uint8_t source) {
+  if (settings.isVacationOn() != on) {
+    logEvent(source, EVENT_KIND_VACATION, settings.isVacationOn(), on);
+    settings.setVacationOn(on);
+    settings.saveSettings();
+    daySchedule.invalidate();
+    bumpStateVersion();
+  }
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function changes the timer's schedule, saving the change.
+ * 
+ * @param onTime The 24hour time to switch on at as int.
+ * @param offTime The 24hour time to switch off at as int.
+ */
+void doChangeSchedule(int onTime, int offTime) {
+  if (settings.getOnTime() != onTime || settings.getOffTime() != offTime) {
+    settings.setOnTime(onTime);
+    settings.setOffTime(offTime);
+    settings.saveSettings();
+    daySchedule.invalidate();
+    bumpStateVersion();
   }
 }
 
@@ -346,46 +974,168 @@ void doTimerFunctions() {
  * the page finishes loading as String.
  */
 void doHandleMainPage(String popupMessage) {
-  doHandleIncomingArgs(popupMessage.isEmpty());
-  
-  // Generate Main Page
-  String content = MAIN_PAGE;
-  content.replace(F("${version}"), FIRMWARE_VERSION);
-  content.replace(F("${wifi_addr}"), !WiFi.isConnected() ? F("N/A") : WiFi.localIP().toString());
-  content.replace(F("${ssid}"), !WiFi.isConnected() ? F("Not Connected") : WiFi.SSID());
+  String argsMessage = doHandleIncomingArgs(popupMessage.isEmpty());
   if (popupMessage.isEmpty()) {
-    // No popup message to send
-    content.replace(F("${status_message}"), "");
+    popupMessage = argsMessage;
+  }
+
+  if (cachedPageVersion == stateVersion) {
+    // Nothing shown on the page has changed since it was last filled in
+    renderCacheHits++;
   } else {
+    renderCacheMisses++;
+    doFillMainPage();
+    cachedPageVersion = stateVersion;
+  }
+
+  if (!popupMessage.isEmpty()) {
     // Message found so create a popup for it
     String popup = STATUS_MESSAGE;
     popup.replace(F("${message}"), popupMessage);
-    content.replace(F("${status_message}"), popup);
+    mainPage.set(F("status_message"), popup);
   }
-  content.replace(F("${toggle_hidden}"), ntpClient.isTimeSet() ? F("") : F("hidden"));
-  content.replace(F("${on_off_status}"), settings.isLightsOn() ? F("On") : F("Off"));
-  if (ntpClient.isTimeSet()) {
+  
+  // Send Main Page
+  mainPage.send(web, 200, F("text/html"));
+  mainPage.set(F("status_message"), "");
+  yield();
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function fills in the values shown on the main page from
+ * the current state of the device. The page is left without a popup.
+ * 
+ */
+void doFillMainPage() {
+  mainPage.set(F("version"), FIRMWARE_VERSION);
+  mainPage.set(F("wifi_addr"), !WiFi.isConnected() ? F("N/A") : WiFi.localIP().toString());
+  mainPage.set(F("ssid"), !WiFi.isConnected() ? F("Not Connected") : Utils::htmlEscape(WiFi.SSID()));
+  mainPage.set(F("status_message"), "");
+  mainPage.set(F("toggle_hidden"), deviceClock.isSet() ? F("") : F("hidden"));
+  mainPage.set(F("on_off_status"), settings.isLightsOn() ? F("On") : F("Off"));
+  if (deviceClock.isSet()) {
     // Time is set so display it
     String sTime12 = Utils::intTimeToString12Time(
       Utils::adjustIntTimeForTimezone(
-        ((ntpClient.getHours() * 100) + ntpClient.getMinutes()), 
+        ((deviceClock.getHours() * 100) + deviceClock.getMinutes()), 
         settings.getTimeZone(), 
         settings.isDst()
       )
     );
-    content.replace(F("${cur_time}"), sTime12);
+    mainPage.set(F("cur_time"), sTime12);
   } else {
     // Time is unknown
-    content.replace(F("${cur_time}"), F("Unknown"));
+    mainPage.set(F("cur_time"), F("Unknown"));
   }
-  content.replace(F("${timer_on_off}"), settings.isTimerOn() ? F("Enabled") : F("Disabled"));
-  content.replace(F("${schedule_hide}"), settings.isTimerOn() && ntpClient.isTimeSet() ? F("") : F("hidden")); 
-  content.replace(F("${on_at}"), Utils::intTimeToStringTime(settings.getOnTime()));
-  content.replace(F("${off_at}"), Utils::intTimeToStringTime(settings.getOffTime()));
-  
-  // Send Main Page
-  web.send(200, F("text/html"), content);
-  yield();
+  mainPage.set(F("clock_sync"), String(getClockSyncMode()));
+  mainPage.set(F("timer_on_off"), settings.isTimerOn() ? F("Enabled") : F("Disabled"));
+  mainPage.set(F("schedule_hide"), settings.isTimerOn() && deviceClock.isSet() ? F("") : F("hidden")); 
+  mainPage.set(F("on_at"), Utils::intTimeToStringTime(settings.getOnTime()));
+  mainPage.set(F("off_at"), Utils::intTimeToStringTime(settings.getOffTime()));
+  mainPage.set(F("group_hidden"), settings.getGroupId() == 0 ? F("hidden") : F(""));
+}
+
+/**
+ * ACTION FUNCTION
+ * This action function builds the compact JSON status the dashboard is
+ * driven by from the current state of the device.
+ * 
+ * @return Returns the status as JSON as String.
+ */
+String doBuildStatusJson() {
+  String json = F("{\"v\":");
+  json.concat(stateVersion);
+  json.concat(F(",\"on\":"));
+  json.concat(settings.isLightsOn() ? F("true") : F("false"));
+  json.concat(F(",\"level\":"));
+  json.concat(settings.getBrightness());
+  json.concat(F(",\"timer\":"));
+  json.concat(settings.isTimerOn() ? F("true") : F("false"));
+  json.concat(F(",\"vacation\":"));
+  json.concat(settings.isVacationOn() ? F("true") : F("false"));
+  json.concat(F(",\"onAt\":\""));
+  json.concat(Utils::intTimeToStringTime(settings.getOnTime()));
+  json.concat(F("\",\"offAt\":\""));
+  json.concat(Utils::intTimeToStringTime(settings.getOffTime()));
+  json.concat(F("\",\"today\":"));
+  if (daySchedule.isResolved()) {
+    // Today's schedule is known, the rule being -1 when it is the usual one
+    json.concat(F("{\"onAt\":\""));
+    json.concat(Utils::intTimeToStringTime(daySchedule.getOnTime()));
+    json.concat(F("\",\"offAt\":\""));
+    json.concat(Utils::intTimeToStringTime(daySchedule.getOffTime()));
+    json.concat(F("\",\"rule\":"));
+    json.concat(daySchedule.getRule());
+    json.concat('}');
+  } else {
+    json.concat(F("null"));
+  }
+  json.concat(F(",\"time\":"));
+  if (deviceClock.isSet()) {
+    // Time is set so display it
+    json.concat('"');
+    json.concat(Utils::intTimeToString12Time(
+      Utils::adjustIntTimeForTimezone(
+        ((deviceClock.getHours() * 100) + deviceClock.getMinutes()), 
+        settings.getTimeZone(), 
+        settings.isDst()
+      )
+    ));
+    json.concat('"');
+  } else {
+    // Time is unknown
+    json.concat(F("null"));
+  }
+  json.concat(F(",\"sync\":"));
+  json.concat(getClockSyncMode());
+  json.concat(F(",\"group\":"));
+  json.concat(settings.getGroupId());
+  json.concat(F(",\"ssid\":"));
+  if (WiFi.isConnected()) {
+    json.concat('"');
+    json.concat(Utils::jsonEscape(WiFi.SSID()));
+    json.concat(F("\",\"ip\":\""));
+    json.concat(WiFi.localIP().toString());
+    json.concat('"');
+  } else {
+    json.concat(F("null,\"ip\":null"));
+  }
+  json.concat(F(",\"ambient\":"));
+  if (settings.isAmbientOn() && ambientSensor.isReady()) {
+    json.concat(F("{\"level\":"));
+    json.concat(ambientSensor.getLevel());
+    json.concat(F(",\"dark\":"));
+    json.concat(ambientSensor.isDark() ? F("true") : F("false"));
+    json.concat('}');
+  } else {
+    json.concat(F("null"));
+  }
+  json.concat(F(",\"cct\":"));
+  if (circadianMinute != -1) {
+    json.concat(circadianCurve.mixToKelvin(dimmer.getMix()));
+  } else {
+    json.concat(F("null"));
+  }
+  json.concat(F(",\"occupied\":"));
+  if (settings.isOccupancyOn()) {
+    json.concat(occupancy.isRoomOccupied() ? F("true") : F("false"));
+  } else {
+    json.concat(F("null"));
+  }
+  json.concat(F(",\"usage\":{\"onHours\":"));
+  json.concat(usageMeter.getOnSeconds() / 3600UL);
+  json.concat('.');
+  json.concat((usageMeter.getOnSeconds() / 360UL) % 10UL);
+  json.concat(F(",\"cycles\":"));
+  json.concat(usageMeter.getSwitchCycles());
+  json.concat(F(",\"fullOnHours\":"));
+  json.concat(usageMeter.getFullOnSeconds() / 3600UL);
+  json.concat('.');
+  json.concat((usageMeter.getFullOnSeconds() / 360UL) % 10UL);
+  json.concat(F("},\"fw\":\"" FIRMWARE_VERSION "\"}"));
+
+  return json;
 }
 
 /**
@@ -395,43 +1145,44 @@ void doHandleMainPage(String popupMessage) {
  * for requests which modify any of the core settings. For those settings to
  * take place the user must authenticate with the settings page prior to submitting
  * the POST to modify settings.
+ * 
+ * @param enabled Indicates if incoming args should be handled as bool.
+ * 
+ * @return Returns a message to show the user as a popup, or an empty
+ * String if there is nothing to tell them.
  */
-void doHandleIncomingArgs(bool enabled) {
+String doHandleIncomingArgs(bool enabled) {
   if (enabled && web.method() == HTTP_POST) {
     String doAction = web.arg(F("do"));
     if (doAction.equals(F("btn_on"))) {
       // Turn on lights if applicable
-      if (!settings.isLightsOn()) {
-        // Light was off and needs to be on
-        settings.setLightsOn(true);
-        settings.saveSettings();
-      }
+      doChangeLightState(true, EVENT_SOURCE_WEB);
     } else if (doAction.equals(F("btn_off"))) {
       // Turn off lights if applicable
-      if (settings.isLightsOn()) {
-        // Light was on and needs to be off
-        settings.setLightsOn(false);
-        settings.saveSettings();
-      }
+      doChangeLightState(false, EVENT_SOURCE_WEB);
+    } else if (doAction.equals(F("grp_on")) || doAction.equals(F("grp_off"))) {
+      // Switch the whole group, this device included
+      bool on = doAction.equals(F("grp_on"));
+      groupControl.send(on ? GROUP_CMD_ON : GROUP_CMD_OFF);
+      doChangeLightState(on, EVENT_SOURCE_WEB);
     } else if (doAction.equals(F("toggle_timer_state"))) {
       // Hide or show timer controls/Enable or disable timer
-      settings.setTimerOn(!settings.isTimerOn());
-      settings.saveSettings();
+      doChangeTimerState(!settings.isTimerOn(), EVENT_SOURCE_WEB);
     } else if (doAction.equals(F("btn_update"))) {
       // Save timer settings
       String on = web.arg(F("onat"));
       String off = web.arg(F("offat"));
-      if (!on.isEmpty() && !off.isEmpty()) {
-        // convert and store updated times
-        settings.setOnTime(Utils::stringTimeToIntTime(on));
-        settings.setOffTime(Utils::stringTimeToIntTime(off));
-        settings.saveSettings();
+      int onTime = Utils::stringTimeToIntTime(on);
+      int offTime = Utils::stringTimeToIntTime(off);
+      if (onTime != -1 && offTime != -1) {
+        // store updated times
+        doChangeSchedule(onTime, offTime);
       }
     } else if (doAction.equals(F("goto_admin"))) {
       // Settings button clicked so show settings page
       webHandleSettingsPage();
 
-      return;
+      return "";
     } else if (
       doAction.equals(F("admin_save"))
       && web.authenticate(settings.getAdminUser().c_str(), settings.getAdminPwd().c_str())
@@ -444,6 +1195,24 @@ void doHandleIncomingArgs(bool enabled) {
       String adminPwd = web.arg(F("adminpwd"));
       String timeZone = web.arg(F("timezone"));
       String dst = web.arg(F("dst"));
+      String group = web.arg(F("group"));
+      String controlKey = web.arg(F("controlkey"));
+      String mqttHost = web.arg(F("mqtthost"));
+      String mqttPort = web.arg(F("mqttport"));
+      String mqttUser = web.arg(F("mqttuser"));
+      String mqttPwd = web.arg(F("mqttpwd"));
+      String vacation = web.arg(F("vacation"));
+      int vacationOnFrom = Utils::stringTimeToIntTime(web.arg(F("vaconfrom")));
+      int vacationOnTo = Utils::stringTimeToIntTime(web.arg(F("vaconto")));
+      int vacationOffFrom = Utils::stringTimeToIntTime(web.arg(F("vacofffrom")));
+      int vacationOffTo = Utils::stringTimeToIntTime(web.arg(F("vacoffto")));
+      String ambient = web.arg(F("ambient"));
+      String ambientThreshold = web.arg(F("ambientthreshold"));
+      String occupancyOn = web.arg(F("occupancy"));
+      String occupancyTimeout = web.arg(F("occupancytimeout"));
+      String circadian = web.arg(F("circadian"));
+      String warmKelvin = web.arg(F("warmkelvin"));
+      String coolKelvin = web.arg(F("coolkelvin"));
 
       if (
         !ssid.isEmpty()
@@ -453,8 +1222,9 @@ void doHandleIncomingArgs(bool enabled) {
         && !adminPwd.isEmpty()
         && !timeZone.isEmpty()
       ) {
-        /* Determine If A Reboot Will Be Needed To Apply Settings Changes */
-        bool needReboot = !settings.getSsid().equals(ssid) || !settings.getPwd().equals(pwd) || !settings.getApPwd().equals(appwd);
+        /* Determine Which Interfaces Need Reconfigured To Apply Settings Changes */
+        bool needStaReconfig = !settings.getSsid().equals(ssid) || !settings.getPwd().equals(pwd);
+        bool needApReconfig = !settings.getApPwd().equals(appwd);
 
         /* Apply The Settings Changes */
         settings.setApPwd(appwd.c_str());
@@ -462,25 +1232,66 @@ void doHandleIncomingArgs(bool enabled) {
         settings.setPwd(pwd.c_str());
         settings.setAdminUser(adminUser.c_str());
         settings.setAdminPwd(adminPwd.c_str());
-        settings.setTimeZone(timeZone.toInt());
+        settings.setTimeZone(constrain(timeZone.toInt(), -12L, 14L));
         settings.setDst(dst.equalsIgnoreCase("DST") ? true : false);
+        settings.setGroupId(constrain(group.toInt(), 0L, 65535L));
+        applyGroupSettings();
+        settings.setControlKey(controlKey.c_str());
+        udpControl.setKey(settings.getControlKey());
+        settings.setMqttHost(mqttHost.c_str());
+        settings.setMqttPort(mqttPort.isEmpty() ? 1883 : mqttPort.toInt());
+        settings.setMqttUser(mqttUser.c_str());
+        settings.setMqttPwd(mqttPwd.c_str());
+        applyMqttSettings();
+        if (settings.isVacationOn() != vacation.equalsIgnoreCase("ON")) {
+          logEvent(EVENT_SOURCE_WEB, EVENT_KIND_VACATION, settings.isVacationOn(), !settings.isVacationOn());
+          settings.setVacationOn(!settings.isVacationOn());
+        }
+        if (vacationOnFrom != -1 && vacationOnTo != -1 && vacationOffFrom != -1 && vacationOffTo != -1) {
+          settings.setVacationOnFrom(vacationOnFrom);
+          settings.setVacationOnTo(vacationOnTo);
+          settings.setVacationOffFrom(vacationOffFrom);
+          settings.setVacationOffTo(vacationOffTo);
+        }
+        applyVacationSettings();
+        settings.setAmbientOn(ambient.equalsIgnoreCase("ON"));
+        if (!ambientThreshold.isEmpty()) {
+          settings.setAmbientThreshold(ambientThreshold.toInt());
+        }
+        applyAmbientSettings();
+        settings.setOccupancyOn(occupancyOn.equalsIgnoreCase("ON"));
+        if (!occupancyTimeout.isEmpty()) {
+          settings.setOccupancyTimeout(occupancyTimeout.toInt());
+        }
+        applyOccupancySettings();
+        settings.setCircadianOn(circadian.equalsIgnoreCase("ON"));
+        if (!warmKelvin.isEmpty() && !coolKelvin.isEmpty()) {
+          settings.setWarmKelvin(warmKelvin.toInt());
+          settings.setCoolKelvin(coolKelvin.toInt());
+        }
+        applyCircadianSettings();
 
         /* Save Changes */
         settings.saveSettings();
+        bumpStateVersion();
+
+        /* Reconfigure Interfaces If Needed */
+        if (needApReconfig || needStaReconfig) {
+          isApReconfigPending = isApReconfigPending || needApReconfig;
+          isStaReconfigPending = isStaReconfigPending || needStaReconfig;
+          reconfigRequestedAt = millis();
 
-        /* Reboot If Needed */
-        if (needReboot) {
-          String message = F("<!DOCTYPE HTML><html lang=\"en\"><head></head><body><script>alert(\"Rebooting to apply settings!\");</script></body></html>");
-          web.send(200, F("text/html"), message.c_str());
-          yield();
-          delay(2000);
-          ESP.restart();
+          return needApReconfig 
+            ? F("Applying network settings! Reconnect to the AP using its new password.") 
+            : F("Applying network settings!");
         }
       }
 
       yield();
     }
   }
+
+  return "";
 }
 
 // ===============================================================
@@ -497,6 +1308,102 @@ void webHandleMainPage() {
   doHandleMainPage("");
 }
 
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to send the dashboard.
+ * The dashboard only changes with the firmware, so browsers are told to keep
+ * it and only ask again once a day to see if it has changed. It is tagged
+ * with a hash of the page itself, so a new dashboard is picked up even when
+ * the firmware version was not bumped.
+ */
+void webHandleDashboard() {
+  const String &etag = getDashboardEtag();
+  web.sendHeader(F("Cache-Control"), F("max-age=86400"));
+  web.sendHeader(F("ETag"), etag);
+  if (web.header(F("If-None-Match")).equals(etag)) {
+    // Browser already has it
+    web.send(304);
+  } else {
+    web.send_P(200, PSTR("text/html"), DASHBOARD_PAGE);
+  }
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to send the status
+ * of the device as JSON. The status is tagged with the state version, so
+ * a browser asking again before anything has changed gets an empty 304. The
+ * JSON is only built again once the state version has moved on.
+ */
+void webHandleApiStatus() {
+  String etag = F("\"");
+  etag.concat(String(bootNonce, HEX));
+  etag.concat('-');
+  etag.concat(stateVersion);
+  etag.concat('"');
+  web.sendHeader(F("Cache-Control"), F("no-cache"));
+  web.sendHeader(F("ETag"), etag);
+  if (web.header(F("If-None-Match")).equals(etag)) {
+    // Nothing has changed since the browser last asked
+    web.send(304);
+    yield();
+
+    return;
+  }
+
+  web.send(200, F("application/json"), getStatusJson());
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to carry out a
+ * command from the dashboard, given by the 'do' arg. The status after the
+ * command is sent back so the dashboard needs no second request. Commands
+ * are on, off, level, which takes the 'value' arg in percent, grp_on,
+ * grp_off, timer_on, timer_off, vacation_on, vacation_off and schedule,
+ * which takes the 'onat' and 'offat' args.
+ */
+void webHandleApiCmd() {
+  String doAction = web.arg(F("do"));
+  if (doAction.equals(F("on")) || doAction.equals(F("off"))) {
+    doChangeLightState(doAction.equals(F("on")), EVENT_SOURCE_API);
+  } else if (doAction.equals(F("grp_on")) || doAction.equals(F("grp_off"))) {
+    // Switch the whole group, this device included
+    bool on = doAction.equals(F("grp_on"));
+    groupControl.send(on ? GROUP_CMD_ON : GROUP_CMD_OFF);
+    doChangeLightState(on, EVENT_SOURCE_API);
+  } else if (doAction.equals(F("level"))) {
+    long percent = web.arg(F("value")).toInt();
+    if (percent < 1 || percent > 100) {
+      web.send(400, F("application/json"), F("{\"error\":\"Level must be 1 to 100\"}"));
+
+      return;
+    }
+    doChangeBrightness(percent, EVENT_SOURCE_API);
+  } else if (doAction.equals(F("timer_on")) || doAction.equals(F("timer_off"))) {
+    doChangeTimerState(doAction.equals(F("timer_on")), EVENT_SOURCE_API);
+  } else if (doAction.equals(F("vacation_on")) || doAction.equals(F("vacation_off"))) {
+    doChangeVacationState(doAction.equals(F("vacation_on")), EVENT_SOURCE_API);
+  } else if (doAction.equals(F("schedule"))) {
+    int onTime = Utils::stringTimeToIntTime(web.arg(F("onat")));
+    int offTime = Utils::stringTimeToIntTime(web.arg(F("offat")));
+    if (onTime == -1 || offTime == -1) {
+      web.send(400, F("application/json"), F("{\"error\":\"Schedule times must be HH:MM\"}"));
+
+      return;
+    }
+    doChangeSchedule(onTime, offTime);
+  } else {
+    web.send(400, F("application/json"), F("{\"error\":\"Unknown command\"}"));
+
+    return;
+  }
+
+  webHandleApiStatus();
+}
+
 /**
  * WEB HANDLER
  * This function is called directly by the web server to show the settings page
@@ -514,49 +1421,922 @@ void webHandleSettingsPage() {
   }
 
   /* Build Page Content */
-  String content = SETTINGS_PAGE;
-  content.replace(F("${version}"), FIRMWARE_VERSION);
-  content.replace(F("${ap_pwd}"), settings.getApPwd());
-  content.replace(F("${ssid}"), settings.getSsid());
-  content.replace(F("${pwd}"), settings.getPwd());
-  content.replace(F("${adminuser}"), settings.getAdminUser());
-  content.replace(F("${adminpwd}"), settings.getAdminPwd());
-  content.replace(F("${time_zone}"), String(settings.getTimeZone()));
-  content.replace(F("${checked_status}"), (settings.isDst() ? F("checked") : F("")));
+  PageTemplate content(SETTINGS_PAGE);
+  content.set(F("version"), FIRMWARE_VERSION);
+  content.set(F("ap_pwd"), Utils::htmlEscape(settings.getApPwd()));
+  content.set(F("ssid"), Utils::htmlEscape(settings.getSsid()));
+  content.set(F("pwd"), Utils::htmlEscape(settings.getPwd()));
+  content.set(F("adminuser"), Utils::htmlEscape(settings.getAdminUser()));
+  content.set(F("adminpwd"), Utils::htmlEscape(settings.getAdminPwd()));
+  content.set(F("time_zone"), String(settings.getTimeZone()));
+  content.set(F("checked_status"), (settings.isDst() ? F("checked") : F("")));
+  content.set(F("group"), String(settings.getGroupId()));
+  content.set(F("controlkey"), Utils::htmlEscape(settings.getControlKey()));
+  content.set(F("mqtthost"), Utils::htmlEscape(settings.getMqttHost()));
+  content.set(F("mqttport"), String(settings.getMqttPort()));
+  content.set(F("mqttuser"), Utils::htmlEscape(settings.getMqttUser()));
+  content.set(F("mqttpwd"), Utils::htmlEscape(settings.getMqttPwd()));
+  content.set(F("vacation_checked"), settings.isVacationOn() ? F("checked") : F(""));
+  content.set(F("vaconfrom"), Utils::intTimeToStringTime(settings.getVacationOnFrom()));
+  content.set(F("vaconto"), Utils::intTimeToStringTime(settings.getVacationOnTo()));
+  content.set(F("vacofffrom"), Utils::intTimeToStringTime(settings.getVacationOffFrom()));
+  content.set(F("vacoffto"), Utils::intTimeToStringTime(settings.getVacationOffTo()));
+  content.set(F("ambient_checked"), settings.isAmbientOn() ? F("checked") : F(""));
+  content.set(F("ambientthreshold"), String(settings.getAmbientThreshold()));
+  content.set(F("ambient_level"), String(analogRead(AMBIENT_PIN)));
+  content.set(F("occupancy_checked"), settings.isOccupancyOn() ? F("checked") : F(""));
+  content.set(F("occupancytimeout"), String(settings.getOccupancyTimeout()));
+  content.set(F("circadian_checked"), settings.isCircadianOn() ? F("checked") : F(""));
+  content.set(F("warmkelvin"), String(settings.getWarmKelvin()));
+  content.set(F("coolkelvin"), String(settings.getCoolKelvin()));
   
   /* Send Page Content */
-  web.send(200, F("text/html"), content);
+  content.send(web, 200, F("text/html"));
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called by the main page's script to hand the device the
+ * browser's time, as epoch millis in the 't' arg, when the device has no
+ * better source for it. Hand set time never replaces NTP or peer time.
+ */
+void webHandleClock() {
+  String t = web.arg(F("t"));
+  if (t.length() < 10 || t.length() > 16) {
+    web.send(400, F("text/plain"), F("Expected epoch millis as t"));
+
+    return;
+  }
+
+  if (!deviceClock.isSet() || deviceClock.getSource() == CLOCK_SOURCE_MANUAL) {
+    uint64_t epochMillis = strtoull(t.c_str(), nullptr, 10);
+    deviceClock.setTime(epochMillis / 1000ULL, epochMillis % 1000ULL, CLOCK_SOURCE_MANUAL, CLOCK_STRATUM_MANUAL);
+  }
+
+  web.send(204);
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to control request
+ * trace capture and to download what was captured. It requires the user to
+ * authenticate. The 'start' arg begins a new capture keeping the given number
+ * of records, the 'stop' arg ends it and otherwise the captured records are
+ * sent as text for tools/trace_replay.py.
+ */
+void webHandleTrace() {
+  /* Ensure user authenticated */
+  if (!web.authenticate(settings.getAdminUser().c_str(), settings.getAdminPwd().c_str())) {
+    // User not yet authenticated
+
+    return web.requestAuthentication(DIGEST_AUTH, "AdminRealm", "Authentication failed!");
+  }
+
+  if (web.hasArg(F("start"))) {
+    long records = web.arg(F("start")).toInt();
+    bool ok = requestTrace.start(records > 0 ? records : TRACE_DEFAULT_RECORDS);
+    web.send(ok ? 200 : 500, F("text/plain"), ok ? F("Capture started") : F("Not enough memory to capture"));
+  } else if (web.hasArg(F("stop"))) {
+    requestTrace.stop();
+    web.send(200, F("text/plain"), F("Capture stopped"));
+  } else {
+    // Stream the records out one line at a time
+    web.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    web.send(200, F("text/plain"), "");
+    String header = F("# lumen-trace v1 fw=");
+    header.concat(FIRMWARE_VERSION);
+    header.concat(F(" records="));
+    header.concat(requestTrace.getCount());
+    header.concat(F("\n"));
+    web.sendContent(header);
+    for (size_t i = 0; i < requestTrace.getCount(); i++) {
+      web.sendContent(requestTrace.formatRecord(i));
+    }
+    web.sendContent("");
+  }
+
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to report runtime
+ * metrics in the Prometheus text format, so they can be scraped or just
+ * read in a browser.
+ */
+void webHandleMetrics() {
+  String content = F("# TYPE lumen_render_cache_hits counter\nlumen_render_cache_hits ");
+  content.concat(renderCacheHits);
+  content.concat(F("\n# TYPE lumen_render_cache_misses counter\nlumen_render_cache_misses "));
+  content.concat(renderCacheMisses);
+  content.concat(F("\n# TYPE lumen_state_version counter\nlumen_state_version "));
+  content.concat(stateVersion);
+  content.concat(F("\n# TYPE lumen_light_socket_clients gauge\nlumen_light_socket_clients "));
+  content.concat(lightSocket.getClientCount());
+  content.concat(F("\n# TYPE lumen_udp_control_requests counter\nlumen_udp_control_requests "));
+  content.concat(udpControl.getCommandCount());
+  content.concat(F("\n# TYPE lumen_udp_control_micros counter\nlumen_udp_control_micros "));
+  content.concat(udpControl.getHandleMicros());
+  content.concat(F("\n# TYPE lumen_coap_observers gauge\nlumen_coap_observers "));
+  content.concat(coapServer.getObserverCount());
+  content.concat(F("\n# TYPE lumen_coap_notifications counter\nlumen_coap_notifications "));
+  content.concat(coapServer.getNotificationCount());
+  content.concat(F("\n# TYPE lumen_mqtt_connected gauge\nlumen_mqtt_connected "));
+  content.concat(mqttLink.isConnected() ? 1 : 0);
+  content.concat(F("\n# TYPE lumen_mqtt_publishes counter\nlumen_mqtt_publishes "));
+  content.concat(mqttLink.getPublishCount());
+  content.concat(F("\n# TYPE lumen_mqtt_publishes_suppressed counter\nlumen_mqtt_publishes_suppressed "));
+  content.concat(mqttLink.getSuppressedCount());
+  content.concat(F("\n# TYPE lumen_light_on_seconds counter\nlumen_light_on_seconds "));
+  content.concat(usageMeter.getOnSeconds());
+  content.concat(F("\n# TYPE lumen_light_switch_cycles counter\nlumen_light_switch_cycles "));
+  content.concat(usageMeter.getSwitchCycles());
+  content.concat(F("\n# TYPE lumen_light_full_on_seconds counter\nlumen_light_full_on_seconds "));
+  content.concat(usageMeter.getFullOnSeconds());
+  if (settings.isAmbientOn() && ambientSensor.isReady()) {
+    content.concat(F("\n# TYPE lumen_ambient_level gauge\nlumen_ambient_level "));
+    content.concat(ambientSensor.getLevel());
+  }
+  content.concat(F("\n# TYPE lumen_events counter\nlumen_events "));
+  content.concat(eventLog.getNextSeq());
+  content.concat(F("\n# TYPE lumen_free_heap_bytes gauge\nlumen_free_heap_bytes "));
+  content.concat(ESP.getFreeHeap());
+  content.concat(F("\n# TYPE lumen_uptime_seconds counter\nlumen_uptime_seconds "));
+  content.concat(millis() / 1000UL);
+  content.concat(F("\n"));
+
+  web.send(200, F("text/plain; version=0.0.4"), content);
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to page through the
+ * event log as JSON, newest first. The 'count' arg sets how many events,
+ * up to 50, and the 'before' arg the sequence number to page back from,
+ * as given by "next" in the previous page. Each event is formatted into a
+ * buffer on the stack, once to work out the length of the response and
+ * again as it is sent, so no part of the history is copied to the heap.
+ */
+void webHandleEvents() {
+  uint32_t first = eventLog.getFirstSeq();
+  uint32_t before = eventLog.getNextSeq();
+  if (web.hasArg(F("before"))) {
+    before = constrain((uint32_t)strtoul(web.arg(F("before")).c_str(), nullptr, 10), first, before);
+  }
+  long count = web.hasArg(F("count")) ? web.arg(F("count")).toInt() : 20L;
+  count = constrain(count, 1L, 50L);
+  uint32_t last = before - min((uint32_t)count, before - first);
+
+  /* Work Out The Length */
+  char buffer[112];
+  char next[16] = "null";
+  if (last > first) {
+    snprintf_P(next, sizeof(next), PSTR("%lu"), (unsigned long)last);
+  }
+  size_t length = strlen_P(PSTR("{\"events\":[],\"next\":}")) + strlen(next);
+  for (uint32_t seq = before; seq > last; seq--) {
+    length += eventLog.format(seq - 1, buffer + 1, sizeof(buffer) - 1) + (seq < before ? 1 : 0);
+  }
+
+  /* Send Events */
+  web.setContentLength(length);
+  web.send(200, F("application/json"), "");
+  web.sendContent_P(PSTR("{\"events\":["));
+  for (uint32_t seq = before; seq > last; seq--) {
+    size_t eventLength = eventLog.format(seq - 1, buffer + 1, sizeof(buffer) - 1);
+    buffer[0] = ',';
+    web.sendContent(seq < before ? buffer : buffer + 1, eventLength + (seq < before ? 1 : 0));
+  }
+  web.sendContent_P(PSTR("],\"next\":"));
+  web.sendContent(next, strlen(next));
+  web.sendContent_P(PSTR("}"));
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to list the rules of
+ * the calendar as JSON, in the order they are indexed by. Dates are given
+ * as YYYY-MM-DD, or MM-DD for yearly rules, and days as a mask with
+ * Sunday as bit 0. On and off times being the same means off all day.
+ */
+void webHandleCalendar() {
+  static const char KIND_NAMES[CALENDAR_RULE_KINDS][7] = { "dates", "yearly", "weekly" };
+
+  String json = F("{\"rules\":[");
+  char from[11];
+  char to[11];
+  for (uint8_t i = 0; i < lightCalendar.getCount(); i++) {
+    const CalendarRule &rule = lightCalendar.getRule(i);
+    if (i > 0) {
+      json.concat(',');
+    }
+    json.concat(F("{\"kind\":\""));
+    json.concat(KIND_NAMES[rule.kind]);
+    if (rule.kind == CALENDAR_RULE_WEEKLY) {
+      json.concat(F("\",\"days\":"));
+      json.concat(rule.days);
+    } else {
+      LightCalendar::formatDate(rule.start, rule.kind == CALENDAR_RULE_YEARLY, from, sizeof(from));
+      LightCalendar::formatDate(rule.end, rule.kind == CALENDAR_RULE_YEARLY, to, sizeof(to));
+      json.concat(F("\",\"from\":\""));
+      json.concat(from);
+      json.concat(F("\",\"to\":\""));
+      json.concat(to);
+      json.concat('"');
+    }
+    json.concat(F(",\"onAt\":\""));
+    json.concat(Utils::intTimeToStringTime(rule.onTime));
+    json.concat(F("\",\"offAt\":\""));
+    json.concat(Utils::intTimeToStringTime(rule.offTime));
+    json.concat(F("\"}"));
+  }
+  json.concat(F("],\"max\":"));
+  json.concat(CALENDAR_MAX_RULES);
+  json.concat('}');
+
+  web.send(200, F("application/json"), json);
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to change the
+ * calendar, given by the 'do' arg, sending the rules back afterwards.
+ * Commands are add, remove, which takes the 'index' arg, and clear. Add
+ * takes the 'kind' arg as dates, yearly or weekly, the 'from' and 'to'
+ * args as dates for the first two or the 'days' arg as a mask for weekly,
+ * and either the 'onat' and 'offat' args or the 'off' arg to keep the
+ * lights off all day.
+ */
+void webHandleCalendarCmd() {
+  String doAction = web.arg(F("do"));
+  if (doAction.equals(F("add"))) {
+    CalendarRule rule;
+    memset(&rule, 0, sizeof(rule));
+    String kind = web.arg(F("kind"));
+    if (kind.equals(F("dates")) || kind.equals(F("yearly"))) {
+      rule.kind = kind.equals(F("yearly")) ? CALENDAR_RULE_YEARLY : CALENDAR_RULE_DATES;
+      bool isYearly = rule.kind == CALENDAR_RULE_YEARLY;
+      String to = web.hasArg(F("to")) ? web.arg(F("to")) : web.arg(F("from"));
+      if (
+        !LightCalendar::parseDate(web.arg(F("from")).c_str(), isYearly, rule.start)
+        || !LightCalendar::parseDate(to.c_str(), isYearly, rule.end)
+      ) {
+        web.send(400, F("application/json"), isYearly ? F("{\"error\":\"Dates must be MM-DD\"}") : F("{\"error\":\"Dates must be YYYY-MM-DD\"}"));
+
+        return;
+      }
+    } else if (kind.equals(F("weekly"))) {
+      rule.kind = CALENDAR_RULE_WEEKLY;
+      rule.days = web.arg(F("days")).toInt() & 0x7F;
+    } else {
+      web.send(400, F("application/json"), F("{\"error\":\"Kind must be dates, yearly or weekly\"}"));
+
+      return;
+    }
+    if (!web.hasArg(F("off"))) {
+      rule.onTime = Utils::stringTimeToIntTime(web.arg(F("onat")));
+      rule.offTime = Utils::stringTimeToIntTime(web.arg(F("offat")));
+    }
+    if (!LightCalendar::isValid(rule)) {
+      web.send(400, F("application/json"), F("{\"error\":\"Rule is not valid\"}"));
+
+      return;
+    }
+    if (!lightCalendar.add(rule)) {
+      web.send(409, F("application/json"), F("{\"error\":\"Calendar is full\"}"));
+
+      return;
+    }
+  } else if (doAction.equals(F("remove"))) {
+    long index = web.hasArg(F("index")) ? web.arg(F("index")).toInt() : -1L;
+    if (index < 0 || index > 255 || !lightCalendar.remove(index)) {
+      web.send(404, F("application/json"), F("{\"error\":\"No such rule\"}"));
+
+      return;
+    }
+  } else if (doAction.equals(F("clear"))) {
+    lightCalendar.clear();
+  } else {
+    web.send(400, F("application/json"), F("{\"error\":\"Unknown command\"}"));
+
+    return;
+  }
+
+  if (!saveCalendar()) {
+    Serial.println(F("Unable to save calendar!"));
+  }
+  daySchedule.invalidate();
+  webHandleCalendar();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called directly by the web server to show the firmware
+ * update page. Like the settings page it requires the user to authenticate.
+ */
+void webHandleUpdatePage() {
+  /* Ensure user authenticated */
+  if (!web.authenticate(settings.getAdminUser().c_str(), settings.getAdminPwd().c_str())) {
+    // User not yet authenticated
+
+    return web.requestAuthentication(DIGEST_AUTH, "AdminRealm", "Authentication failed!");
+  }
+
+  PageTemplate content(UPDATE_PAGE);
+  content.set(F("version"), FIRMWARE_VERSION);
+
+  content.send(web, 200, F("text/html"));
   yield();
 }
 
+/**
+ * WEB HANDLER
+ * This function is called by the web server for each chunk of a firmware
+ * image being uploaded to the update page. The chunks are streamed straight
+ * into flash, nothing is written unless the user is authenticated. Full, gzip
+ * compressed and delta images are all accepted.
+ */
+void webHandleUpdateUpload() {
+  HTTPUpload &upload = web.upload();
+  switch (upload.status) {
+    case UPLOAD_FILE_START:
+      isOtaAuthorized = web.authenticate(settings.getAdminUser().c_str(), settings.getAdminPwd().c_str());
+      if (isOtaAuthorized) {
+        Serial.printf("Firmware update started: %s\n", upload.filename.c_str());
+        ota.begin(web.arg(F("md5")).c_str(), (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
+      }
+      break;
+    case UPLOAD_FILE_WRITE:
+      if (isOtaAuthorized) {
+        ota.write(upload.buf, upload.currentSize);
+      }
+      break;
+    case UPLOAD_FILE_END:
+      if (isOtaAuthorized) {
+        ota.end();
+      }
+      break;
+    case UPLOAD_FILE_ABORTED:
+      ota.abort();
+      break;
+  }
+
+  yield();
+}
+
+/**
+ * WEB HANDLER
+ * This function is called by the web server once a firmware image upload
+ * has completed. It reports the outcome along with the throughput achieved
+ * and restarts into the new image if it was accepted.
+ */
+void webHandleUpdateDone() {
+  if (!isOtaAuthorized) {
+    // User not yet authenticated
+
+    return web.requestAuthentication(DIGEST_AUTH, "AdminRealm", "Authentication failed!");
+  }
+  isOtaAuthorized = false;
+
+  if (ota.isRunning()) {
+    // Upload ended without the final chunk being seen
+    ota.abort();
+  }
+  
+  String message;
+  if (ota.hasError() || ota.getBytesWritten() == 0) {
+    message = F("Update failed: ");
+    message.concat(ota.hasError() ? ota.getError() : F("No image received!"));
+    Serial.println(message);
+    web.send(500, F("text/plain"), message);
+  } else {
+    message = F("Update successful: ");
+    message.concat(ota.getFormatName());
+    message.concat(F(" image, "));
+    message.concat(ota.getBytesReceived());
+    message.concat(F(" bytes received, "));
+    message.concat(ota.getBytesWritten());
+    message.concat(F(" bytes written in "));
+    message.concat(ota.getElapsedMillis());
+    message.concat(F(" ms ("));
+    message.concat(ota.getBytesPerSecond() / 1024UL);
+    message.concat(F(" KB/s). Rebooting..."));
+    Serial.println(message);
+    web.send(200, F("text/plain"), message);
+    
+    isRestartPending = true;
+    restartRequestedAt = millis();
+  }
+
+  yield();
+}
+
+// ===============================================================
+// COAP FUNCTIONS BELOW
+// ===============================================================
+
+/**
+ * COAP HANDLER
+ * This function is called by the CoAP server for the representation of
+ * the /light resource.
+ * 
+ * @param buffer Where to write the representation as char*.
+ * @param size The size of the buffer as size_t.
+ * 
+ * @return Returns the length of the representation as size_t.
+ */
+size_t coapGetLight(char *buffer, size_t size) {
+  
+  return snprintf_P(
+    buffer, 
+    size, 
+    PSTR("{\"on\":%s,\"level\":%d}"), 
+    settings.isLightsOn() ? "true" : "false", 
+    settings.getBrightness()
+  );
+}
+
+/**
+ * COAP HANDLER
+ * This function is called by the CoAP server to change the /light resource.
+ * The payload is "on", "off", "toggle" or a brightness from 1 to 100.
+ * 
+ * @param payload The payload of the request as char*.
+ * @param length The length of the payload as size_t.
+ * 
+ * @return Returns the CoAP response code as uint8_t.
+ */
+uint8_t coapPutLight(const char *payload, size_t length) {
+  char value[8];
+  if (length == 0 || length >= sizeof(value)) {
+
+    return COAP_BAD_REQUEST;
+  }
+  memcpy(value, payload, length);
+  value[length] = '\0';
+
+  if (strcmp_P(value, PSTR("on")) == 0 || strcmp_P(value, PSTR("off")) == 0) {
+    doChangeLightState(value[1] == 'n', EVENT_SOURCE_COAP);
+  } else if (strcmp_P(value, PSTR("toggle")) == 0) {
+    doChangeLightState(!settings.isLightsOn(), EVENT_SOURCE_COAP);
+  } else {
+    int percent = atoi(value);
+    if (percent < 1 || percent > 100) {
+
+      return COAP_BAD_REQUEST;
+    }
+    doChangeBrightness(percent, EVENT_SOURCE_COAP);
+  }
+
+  return COAP_CHANGED;
+}
+
+/**
+ * COAP HANDLER
+ * This function is called by the CoAP server for the representation of
+ * the /timer resource.
+ * 
+ * @param buffer Where to write the representation as char*.
+ * @param size The size of the buffer as size_t.
+ * 
+ * @return Returns the length of the representation as size_t.
+ */
+size_t coapGetTimer(char *buffer, size_t size) {
+
+  return snprintf_P(
+    buffer, 
+    size, 
+    PSTR("{\"on\":%s,\"onAt\":\"%s\",\"offAt\":\"%s\"}"), 
+    settings.isTimerOn() ? "true" : "false", 
+    Utils::intTimeToStringTime(settings.getOnTime()).c_str(), 
+    Utils::intTimeToStringTime(settings.getOffTime()).c_str()
+  );
+}
+
+/**
+ * COAP HANDLER
+ * This function is called by the CoAP server to change the /timer resource.
+ * The payload is "on", "off" or a schedule as "HH:MM-HH:MM".
+ * 
+ * @param payload The payload of the request as char*.
+ * @param length The length of the payload as size_t.
+ * 
+ * @return Returns the CoAP response code as uint8_t.
+ */
+uint8_t coapPutTimer(const char *payload, size_t length) {
+  char value[12];
+  if (length == 0 || length >= sizeof(value)) {
+
+    return COAP_BAD_REQUEST;
+  }
+  memcpy(value, payload, length);
+  value[length] = '\0';
+
+  if (strcmp_P(value, PSTR("on")) == 0 || strcmp_P(value, PSTR("off")) == 0) {
+    doChangeTimerState(value[1] == 'n', EVENT_SOURCE_COAP);
+  } else if (length == 11 && value[5] == '-') {
+    value[5] = '\0';
+    int onTime = Utils::stringTimeToIntTime(String(value));
+    int offTime = Utils::stringTimeToIntTime(String(value + 6));
+    if (onTime == -1 || offTime == -1) {
+
+      return COAP_BAD_REQUEST;
+    }
+    doChangeSchedule(onTime, offTime);
+  } else {
+
+    return COAP_BAD_REQUEST;
+  }
+
+  return COAP_CHANGED;
+}
+
+/**
+ * COAP HANDLER
+ * This function is called by the CoAP server for the representation of
+ * the /status resource. This is a short form of /api/status, the state
+ * version along with the light and timer, as the full JSON does not fit
+ * in a single CoAP packet.
+ * 
+ * @param buffer Where to write the representation as char*.
+ * @param size The size of the buffer as size_t.
+ * 
+ * @return Returns the length of the representation as size_t.
+ */
+size_t coapGetStatus(char *buffer, size_t size) {
+
+  return snprintf_P(
+    buffer, 
+    size, 
+    PSTR("{\"v\":%lu,\"on\":%s,\"level\":%d,\"timer\":%s}"), 
+    (unsigned long)stateVersion, 
+    settings.isLightsOn() ? "true" : "false", 
+    settings.getBrightness(), 
+    settings.isTimerOn() ? "true" : "false"
+  );
+}
+
 // ===============================================================
 // UTILITY FUNCTIONS BELOW
 // ===============================================================
 
 /**
  * UTILITY FUNCTION
- * This function id used to determine if the given time is
- * located within the On Zone as defined by the on and off 
- * time settings of the timer.
- * 
- * @param time24 The given time in 24 hour format as an int.
- * 
- * @return Returns a bool true if given time falls in the On Zone
- * otherwise a false is returned.
- */
-bool inOnZone(int time24) {
-  return (
-    (
-      settings.getOnTime() < settings.getOffTime() 
-      && time24 >= settings.getOnTime() 
-      && time24 < settings.getOffTime()
-    )
-    || (
-      settings.getOnTime() > settings.getOffTime()
-      && (
-        time24 >= settings.getOnTime() 
-        || time24 < settings.getOffTime()
-      )
-    )
+ * This function gets the ETag of the dashboard, a FNV-1a hash of the page
+ * worked out the first time it is asked for.
+ * 
+ * @return Returns the quoted ETag as String&.
+ */
+const String &getDashboardEtag() {
+  if (dashboardEtag.isEmpty()) {
+    uint32_t hash = 2166136261UL;
+    for (PGM_P p = DASHBOARD_PAGE; pgm_read_byte(p) != '\0'; p++) {
+      hash = (hash ^ pgm_read_byte(p)) * 16777619UL;
+    }
+    dashboardEtag = F("\"");
+    dashboardEtag.concat(String(hash, HEX));
+    dashboardEtag.concat('"');
+  }
+
+  return dashboardEtag;
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function gets the status of the device as JSON, only building it
+ * again once the state version has moved on.
+ * 
+ * @return Returns the status as JSON as String&.
+ */
+const String &getStatusJson() {
+  if (statusJsonVersion == stateVersion) {
+    renderCacheHits++;
+  } else {
+    renderCacheMisses++;
+    statusJson = doBuildStatusJson();
+    statusJsonVersion = stateVersion;
+  }
+
+  return statusJson;
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function applies the group settings to the group control. While
+ * in a group WiFi power saving is turned off, as it would otherwise hold
+ * back received group commands for up to a few beacon intervals.
+ */
+void applyGroupSettings() {
+  groupControl.setGroupId(settings.getGroupId());
+  WiFi.setSleepMode(settings.getGroupId() == 0 ? WIFI_MODEM_SLEEP : WIFI_NONE_SLEEP);
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function applies the MQTT settings to the MQTT link.
+ */
+void applyMqttSettings() {
+  mqttLink.setBroker(settings.getMqttHost(), settings.getMqttPort(), settings.getMqttUser(), settings.getMqttPwd());
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function applies the vacation settings to the vacation planner,
+ * having today planned again with them.
+ */
+void applyVacationSettings() {
+  vacationPlanner.setBounds(
+    settings.getVacationOnFrom(), 
+    settings.getVacationOnTo(), 
+    settings.getVacationOffFrom(), 
+    settings.getVacationOffTo()
+  );
+  daySchedule.invalidate();
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function applies the ambient light settings to the sensor. The
+ * sensor starts over from its next reading, so it doesn't act on ones
+ * taken before it was turned on.
+ */
+void applyAmbientSettings() {
+  ambientSensor.setThreshold(settings.getAmbientThreshold());
+  ambientSensor.reset();
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function applies the occupancy settings. When turned off any
+ * lights the occupancy input switched on are no longer timed out.
+ */
+void applyOccupancySettings() {
+  occupancy.setTimeout(settings.getOccupancyTimeout() * 60000UL);
+  if (!settings.isOccupancyOn()) {
+    occupancy.release();
+  }
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function applies the tunable white settings, building the table
+ * of the day for the fixture's channels and looking up the current
+ * minute again.
+ */
+void applyCircadianSettings() {
+  circadianCurve.build(settings.getWarmKelvin(), settings.getCoolKelvin());
+  circadianMinute = -1;
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function loads the usage totals saved in flash and has the usage
+ * meter count on from them, or from its RTC copy if that counted on from
+ * the same totals. No totals or ones that are not valid count from zero.
+ */
+void loadUsage() {
+  uint32_t record[4] = {0, 0, 0, 0}; // Magic, on seconds, switch cycles, full on seconds
+  if (LittleFS.begin()) {
+    File file = LittleFS.open(USAGE_FILE, "r");
+    if (file) {
+      if (file.read((uint8_t *)record, sizeof(record)) != sizeof(record) || record[0] != USAGE_MAGIC) {
+        memset(record, 0, sizeof(record));
+      }
+      file.close();
+    }
+  }
+
+  if (usageMeter.begin(record[1], record[2], record[3])) {
+    Serial.println(F("Usage totals restored from RTC memory."));
+  }
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function saves the usage totals to flash. They are kept apart from
+ * the settings so the hourly write goes to the file system, which spreads
+ * it over its blocks, and never erases the settings sector. It goes to a
+ * temporary file renamed over the last one, so a power cut part way thru
+ * leaves the last totals in place.
+ * 
+ * @return Returns true if saved otherwise false as bool.
+ */
+bool saveUsage() {
+  File file = LittleFS.open(USAGE_TEMP, "w");
+  if (!file) {
+
+    return false;
+  }
+
+  uint32_t record[4] = {USAGE_MAGIC, usageMeter.getOnSeconds(), usageMeter.getSwitchCycles(), usageMeter.getFullOnSeconds()};
+  bool ok = file.write((const uint8_t *)record, sizeof(record)) == sizeof(record);
+  file.close();
+
+  return ok && LittleFS.rename(USAGE_TEMP, USAGE_FILE);
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function loads the calendar saved in flash, leaving it empty if
+ * there is none or it isn't valid. The file system is mounted by the
+ * event log, so this must come after it.
+ */
+void loadCalendar() {
+  File file = LittleFS.open(CALENDAR_FILE, "r");
+  if (!file) {
+
+    return;
+  }
+
+  uint32_t magic = 0;
+  CalendarRule rules[CALENDAR_MAX_RULES];
+  size_t count = 0;
+  if (file.read((uint8_t *)&magic, sizeof(magic)) == sizeof(magic) && magic == CALENDAR_MAGIC) {
+    count = file.read((uint8_t *)rules, sizeof(rules)) / sizeof(CalendarRule);
+  }
+  file.close();
+
+  if (!lightCalendar.setRules(rules, count)) {
+    Serial.println(F("Calendar had rules that are not valid, dropped them."));
+  }
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function saves the calendar to flash as its sorted table of rules,
+ * only ever written when the calendar is changed. Like the event log it
+ * goes to a temporary file renamed over the last one.
+ * 
+ * @return Returns true if saved otherwise false as bool.
+ */
+bool saveCalendar() {
+  File file = LittleFS.open(CALENDAR_TEMP, "w");
+  if (!file) {
+
+    return false;
+  }
+
+  uint32_t magic = CALENDAR_MAGIC;
+  size_t length = lightCalendar.getCount() * sizeof(CalendarRule);
+  bool ok = (
+    file.write((const uint8_t *)&magic, sizeof(magic)) == sizeof(magic)
+    && file.write((const uint8_t *)lightCalendar.getRules(), length) == length
   );
+  file.close();
+
+  return ok && LittleFS.rename(CALENDAR_TEMP, CALENDAR_FILE);
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function works out the local date from the device clock, which
+ * must be set, using the same time zone the timer runs on.
+ * 
+ * @return Returns the local date as days since 1970-01-01 as long.
+ */
+long getLocalEpochDay() {
+  long offset = (settings.getTimeZone() + (settings.isDst() ? 1L : 0L)) * 3600L;
+
+  return ((long)deviceClock.getEpoch() + offset) / 86400L;
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function works out the local time from the device clock, which
+ * must be set.
+ * 
+ * @return Returns the local time as a 24hour time as int.
+ */
+int getLocalTime24() {
+  int time24 = (deviceClock.getHours() * 100) + deviceClock.getMinutes();
+
+  return Utils::adjustIntTimeForTimezone(time24, settings.getTimeZone(), settings.isDst());
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function determines if the ambient light sensor, when turned on,
+ * finds it is still light out.
+ * 
+ * @return Returns true if light out otherwise false as bool.
+ */
+bool isAmbientLight() {
+
+  return settings.isAmbientOn() && ambientSensor.isReady() && !ambientSensor.isDark();
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function records a change to the state of the lights in the event
+ * log, timed by the clock when set or otherwise by the time since boot.
+ * 
+ * @param source What made the change, an EVENT_SOURCE as uint8_t.
+ * @param kind What changed, an EVENT_KIND as uint8_t.
+ * @param from The value before the change as uint8_t.
+ * @param to The value after the change as uint8_t.
+ */
+void logEvent(uint8_t source, uint8_t kind, uint8_t from, uint8_t to) {
+  bool isUptime = !deviceClock.isSet();
+  eventLog.record(isUptime ? millis() / 1000UL : deviceClock.getEpoch(), isUptime, source, kind, from, to);
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function marks a change to anything shown on the main page, so
+ * its cached render is no longer served.
+ */
+void bumpStateVersion() {
+  stateVersion++;
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function determines what the main page's script should do about
+ * the device clock.
+ * 
+ * @return Returns 2 to have the browser hand over its time as the time is
+ * unknown, 1 to have it refresh hand set time so its drift can be learned
+ * or 0 when nothing is needed as uint8_t.
+ */
+uint8_t getClockSyncMode() {
+  if (!deviceClock.isSet()) {
+
+    return 2;
+  }
+  if (deviceClock.getSource() == CLOCK_SOURCE_MANUAL && deviceClock.getAgeMillis() > 21600000UL) {
+
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function wraps the given web handler so that the requests it serves
+ * are recorded while a request trace capture is running. When no capture
+ * is running the only cost is taking the start time.
+ * 
+ * @param handler The web handler to wrap as THandlerFunction.
+ * 
+ * @return Returns the wrapped web handler as THandlerFunction.
+ */
+ESP8266WebServer::THandlerFunction traced(ESP8266WebServer::THandlerFunction handler) {
+  
+  return [handler]() {
+    unsigned long arrivedMillis = millis();
+    unsigned long startMicros = micros();
+    handler();
+    if (!requestTrace.isCapturing()) {
+
+      return;
+    }
+    uint32_t durationMicros = micros() - startMicros;
+
+    // Build the target from the URI and its args, leaving out any secrets
+    String target = web.uri();
+    for (int i = 0; i < web.args(); i++) {
+      target.concat(i == 0 ? '?' : '&');
+      target.concat(Utils::urlEncode(web.argName(i)));
+      target.concat('=');
+      if (isTraceableArg(web.argName(i))) {
+        target.concat(Utils::urlEncode(web.arg(i)));
+      }
+    }
+
+    char method;
+    switch (web.method()) {
+      case HTTP_POST: method = 'P'; break;
+      case HTTP_HEAD: method = 'H'; break;
+      case HTTP_PUT: method = 'U'; break;
+      case HTTP_PATCH: method = 'A'; break;
+      case HTTP_DELETE: method = 'D'; break;
+      case HTTP_OPTIONS: method = 'O'; break;
+      default: method = 'G'; break;
+    }
+    requestTrace.record(method, target, arrivedMillis, durationMicros, ESP.getFreeHeap());
+  };
+}
+
+/**
+ * UTILITY FUNCTION
+ * This function checks whether the value of the named arg may be written
+ * to the request trace. Only args listed in TRACE_ARGS may, so an arg added
+ * later is kept out of the trace until someone decides it is safe.
+ * 
+ * @param name The name of the arg as String.
+ * 
+ * @return Returns true if the value may be traced otherwise false as bool.
+ */
+bool isTraceableArg(const String &name) {
+  String key = F(",");
+  key.concat(name);
+  key.concat(',');
+
+  return String(F(TRACE_ARGS)).indexOf(key) != -1;
 }
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef FuzzCheck_h
+    #define FuzzCheck_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+
+    /*
+     * A property a fuzz target holds the code to. Failing one aborts, which
+     * libFuzzer reports as a crash along with the input that caused it.
+     */
+    #define FUZZ_CHECK(cond) \
+        do { \
+            if (!(cond)) { \
+                fprintf(stderr, "%s:%d: FUZZ_CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+                abort(); \
+            } \
+        } while (0)
+
+    extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+#endif
@@ -0,0 +1,59 @@
+/*
+    FuzzDriver - Runs a fuzz target without libFuzzer, for compilers that
+    lack it. Given files it runs each as an input, otherwise it runs random
+    inputs and reports the rate they went thru and the peak memory used.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <sys/resource.h>
+
+#include "FuzzCheck.h"
+
+#define FUZZ_DEFAULT_RUNS 200000UL
+#define FUZZ_MAX_LEN 512
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strtoul(argv[1], nullptr, 10) == 0) {
+        // Replay the given inputs, such as a crash libFuzzer found
+        for (int i = 1; i < argc; i++) {
+            std::ifstream file(argv[i], std::ios::binary);
+            std::vector<uint8_t> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(input.data(), input.size());
+            printf("Ran %s (%zu bytes)\n", argv[i], input.size());
+        }
+
+        return 0;
+    }
+
+    unsigned long runs = argc > 1 ? strtoul(argv[1], nullptr, 10) : FUZZ_DEFAULT_RUNS;
+    std::mt19937 rng(argc > 2 ? strtoul(argv[2], nullptr, 10) : 1);
+    std::vector<uint8_t> input;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long run = 0; run < runs; run++) {
+        // Half the inputs printable, as the text parsers give up early on anything else
+        input.resize(rng() % (FUZZ_MAX_LEN + 1));
+        bool isText = (run & 1) == 0;
+        for (uint8_t &b : input) {
+            b = isText ? (uint8_t)(' ' + (rng() % 95)) : (uint8_t)rng();
+        }
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("Done %lu runs in %.1f s, %.0f exec/s, peak rss %ld MB\n", runs, seconds, runs / (seconds > 0 ? seconds : 1), usage.ru_maxrss / 1024);
+
+    return 0;
+}
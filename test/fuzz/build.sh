@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# Builds the fuzz targets in test/fuzz. Run from the project root:
+#
+#   test/fuzz/build.sh [target...]
+#
+# With clang each target is a libFuzzer binary in .pio/fuzz, run for
+# example as:
+#
+#   ASAN_OPTIONS=quarantine_size_mb=1 .pio/fuzz/fuzz_args -max_total_time=300 -rss_limit_mb=64 -malloc_limit_mb=4
+#
+# libFuzzer reports exec/s and peak rss as it goes, so a change that slows
+# the request path or makes it hungry for memory shows up in the numbers,
+# and one that blows the limits fails the run. The small quarantine keeps
+# freed memory held by the address sanitizer out of the rss.
+#
+# Without clang the targets are built with g++ and FuzzDriver.cpp instead,
+# which runs random inputs, [runs] [seed], or replays the files given.
+#
+# Both builds use address and undefined behaviour sanitizers.
+
+set -e
+
+cd "$(dirname "$0")/../.."
+OUT=.pio/fuzz
+mkdir -p "$OUT"
+
+# The libraries each target needs, whole as PlatformIO would build them
+libs_for() {
+    case "$1" in
+        fuzz_args) echo "Settings Utils" ;;
+        fuzz_time) echo "Utils" ;;
+        fuzz_ip) echo "Utils" ;;
+        fuzz_template) echo "Template Utils" ;;
+        fuzz_coap) echo "Coap" ;;
+        fuzz_packets) echo "GroupControl UdpControl" ;;
+        fuzz_delta) echo "Ota" ;;
+        *) echo "Unknown fuzz target $1" >&2; exit 1 ;;
+    esac
+}
+
+if command -v clang++ > /dev/null 2>&1; then
+    CXX=clang++
+    SANITIZE="-fsanitize=fuzzer,address,undefined"
+    DRIVER=""
+else
+    CXX=g++
+    SANITIZE="-fsanitize=address,undefined"
+    DRIVER=test/fuzz/FuzzDriver.cpp
+fi
+
+INCLUDES="-I test/mock -I test/fuzz -I include"
+for dir in lib/*/; do
+    INCLUDES="$INCLUDES -I $dir"
+done
+
+TARGETS="$*"
+if [ -z "$TARGETS" ]; then
+    TARGETS=$(cd test/fuzz && ls fuzz_*.cpp | sed 's/\.cpp$//')
+fi
+
+for target in $TARGETS; do
+    SOURCES=""
+    for lib in $(libs_for "$target"); do
+        SOURCES="$SOURCES $(ls lib/$lib/*.cpp)"
+    done
+    echo "Building $OUT/$target"
+    $CXX -std=gnu++17 -g -O1 $SANITIZE $INCLUDES test/fuzz/$target.cpp $SOURCES $DRIVER -o "$OUT/$target"
+done
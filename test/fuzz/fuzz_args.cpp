@@ -0,0 +1,138 @@
+/*
+    fuzz_args - Fuzzes the settings form as doHandleIncomingArgs() takes
+    it in. The input is a form body, name=value pairs joined by '&', put
+    thru the same parsing, setters and saving the admin_save action uses.
+    The values must then come back from the settings exactly as given, or
+    not at all when too long, survive a save and load, and come out of
+    htmlEscape() unable to break the markup of the page they go into.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <map>
+
+#include "Settings.h"
+#include "Utils.h"
+#include "FuzzCheck.h"
+
+/**
+ * A string setting of the form, with the size of the field it is kept in.
+ */
+struct StringArg {
+    const char     *name                                   ;
+    size_t         fieldSize                               ;
+    void           (Settings::*set)(const char *)          ;
+    String         (Settings::*get)()                      ;
+};
+
+static const StringArg STRING_ARGS[] = {
+    {"appwd", 51, &Settings::setApPwd, &Settings::getApPwd},
+    {"ssid", 33, &Settings::setSsid, &Settings::getSsid},
+    {"pwd", 64, &Settings::setPwd, &Settings::getPwd},
+    {"adminuser", 51, &Settings::setAdminUser, &Settings::getAdminUser},
+    {"adminpwd", 51, &Settings::setAdminPwd, &Settings::getAdminPwd},
+    {"controlkey", 33, &Settings::setControlKey, &Settings::getControlKey},
+    {"mqtthost", 64, &Settings::setMqttHost, &Settings::getMqttHost},
+    {"mqttuser", 33, &Settings::setMqttUser, &Settings::getMqttUser},
+    {"mqttpwd", 33, &Settings::setMqttPwd, &Settings::getMqttPwd}
+};
+
+/**
+ * Checks an escaped value holds nothing that could end an attribute, open
+ * a tag or start a place-holder, and that each '&' begins an entity.
+ */
+static void checkEscaped(const String &escaped) {
+    static const char *ENTITIES[] = {"&amp;", "&lt;", "&gt;", "&quot;", "&#39;", "&#36;"};
+    for (unsigned int i = 0; i < escaped.length(); i++) {
+        char c = escaped.charAt(i);
+        FUZZ_CHECK(c != '<' && c != '>' && c != '"' && c != '\'' && c != '$');
+        if (c == '&') {
+            bool isEntity = false;
+            for (const char *entity : ENTITIES) {
+                isEntity = isEntity || strncmp(escaped.c_str() + i, entity, strlen(entity)) == 0;
+            }
+            FUZZ_CHECK(isEntity);
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    std::map<String, String> args;
+    size_t at = 0;
+    while (at < size) {
+        const uint8_t *amp = (const uint8_t *)memchr(data + at, '&', size - at);
+        size_t end = amp != nullptr ? (size_t)(amp - data) : size;
+        const uint8_t *eq = (const uint8_t *)memchr(data + at, '=', end - at);
+        size_t nameEnd = eq != nullptr ? (size_t)(eq - data) : end;
+        String name;
+        String value;
+        name.concat((const char *)data + at, nameEnd - at);
+        if (eq != nullptr) {
+            value.concat((const char *)data + nameEnd + 1, end - nameEnd - 1);
+        }
+        args[name] = value;
+        at = end + 1;
+    }
+    auto arg = [&](const char *name) { return args.count(name) != 0 ? args[name] : String(); };
+
+    Settings settings;
+    for (const StringArg &a : STRING_ARGS) {
+        String before = (settings.*a.get)();
+        String value = arg(a.name);
+        (settings.*a.set)(value.c_str());
+
+        // Copied whole up to any null, or left alone when it would not fit
+        size_t length = strlen(value.c_str());
+        String after = (settings.*a.get)();
+        FUZZ_CHECK(after.equals(length < a.fieldSize ? String(value.c_str()) : before));
+        checkEscaped(Utils::htmlEscape(after));
+    }
+
+    settings.setTimeZone(constrain(arg("timezone").toInt(), -12L, 14L));
+    settings.setDst(arg("dst").equalsIgnoreCase("DST"));
+    settings.setGroupId(constrain(arg("group").toInt(), 0L, 65535L));
+    settings.setMqttPort(arg("mqttport").isEmpty() ? 1883 : arg("mqttport").toInt());
+    FUZZ_CHECK(settings.getTimeZone() >= -12 && settings.getTimeZone() <= 14);
+    FUZZ_CHECK(settings.getGroupId() >= 0 && settings.getGroupId() <= 65535);
+    FUZZ_CHECK(settings.getMqttPort() >= 1 && settings.getMqttPort() <= 65535);
+
+    int vacationOnFrom = Utils::stringTimeToIntTime(arg("vaconfrom"));
+    int vacationOnTo = Utils::stringTimeToIntTime(arg("vaconto"));
+    int vacationOffFrom = Utils::stringTimeToIntTime(arg("vacofffrom"));
+    int vacationOffTo = Utils::stringTimeToIntTime(arg("vacoffto"));
+    if (vacationOnFrom != -1 && vacationOnTo != -1 && vacationOffFrom != -1 && vacationOffTo != -1) {
+        settings.setVacationOnFrom(vacationOnFrom);
+        settings.setVacationOnTo(vacationOnTo);
+        settings.setVacationOffFrom(vacationOffFrom);
+        settings.setVacationOffTo(vacationOffTo);
+    }
+    if (!arg("ambientthreshold").isEmpty()) {
+        settings.setAmbientThreshold(arg("ambientthreshold").toInt());
+    }
+    if (!arg("occupancytimeout").isEmpty()) {
+        settings.setOccupancyTimeout(arg("occupancytimeout").toInt());
+    }
+    if (!arg("warmkelvin").isEmpty() && !arg("coolkelvin").isEmpty()) {
+        settings.setWarmKelvin(arg("warmkelvin").toInt());
+        settings.setCoolKelvin(arg("coolkelvin").toInt());
+    }
+    FUZZ_CHECK(settings.getAmbientThreshold() >= 0 && settings.getAmbientThreshold() <= 1023);
+    FUZZ_CHECK(settings.getOccupancyTimeout() >= 1 && settings.getOccupancyTimeout() <= 240);
+    FUZZ_CHECK(settings.getWarmKelvin() >= 1000 && settings.getCoolKelvin() <= 10000);
+
+    // What was saved loads back the same
+    FUZZ_CHECK(settings.saveSettings());
+    Settings loaded;
+    FUZZ_CHECK(loaded.loadSettings());
+    for (const StringArg &a : STRING_ARGS) {
+        FUZZ_CHECK((loaded.*a.get)().equals((settings.*a.get)()));
+    }
+    FUZZ_CHECK(loaded.getTimeZone() == settings.getTimeZone());
+    FUZZ_CHECK(loaded.getVacationOffTo() == settings.getVacationOffTo());
+    FUZZ_CHECK(loaded.getCoolKelvin() == settings.getCoolKelvin());
+    FUZZ_CHECK(loaded.getGroupId() == settings.getGroupId());
+
+    return 0;
+}
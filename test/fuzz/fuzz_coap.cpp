@@ -0,0 +1,72 @@
+/*
+    fuzz_coap - Fuzzes the CoAP server with the resources the firmware
+    serves. The input is a run of packets, each after a byte giving its
+    length, sent from a few addresses with time passing in between, so
+    observers come and go as they would on a network.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+#include "CoapServer.h"
+#include "FuzzCheck.h"
+
+static bool lightsOn = false;
+static int level = 50;
+
+static size_t getLight(char *buffer, size_t size) {
+
+    return snprintf(buffer, size, "{\"on\":%s,\"level\":%d}", lightsOn ? "true" : "false", level);
+}
+
+static uint8_t putLight(const char *payload, size_t length) {
+    if (length == 2 && memcmp(payload, "on", 2) == 0) {
+        lightsOn = true;
+    } else if (length == 3 && memcmp(payload, "off", 3) == 0) {
+        lightsOn = false;
+    } else {
+
+        return COAP_BAD_REQUEST;
+    }
+
+    return COAP_CHANGED;
+}
+
+static size_t getStatus(char *buffer, size_t size) {
+    // Larger than the room left in a packet at times
+    return snprintf(buffer, size, "{\"v\":%lu,\"pad\":\"%0*d\"}", millis(), level * 4, 0);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    mockUdpReset();
+    CoapServer coap;
+    coap.on("/light", getLight, putLight);
+    coap.on("/status", getStatus);
+    coap.begin();
+
+    size_t at = 0;
+    while (at < size) {
+        size_t length = std::min((size_t)data[at], size - at - 1);
+        uint8_t from = length > 0 ? data[at + 1] & 0x03 : 0;
+        mockUdpDeliver(COAP_PORT, IPAddress(192, 168, 1, 10 + from), 50000 + from, data + at + 1, length);
+        at += length + 1;
+
+        coap.handle();
+        level = (level + 37) % 101;
+        coap.notifyChanged();
+        mockAdvanceMillis(length * 10000UL);
+        FUZZ_CHECK(coap.getObserverCount() <= COAP_MAX_OBSERVERS);
+    }
+
+    for (const MockUdpPacket &sent : mockUdpSent) {
+        // Every answer is a well formed CoAP header inside one packet
+        FUZZ_CHECK(sent.data.size() >= 4 && sent.data.size() <= COAP_MAX_PACKET);
+        FUZZ_CHECK((sent.data[0] >> 6) == 1);
+        FUZZ_CHECK((sent.data[0] & 0x0F) <= COAP_MAX_TOKEN);
+    }
+
+    return 0;
+}
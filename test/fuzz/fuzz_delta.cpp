@@ -0,0 +1,72 @@
+/*
+    fuzz_delta - Fuzzes the decoding of delta updates against a running
+    image. When the low bit of the first byte is clear the header is made
+    to match the running image, so the fuzzer spends its time on the ops
+    rather than on guessing an MD5. The delta is fed in pieces of sizes
+    taken from the second byte, as it would come off the network.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <vector>
+
+#include "DeltaDecoder.h"
+#include "FakeFlashBackend.h"
+#include "FuzzCheck.h"
+
+#define FUZZ_BASE_SIZE 4096
+#define FUZZ_TARGET_MAX 65536
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size < 2) {
+
+        return 0;
+    }
+    static FakeFlashBackend backend;
+    static String baseMd5;
+    if (backend.current.empty()) {
+        for (size_t i = 0; i < FUZZ_BASE_SIZE; i++) {
+            backend.current.push_back((uint8_t)((i * 131) ^ (i >> 5)));
+        }
+        baseMd5 = backend.getCurrentMd5();
+    }
+
+    bool isFixedUp = (data[0] & 1) == 0;
+    size_t piece = (data[1] % 64) + 1;
+    std::vector<uint8_t> delta(data + 2, data + size);
+    if (isFixedUp && delta.size() >= DELTA_HEADER_SIZE) {
+        memcpy(delta.data(), DELTA_MAGIC, 4);
+        delta[4] = DELTA_VERSION;
+        for (int i = 0; i < 4; i++) {
+            delta[8 + i] = (FUZZ_BASE_SIZE >> (8 * i)) & 0xFF;
+        }
+        // Target size kept small enough to be worth rebuilding
+        delta[14] = 0;
+        delta[15] = 0;
+        for (int i = 0; i < 16; i++) {
+            delta[16 + i] = (uint8_t)strtoul(baseMd5.substring(i * 2, (i * 2) + 2).c_str(), nullptr, 16);
+        }
+    }
+
+    size_t outputSize = 0;
+    DeltaDecoder decoder(backend);
+    decoder.begin([&](const uint8_t *out, size_t len) {
+        FUZZ_CHECK(len > 0 && out != nullptr);
+        outputSize += len;
+
+        return outputSize <= FUZZ_TARGET_MAX;
+    });
+
+    bool ok = true;
+    for (size_t at = 0; ok && at < delta.size(); at += piece) {
+        ok = decoder.feed(delta.data() + at, std::min(piece, delta.size() - at));
+    }
+    if (ok) {
+        ok = decoder.finish();
+    }
+    FUZZ_CHECK(ok == decoder.getError().isEmpty());
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+/*
+    fuzz_ip - Fuzzes the parsing of the dotted IPv4 addresses the settings
+    hold.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+
+#include "IpUtils.h"
+#include "FuzzCheck.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    String input;
+    input.concat((const char *)data, size);
+
+    IPAddress ip = IpUtils::stringIPv4ToIPAddress(input);
+    IPAddress expected;
+    bool isCanonical = expected.fromString(input) && expected.toString().equals(input);
+    if (isCanonical) {
+        // A well formed address always comes back as itself
+        FUZZ_CHECK(ip == expected);
+    }
+    if ((uint32_t)ip != 0) {
+        // Anything else accepted is at least dots and digits making an address
+        FUZZ_CHECK(IpUtils::stringIPv4ToIPAddress(ip.toString()) == ip);
+        for (size_t i = 0; i < size; i++) {
+            FUZZ_CHECK(data[i] == '.' || isdigit(data[i]));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+    fuzz_template - Fuzzes the filling in of pages. The first part of the
+    input is used as a page of its own, split up by PageTemplate, and the
+    rest gives values for the place-holders of it and of the real pages.
+    Whatever the values, a page either goes out exactly as long as it said
+    it would be, or is refused whole.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <string>
+#include <vector>
+
+#include "PageTemplate.h"
+#include "HtmlContent.h"
+#include "Utils.h"
+#include "FuzzCheck.h"
+
+/**
+ * Finds the names of the place-holders in a page, as a handler would set.
+ */
+static std::vector<std::string> findNames(const char *page) {
+    std::vector<std::string> names;
+    for (const char *at = strstr(page, "${"); at != nullptr; at = strstr(at + 2, "${")) {
+        const char *end = strchr(at + 2, '}');
+        if (end == nullptr) {
+
+            break;
+        }
+        names.push_back(std::string(at + 2, end - at - 2));
+    }
+
+    return names;
+}
+
+/**
+ * Fills in every place-holder of the page from the input, escaped as the
+ * handlers do, sends it and checks what went out.
+ */
+static void fillAndSend(const char *page, const uint8_t *data, size_t size, bool isEscaped) {
+    PageTemplate content(page);
+    size_t at = 0;
+    for (const std::string &name : findNames(page)) {
+        size_t length = at < size ? data[at] % 64 : 0;
+        length = std::min(length, size - std::min(at + 1, size));
+        String value;
+        value.concat((const char *)data + std::min(at + 1, size), length);
+        content.set(F(name.c_str()), isEscaped ? Utils::htmlEscape(value) : value);
+        at += length + 1;
+    }
+
+    ESP8266WebServer web;
+    content.send(web, 200, F("text/html"));
+    if (web.mockCode != 200) {
+        FUZZ_CHECK(web.mockCode == 500 && !(content.isValid() && content.isComplete()));
+
+        return;
+    }
+    FUZZ_CHECK(web.mockContentLength == web.mockBody.length());
+    FUZZ_CHECK(web.mockContentLength == content.getLength());
+    if (isEscaped) {
+        // Escaped values can not bring in a place-holder of their own
+        FUZZ_CHECK(web.mockBody.indexOf("${") == -1);
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size < 2) {
+
+        return 0;
+    }
+
+    // A page of the fuzzer's own, its length given by the first two bytes
+    size_t pageLength = std::min((size_t)(data[0] | (data[1] << 8)), size - 2);
+    std::string page((const char *)data + 2, pageLength);
+    fillAndSend(page.c_str(), data + 2 + pageLength, size - 2 - pageLength, false);
+
+    // The real pages with the rest as values
+    fillAndSend(MAIN_PAGE, data + 2 + pageLength, size - 2 - pageLength, true);
+    fillAndSend(SETTINGS_PAGE, data + 2 + pageLength, size - 2 - pageLength, true);
+
+    return 0;
+}
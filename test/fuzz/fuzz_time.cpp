@@ -0,0 +1,30 @@
+/*
+    fuzz_time - Fuzzes the parsing of the HH:MM times the timer and
+    vacation forms post.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+
+#include "Utils.h"
+#include "FuzzCheck.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    String input;
+    input.concat((const char *)data, size);
+
+    int time24 = Utils::stringTimeToIntTime(input);
+    if (time24 == -1) {
+
+        return 0;
+    }
+    FUZZ_CHECK(time24 >= 0 && time24 <= 2359 && time24 % 100 <= 59);
+
+    // What the pages show parses back to the same time
+    FUZZ_CHECK(Utils::stringTimeToIntTime(Utils::intTimeToStringTime(time24)) == time24);
+    FUZZ_CHECK(Utils::intTimeToString12Time(time24).length() <= 8);
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#ifndef Arduino_h
+    #define Arduino_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdarg.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <math.h>
+    #include <algorithm>
+    #include <vector>
+
+    #include <WString.h>
+    #include <pgmspace.h>
+    #include <IPAddress.h>
+    #include <MD5Builder.h>
+
+    #define HIGH 0x1
+    #define LOW 0x0
+    #define INPUT 0x00
+    #define OUTPUT 0x01
+    #define INPUT_PULLUP 0x02
+    #define LED_BUILTIN 2
+    #define A0 17
+    #define MOCK_PINS 18
+
+    #define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+    using std::min;
+    using std::max;
+
+    // newlib has strlcpy, older glibc does not
+    inline size_t mockStrlcpy(char *dst, const char *src, size_t size) {
+        size_t length = strlen(src);
+        if (size > 0) {
+            size_t count = length < size - 1 ? length : size - 1;
+            memcpy(dst, src, count);
+            dst[count] = '\0';
+        }
+
+        return length;
+    }
+    #define strlcpy mockStrlcpy
+
+    /*
+     * The virtual clock and pins every host test drives. Time only moves when
+     * a test moves it, or when the code under test calls delay(), so a year
+     * of schedule runs in as long as it takes to evaluate it.
+     */
+    inline unsigned long mockMillis = 0;
+    inline uint8_t mockPinModes[MOCK_PINS] = {};
+    inline int mockPinLevels[MOCK_PINS] = {};
+    inline uint32_t mockRandomState = 1;
+
+    // Lets code that times itself see each call to micros() take a while
+    inline unsigned long mockMicrosPerCall = 0;
+    inline unsigned long mockMicrosSpent = 0;
+
+    inline void mockAdvanceMillis(unsigned long ms) { mockMillis += ms; }
+    inline unsigned long millis() { return mockMillis; }
+    inline unsigned long micros() { mockMicrosSpent += mockMicrosPerCall; return (mockMillis * 1000UL) + mockMicrosSpent; }
+    inline void delay(unsigned long ms) { mockMillis += ms; }
+    inline void yield() {}
+
+    inline void pinMode(uint8_t pin, uint8_t mode) { mockPinModes[pin % MOCK_PINS] = mode; }
+    inline void digitalWrite(uint8_t pin, uint8_t level) { mockPinLevels[pin % MOCK_PINS] = level; }
+    inline int digitalRead(uint8_t pin) { return mockPinLevels[pin % MOCK_PINS]; }
+    inline int analogRead(uint8_t pin) { return mockPinLevels[pin % MOCK_PINS]; }
+    inline void analogWrite(uint8_t pin, int level) { mockPinLevels[pin % MOCK_PINS] = level; }
+    inline void analogWriteRange(uint32_t) {}
+    inline void analogWriteFreq(uint32_t) {}
+
+    inline void randomSeed(unsigned long seed) { mockRandomState = seed != 0 ? (uint32_t)seed : 1; }
+    inline long random(long howBig) {
+        if (howBig <= 0) {
+
+            return 0;
+        }
+        // xorshift32, the same numbers every run for the same seed
+        mockRandomState ^= mockRandomState << 13;
+        mockRandomState ^= mockRandomState >> 17;
+        mockRandomState ^= mockRandomState << 5;
+
+        return (long)(mockRandomState % (uint32_t)howBig);
+    }
+    inline long random(long howSmall, long howBig) { return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall); }
+
+    /**
+     * Host stand in for Print. Output is dropped unless mockPrintEcho is set,
+     * which keeps test runs quiet but lets a failing one be looked into.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    inline bool mockPrintEcho = false;
+
+    class Print {
+        public:
+            virtual ~Print() {}
+            virtual size_t write(uint8_t c) { return write(&c, 1); }
+            virtual size_t write(const uint8_t *buffer, size_t size) {
+                if (mockPrintEcho) {
+                    fwrite(buffer, 1, size, stdout);
+                }
+
+                return size;
+            }
+            size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+            size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+            size_t print(const __FlashStringHelper *s) { return print((const char *)s); }
+            size_t print(char c) { return write((uint8_t)c); }
+            size_t print(int v) { return print(String(v)); }
+            size_t print(unsigned int v) { return print(String(v)); }
+            size_t print(long v) { return print(String(v)); }
+            size_t print(unsigned long v) { return print(String(v)); }
+            size_t print(double v) { return print(String(v)); }
+            template <typename T> size_t println(const T &v) { return print(v) + println(); }
+            size_t println() { return print("\r\n"); }
+            size_t printf(const char *format, ...) {
+                char buffer[256];
+                va_list args;
+                va_start(args, format);
+                int len = vsnprintf(buffer, sizeof(buffer), format, args);
+                va_end(args);
+
+                return len < 0 ? 0 : write((const uint8_t *)buffer, strlen(buffer));
+            }
+    };
+
+    class Stream : public Print {
+        public:
+            virtual int available() { return 0; }
+            virtual int read() { return -1; }
+            virtual int peek() { return -1; }
+            size_t readBytes(uint8_t *buffer, size_t length) {
+                size_t count = 0;
+                while (count < length && available() > 0) {
+                    buffer[count++] = (uint8_t)read();
+                }
+
+                return count;
+            }
+            size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+    };
+
+    class HardwareSerial : public Stream {
+        public:
+            void begin(unsigned long) {}
+            void flush() {}
+    };
+
+    inline HardwareSerial Serial;
+
+    /*
+     * What a test can set up for the ESP class: the sketch flash reads come
+     * from, the RTC user memory that survives a "reboot" and the free heap.
+     */
+    inline std::vector<uint8_t> mockSketch;
+    inline uint32_t mockRtcMemory[128] = {};
+    inline uint32_t mockFreeHeap = 40000;
+
+    /**
+     * Host stand in for the parts of EspClass the libraries use.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class EspClass {
+        public:
+            void restart() {}
+            uint32_t getChipId() { return 0x00C0FFEE; }
+            uint32_t getFreeHeap() { return mockFreeHeap; }
+            uint16_t getMaxFreeBlockSize() { return (uint16_t)std::min(mockFreeHeap, (uint32_t)0xFFFF); }
+            uint8_t getHeapFragmentation() { return 0; }
+            uint32_t getFreeSketchSpace() { return 1024UL * 1024UL; }
+            uint32_t random() { return (uint32_t)::random(0x7FFFFFFF); }
+            String getResetReason() { return String("Power On"); }
+
+            uint32_t getSketchSize() { return (uint32_t)mockSketch.size(); }
+            String getSketchMD5() {
+                MD5Builder md5;
+                md5.begin();
+                for (size_t at = 0; at < mockSketch.size(); at += 0x8000) {
+                    md5.add(mockSketch.data() + at, (uint16_t)std::min(mockSketch.size() - at, (size_t)0x8000));
+                }
+                md5.calculate();
+
+                return md5.toString();
+            }
+            bool flashRead(uint32_t address, uint8_t *data, size_t size) {
+                if (address > mockSketch.size() || size > mockSketch.size() - address) {
+
+                    return false;
+                }
+                memcpy(data, mockSketch.data() + address, size);
+
+                return true;
+            }
+
+            bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size) {
+                if (offset * 4 + size > sizeof(mockRtcMemory)) {
+
+                    return false;
+                }
+                memcpy(data, (const uint8_t *)mockRtcMemory + offset * 4, size);
+
+                return true;
+            }
+            bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size) {
+                if (offset * 4 + size > sizeof(mockRtcMemory)) {
+
+                    return false;
+                }
+                memcpy((uint8_t *)mockRtcMemory + offset * 4, data, size);
+
+                return true;
+            }
+    };
+
+    inline EspClass ESP;
+
+#endif
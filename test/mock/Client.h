@@ -0,0 +1,24 @@
+#ifndef Client_h
+    #define Client_h
+
+    #include <Arduino.h>
+
+    /**
+     * Host stand in for the Client base of the Arduino core. Nothing goes
+     * over it, the mocks built on it script what the other end does.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class Client : public Stream {
+        private:
+            unsigned long  timeout         ;
+
+        public:
+            Client() : timeout(1000) {}
+
+            void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+            unsigned long getTimeout() { return timeout; }
+    };
+
+#endif
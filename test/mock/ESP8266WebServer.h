@@ -0,0 +1,58 @@
+#ifndef ESP8266WebServer_h
+    #define ESP8266WebServer_h
+
+    #include <Arduino.h>
+    #include <map>
+
+    #define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+
+    /**
+     * Host stand in for the parts of ESP8266WebServer a page is sent with.
+     * Each response is gathered up so a test can look at what went out:
+     * the code, the content type, the length announced and the body.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class ESP8266WebServer {
+        public:
+            std::map<String, String> mockArgs;
+            int            mockCode                ;
+            String         mockContentType         ;
+            size_t         mockContentLength       ;
+            String         mockBody                ;
+            size_t         mockWrites              ;
+
+            ESP8266WebServer(int = 80) { mockReset(); }
+
+            void mockReset() {
+                mockCode = 0;
+                mockContentType = "";
+                mockContentLength = CONTENT_LENGTH_UNKNOWN;
+                mockBody = "";
+                mockWrites = 0;
+            }
+
+            bool hasArg(const String &name) { return mockArgs.count(name) != 0; }
+            String arg(const String &name) { return hasArg(name) ? mockArgs[name] : String(); }
+            int args() { return (int)mockArgs.size(); }
+
+            void setContentLength(size_t length) { mockContentLength = length; }
+
+            void send(int code, const char *contentType, const String &content) {
+                mockCode = code;
+                mockContentType = contentType;
+                mockBody = content;
+            }
+            void send(int code, const __FlashStringHelper *contentType, const String &content) { send(code, (const char *)contentType, content); }
+            void send(int code, const __FlashStringHelper *contentType, const __FlashStringHelper *content) { send(code, (const char *)contentType, String(content)); }
+            void send(int code, const char *contentType, const char *content) { send(code, contentType, String(content)); }
+
+            void sendContent(const char *content, size_t length) {
+                mockBody.concat(content, (unsigned int)length);
+                mockWrites++;
+            }
+            void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+    };
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef ESP8266WiFi_h
+    #define ESP8266WiFi_h
+
+    #include <Arduino.h>
+    #include <IPAddress.h>
+    #include <Client.h>
+
+    /**
+     * Host stand in for WiFiClient. Libraries only hand it on to a client
+     * of some protocol, which the tests mock as a whole.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class WiFiClient : public Client {};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef ESP_EEPROM_h
+    #define ESP_EEPROM_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <string.h>
+    #include <map>
+    #include <vector>
+
+    /**
+     * Host stand in for ESP_EEPROM. Like the real library what was committed
+     * can only be read back with begin() given the same size, any other size
+     * finds the storage empty, so settings layouts of different lengths can
+     * be tested. The storage lives in mockFlash and survives the object.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class EEPROMClass {
+        private:
+            size_t                  size            ;
+            std::vector<uint8_t>    buffer          ;
+
+        public:
+            std::map<size_t, std::vector<uint8_t>> mockFlash;
+
+            EEPROMClass() : size(0) {}
+
+            void begin(size_t size) {
+                this->size = (size + 3) & ~3;
+                auto it = mockFlash.find(this->size);
+                buffer = it == mockFlash.end() ? std::vector<uint8_t>(this->size, 0xFF) : it->second;
+            }
+
+            int percentUsed() { return mockFlash.count(size) != 0 ? 1 : -1; }
+            uint8_t read(int address) { return (size_t)address < size ? buffer[address] : 0; }
+            void write(int address, uint8_t value) { if ((size_t)address < size) buffer[address] = value; }
+
+            template <typename T> T &get(int address, T &t) {
+                if (address + sizeof(T) <= size) {
+                    memcpy((void *)&t, &buffer[address], sizeof(T));
+                }
+
+                return t;
+            }
+
+            template <typename T> const T &put(int address, const T &t) {
+                if (address + sizeof(T) <= size) {
+                    memcpy(&buffer[address], (const void *)&t, sizeof(T));
+                }
+
+                return t;
+            }
+
+            bool commit() {
+                mockFlash[size] = buffer;
+
+                return true;
+            }
+
+            bool wipe() {
+                mockFlash.clear();
+
+                return true;
+            }
+
+            void end() {}
+    };
+
+    inline EEPROMClass EEPROM;
+
+#endif
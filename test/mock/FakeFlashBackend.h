@@ -0,0 +1,93 @@
+#ifndef FakeFlashBackend_h
+    #define FakeFlashBackend_h
+
+    #include <Arduino.h>
+    #include <MD5Builder.h>
+    #include <vector>
+
+    #include "FlashBackend.h"
+
+    /**
+     * The FakeFlashBackend class stands in for the flash on the host. The
+     * running image is whatever the test puts in current and everything
+     * written is recorded in written, along with how it was written.
+     * Writes can be made to fail after a given number of bytes.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class FakeFlashBackend : public FlashBackend {
+        public:
+            std::vector<uint8_t> current;
+            std::vector<uint8_t> written;
+            size_t         maxSize                 ;
+            size_t         writeCalls              ;
+            size_t         failWriteAt             ; // SIZE_MAX never fails
+            bool           begun                   ;
+            bool           committed               ;
+            bool           aborted                 ;
+
+            FakeFlashBackend() : maxSize(0), writeCalls(0), failWriteAt(SIZE_MAX), begun(false), committed(false), aborted(false) {}
+
+            bool begin(size_t maxSize) override {
+                this->maxSize = maxSize;
+                written.clear();
+                writeCalls = 0;
+                begun = true;
+                committed = false;
+                aborted = false;
+
+                return true;
+            }
+
+            bool write(const uint8_t *data, size_t len) override {
+                writeCalls++;
+                if (!begun || written.size() + len > maxSize || written.size() + len > failWriteAt) {
+
+                    return false;
+                }
+                written.insert(written.end(), data, data + len);
+
+                return true;
+            }
+
+            bool commit() override {
+                committed = begun;
+                begun = false;
+
+                return committed;
+            }
+
+            void abort() override {
+                aborted = true;
+                begun = false;
+            }
+
+            bool readCurrent(size_t offset, uint8_t *data, size_t len) override {
+                if (offset > current.size() || len > current.size() - offset) {
+
+                    return false;
+                }
+                memcpy(data, current.data() + offset, len);
+
+                return true;
+            }
+
+            size_t getCurrentSize() override {
+
+                return current.size();
+            }
+
+            String getCurrentMd5() override {
+                MD5Builder md5;
+                md5.begin();
+                for (size_t at = 0; at < current.size(); at += 0x8000) {
+                    md5.add(current.data() + at, (uint16_t)std::min(current.size() - at, (size_t)0x8000));
+                }
+                md5.calculate();
+
+                return md5.toString();
+            }
+    };
+
+#endif
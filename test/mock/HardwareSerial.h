@@ -0,0 +1,7 @@
+#ifndef HardwareSerial_h
+    #define HardwareSerial_h
+
+    // Serial is part of the Arduino.h stand in
+    #include <Arduino.h>
+
+#endif
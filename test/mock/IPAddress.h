@@ -0,0 +1,53 @@
+#ifndef IPAddress_h
+    #define IPAddress_h
+
+    #include <stdint.h>
+    #include <stdio.h>
+    #include <WString.h>
+
+    /**
+     * Host stand in for the IPv4 IPAddress of the ESP8266 core. The address
+     * is held as the uint32_t lwIP uses, first octet in the low byte.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class IPAddress {
+        private:
+            uint32_t       address         ;
+
+        public:
+            IPAddress() : address(0) {}
+            IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+            IPAddress(uint32_t address) : address(address) {}
+
+            operator uint32_t() const { return address; }
+            uint8_t operator[](int i) const { return (uint8_t)(address >> (8 * i)); }
+            bool operator==(const IPAddress &o) const { return address == o.address; }
+            bool operator!=(const IPAddress &o) const { return address != o.address; }
+            bool isSet() const { return address != 0; }
+
+            bool fromString(const char *s) {
+                unsigned int oct[4];
+                char tail;
+                if (sscanf(s, "%u.%u.%u.%u%c", &oct[0], &oct[1], &oct[2], &oct[3], &tail) != 4 || oct[0] > 255 || oct[1] > 255 || oct[2] > 255 || oct[3] > 255) {
+
+                    return false;
+                }
+                *this = IPAddress(oct[0], oct[1], oct[2], oct[3]);
+
+                return true;
+            }
+            bool fromString(const String &s) { return fromString(s.c_str()); }
+
+            String toString() const {
+                char buffer[16];
+                snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+
+                return String(buffer);
+            }
+    };
+
+    #define INADDR_ANY IPAddress()
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef LittleFS_h
+    #define LittleFS_h
+
+    #include <Arduino.h>
+    #include <map>
+    #include <string>
+
+    /*
+     * The files a test sees and sets up, kept in memory. mockFsMountable
+     * decides whether begin() works and mockFsWriteLimit is how many more
+     * bytes can be written before writes fail, as with a full flash or the
+     * power going mid-write.
+     */
+    inline std::map<std::string, std::vector<uint8_t>> mockFsFiles;
+    inline bool mockFsMountable = true;
+    inline size_t mockFsWriteLimit = SIZE_MAX;
+
+    inline void mockFsReset() {
+        mockFsFiles.clear();
+        mockFsMountable = true;
+        mockFsWriteLimit = SIZE_MAX;
+    }
+
+    /**
+     * Host stand in for a LittleFS file, reading and writing the one kept
+     * in mockFsFiles.
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class File : public Stream {
+        private:
+            std::string    path            ;
+            size_t         at              ;
+            bool           isOpen          ;
+
+        public:
+            File() : at(0), isOpen(false) {}
+            File(const std::string &path) : path(path), at(0), isOpen(true) {}
+
+            explicit operator bool() const { return isOpen; }
+
+            size_t write(uint8_t c) override { return write(&c, 1); }
+            size_t write(const uint8_t *buffer, size_t size) override {
+                if (!isOpen) {
+
+                    return 0;
+                }
+                size_t count = std::min(size, mockFsWriteLimit);
+                mockFsWriteLimit -= mockFsWriteLimit == SIZE_MAX ? 0 : count;
+                std::vector<uint8_t> &data = mockFsFiles[path];
+                data.insert(data.end(), buffer, buffer + count);
+
+                return count;
+            }
+            int available() override { return isOpen ? (int)(mockFsFiles[path].size() - at) : 0; }
+            int read() override {
+                uint8_t c;
+
+                return read(&c, 1) == 1 ? c : -1;
+            }
+            size_t read(uint8_t *buffer, size_t size) {
+                if (!isOpen) {
+
+                    return 0;
+                }
+                const std::vector<uint8_t> &data = mockFsFiles[path];
+                size_t count = std::min(size, data.size() - at);
+                memcpy(buffer, data.data() + at, count);
+                at += count;
+
+                return count;
+            }
+            size_t size() { return isOpen ? mockFsFiles[path].size() : 0; }
+            void close() { isOpen = false; }
+    };
+
+    /**
+     * Host stand in for the LittleFS file system over mockFsFiles.
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class FS {
+        private:
+            bool           isMounted       ;
+
+        public:
+            FS() : isMounted(false) {}
+
+            bool begin() {
+                isMounted = mockFsMountable;
+
+                return isMounted;
+            }
+            void end() { isMounted = false; }
+
+            File open(const char *path, const char *mode) {
+                if (!isMounted) {
+
+                    return File();
+                }
+                if (mode[0] == 'r') {
+
+                    return mockFsFiles.count(path) != 0 ? File(path) : File();
+                }
+                if (mode[0] == 'w') {
+                    mockFsFiles[path].clear();
+                }
+
+                return File(path);
+            }
+            bool exists(const char *path) { return isMounted && mockFsFiles.count(path) != 0; }
+            bool remove(const char *path) { return isMounted && mockFsFiles.erase(path) != 0; }
+            bool rename(const char *from, const char *to) {
+                auto file = mockFsFiles.find(from);
+                if (!isMounted || file == mockFsFiles.end()) {
+
+                    return false;
+                }
+                mockFsFiles[to] = file->second;
+                mockFsFiles.erase(from);
+
+                return true;
+            }
+    };
+
+    inline FS LittleFS;
+
+#endif
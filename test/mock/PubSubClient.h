@@ -0,0 +1,204 @@
+#ifndef PubSubClient_h
+    #define PubSubClient_h
+
+    #include <Arduino.h>
+    #include <Client.h>
+    #include <deque>
+    #include <functional>
+    #include <map>
+    #include <set>
+    #include <string>
+
+    #define MQTT_CONNECTION_LOST -3
+    #define MQTT_CONNECT_FAILED -2
+    #define MQTT_DISCONNECTED -1
+    #define MQTT_CONNECTED 0
+
+    #define MQTT_CALLBACK_SIGNATURE std::function<void(char *, uint8_t *, unsigned int)> callback
+
+    /*
+     * A test plays the broker: mockMqttBrokerUp decides whether it can be
+     * reached, mockMqttRetained is what it holds, mockMqttInbox is what it
+     * has yet to hand to subscribers and mockMqttPublished is everything
+     * it was sent. mockMqttConnectAt has the time of every connect.
+     */
+    struct MockMqttMessage {
+        std::string    topic           ;
+        std::string    payload         ;
+        bool           retained        ;
+    };
+
+    inline bool mockMqttBrokerUp = true;
+    inline std::map<std::string, std::string> mockMqttRetained;
+    inline std::deque<MockMqttMessage> mockMqttInbox;
+    inline std::vector<MockMqttMessage> mockMqttPublished;
+    inline std::vector<unsigned long> mockMqttConnectAt;
+
+    inline void mockMqttReset() {
+        mockMqttBrokerUp = true;
+        mockMqttRetained.clear();
+        mockMqttInbox.clear();
+        mockMqttPublished.clear();
+        mockMqttConnectAt.clear();
+    }
+
+    /**
+     * Host stand in for PubSubClient, talking to the scripted broker above.
+     * Like the real one, loop() hands over at most one message a call and
+     * a broker that goes away is only noticed by connected().
+     *
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class PubSubClient {
+        private:
+            MQTT_CALLBACK_SIGNATURE;
+            bool                           isUp            ;
+            int                            lastState       ;
+            std::set<std::string>          subscriptions   ;
+            std::deque<MockMqttMessage>    pending         ;
+            MockMqttMessage                will            ;
+            MockMqttMessage                outgoing        ;
+
+            bool take(MockMqttMessage message) {
+                if (!callback || subscriptions.count(message.topic) == 0) {
+
+                    return false;
+                }
+                std::vector<uint8_t> payload(message.payload.begin(), message.payload.end());
+                callback((char *)message.topic.c_str(), payload.data(), payload.size());
+
+                return true;
+            }
+
+            void record(const MockMqttMessage &message) {
+                mockMqttPublished.push_back(message);
+                if (message.retained) {
+                    mockMqttRetained[message.topic] = message.payload;
+                }
+            }
+
+        public:
+            PubSubClient(Client &) : isUp(false), lastState(MQTT_DISCONNECTED) {}
+
+            PubSubClient &setServer(const char *, uint16_t) { return *this; }
+            PubSubClient &setCallback(MQTT_CALLBACK_SIGNATURE) {
+                this->callback = callback;
+
+                return *this;
+            }
+
+            bool connect(const char *, const char *, const char *, const char *willTopic, uint8_t, bool willRetain, const char *willMessage) {
+                mockMqttConnectAt.push_back(millis());
+                if (!mockMqttBrokerUp) {
+                    lastState = MQTT_CONNECT_FAILED;
+
+                    return false;
+                }
+                isUp = true;
+                lastState = MQTT_CONNECTED;
+                subscriptions.clear();
+                pending.clear();
+                will = {willTopic ? willTopic : "", willMessage ? willMessage : "", willRetain};
+
+                return true;
+            }
+
+            void disconnect() {
+                isUp = false;
+                lastState = MQTT_DISCONNECTED;
+            }
+
+            bool connected() {
+                if (isUp && !mockMqttBrokerUp) {
+                    // Dropped, the broker speaks the last will
+                    isUp = false;
+                    lastState = MQTT_CONNECTION_LOST;
+                    if (!will.topic.empty()) {
+                        record(will);
+                    }
+                }
+
+                return isUp;
+            }
+
+            int state() { return lastState; }
+
+            bool loop() {
+                if (!connected()) {
+
+                    return false;
+                }
+                if (!pending.empty()) {
+                    MockMqttMessage message = pending.front();
+                    pending.pop_front();
+                    take(message);
+
+                    return true;
+                }
+                for (auto it = mockMqttInbox.begin(); it != mockMqttInbox.end(); ++it) {
+                    if (subscriptions.count(it->topic) != 0) {
+                        MockMqttMessage message = *it;
+                        mockMqttInbox.erase(it);
+                        take(message);
+                        break;
+                    }
+                }
+
+                return true;
+            }
+
+            bool subscribe(const char *topic) {
+                if (!connected()) {
+
+                    return false;
+                }
+                subscriptions.insert(topic);
+                auto retained = mockMqttRetained.find(topic);
+                if (retained != mockMqttRetained.end()) {
+                    pending.push_back({retained->first, retained->second, true});
+                }
+
+                return true;
+            }
+
+            bool unsubscribe(const char *topic) {
+                subscriptions.erase(topic);
+
+                return connected();
+            }
+
+            bool publish(const char *topic, const char *payload, bool retained) {
+                if (!connected()) {
+
+                    return false;
+                }
+                record({topic, payload, retained});
+
+                return true;
+            }
+
+            bool beginPublish(const char *topic, unsigned int, bool retained) {
+                outgoing = {topic, "", retained};
+
+                return connected();
+            }
+
+            size_t write(const uint8_t *buffer, size_t size) {
+                outgoing.payload.append((const char *)buffer, size);
+
+                return size;
+            }
+
+            int endPublish() {
+                if (!connected()) {
+
+                    return 0;
+                }
+                record(outgoing);
+
+                return 1;
+            }
+    };
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef Updater_h
+    #define Updater_h
+
+    #include <Arduino.h>
+
+    #define U_FLASH 0
+
+    /**
+     * Host stand in for the Updater of the ESP8266 core, gathering what is
+     * written in memory. Built for EspFlashBackend, the host tests use a
+     * FakeFlashBackend rather than going thru it.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class UpdaterClass {
+        public:
+            std::vector<uint8_t> mockImage;
+            size_t         mockMaxSize             ;
+            bool           mockRunning             ;
+            bool           mockCommitted           ;
+
+            UpdaterClass() : mockMaxSize(0), mockRunning(false), mockCommitted(false) {}
+
+            bool begin(size_t maxSize, int = U_FLASH) {
+                mockImage.clear();
+                mockMaxSize = maxSize;
+                mockRunning = true;
+                mockCommitted = false;
+
+                return true;
+            }
+
+            size_t write(uint8_t *data, size_t len) {
+                if (!mockRunning || mockImage.size() + len > mockMaxSize) {
+
+                    return 0;
+                }
+                mockImage.insert(mockImage.end(), data, data + len);
+
+                return len;
+            }
+
+            bool end(bool evenIfRemaining = false) {
+                mockCommitted = mockRunning && evenIfRemaining;
+                mockRunning = false;
+
+                return mockCommitted;
+            }
+
+            bool isRunning() { return mockRunning; }
+            void clearError() {}
+    };
+
+    inline UpdaterClass Update;
+
+#endif
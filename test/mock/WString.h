@@ -0,0 +1,165 @@
+#ifndef WString_h
+    #define WString_h
+
+    #include <stdint.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <ctype.h>
+    #include <string>
+
+    #define HEX 16
+    #define DEC 10
+
+    class __FlashStringHelper;
+    #define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+    #define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+
+    /**
+     * Host stand in for the Arduino String, kept in a std::string. Only
+     * what the libraries use is here, behaving as the ESP8266 core does.
+     */
+    class String {
+        private:
+            std::string    s               ;
+
+            static std::string fromNumber(unsigned long long value, bool negative, unsigned char base) {
+                std::string digits;
+                do {
+                    int digit = (int)(value % base);
+                    digits.insert(digits.begin(), (char)(digit < 10 ? '0' + digit : 'a' + digit - 10));
+                    value /= base;
+                } while (value > 0);
+
+                return negative ? "-" + digits : digits;
+            }
+
+            static std::string fromSigned(long long value, unsigned char base) {
+                if (base == 10 && value < 0) {
+
+                    return fromNumber((unsigned long long)(-value), true, base);
+                }
+
+                return fromNumber((unsigned long long)(unsigned long)value, false, base);
+            }
+
+        public:
+            String() {}
+            String(const char *c) : s(c != nullptr ? c : "") {}
+            String(const __FlashStringHelper *c) : s(c != nullptr ? (const char *)c : "") {}
+            String(const std::string &c) : s(c) {}
+            explicit String(char c) : s(1, c) {}
+            explicit String(unsigned char v, unsigned char base = 10) : s(fromNumber(v, false, base)) {}
+            explicit String(int v, unsigned char base = 10) : s(fromSigned(v, base)) {}
+            explicit String(unsigned int v, unsigned char base = 10) : s(fromNumber(v, false, base)) {}
+            explicit String(long v, unsigned char base = 10) : s(fromSigned(v, base)) {}
+            explicit String(unsigned long v, unsigned char base = 10) : s(fromNumber(v, false, base)) {}
+            explicit String(long long v, unsigned char base = 10) : s(fromSigned(v, base)) {}
+            explicit String(unsigned long long v, unsigned char base = 10) : s(fromNumber(v, false, base)) {}
+            explicit String(double v, unsigned char places = 2) {
+                char buffer[48];
+                snprintf(buffer, sizeof(buffer), "%.*f", places, v);
+                s = buffer;
+            }
+
+            String &operator=(const char *c) { s = c != nullptr ? c : ""; return *this; }
+            String &operator=(const __FlashStringHelper *c) { s = (const char *)c; return *this; }
+
+            unsigned int length() const { return (unsigned int)s.size(); }
+            bool isEmpty() const { return s.empty(); }
+            const char *c_str() const { return s.c_str(); }
+            char *begin() { return &s[0]; }
+            char *end() { return &s[0] + s.size(); }
+            void clear() { s.clear(); }
+            bool reserve(unsigned int size) { s.reserve(size); return true; }
+
+            bool concat(const String &o) { s += o.s; return true; }
+            bool concat(const char *o) { s += o; return true; }
+            bool concat(const char *o, unsigned int n) { s.append(o, n); return true; }
+            bool concat(const __FlashStringHelper *o) { s += (const char *)o; return true; }
+            bool concat(char c) { s += c; return true; }
+            bool concat(unsigned char v) { s += fromNumber(v, false, 10); return true; }
+            bool concat(int v) { s += fromSigned(v, 10); return true; }
+            bool concat(unsigned int v) { s += fromNumber(v, false, 10); return true; }
+            bool concat(long v) { s += fromSigned(v, 10); return true; }
+            bool concat(unsigned long v) { s += fromNumber(v, false, 10); return true; }
+            bool concat(long long v) { s += fromSigned(v, 10); return true; }
+            bool concat(unsigned long long v) { s += fromNumber(v, false, 10); return true; }
+            bool concat(double v) { return concat(String(v)); }
+
+            template <typename T> String &operator+=(const T &o) { concat(o); return *this; }
+
+            bool equals(const String &o) const { return s == o.s; }
+            bool equals(const char *o) const { return s == o; }
+            bool equalsIgnoreCase(const String &o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+            bool startsWith(const String &o) const { return s.compare(0, o.s.size(), o.s) == 0; }
+            bool endsWith(const String &o) const { return s.size() >= o.s.size() && s.compare(s.size() - o.s.size(), o.s.size(), o.s) == 0; }
+            bool operator==(const String &o) const { return s == o.s; }
+            bool operator==(const char *o) const { return s == o; }
+            bool operator!=(const String &o) const { return s != o.s; }
+            bool operator!=(const char *o) const { return s != o; }
+            bool operator<(const String &o) const { return s < o.s; }
+
+            char charAt(unsigned int i) const { return i < s.size() ? s[i] : '\0'; }
+            char operator[](unsigned int i) const { return charAt(i); }
+            char &operator[](unsigned int i) { return s[i]; }
+            void setCharAt(unsigned int i, char c) { if (i < s.size()) s[i] = c; }
+
+            int indexOf(char c, unsigned int from = 0) const { size_t at = s.find(c, from); return at == std::string::npos ? -1 : (int)at; }
+            int indexOf(const String &o, unsigned int from = 0) const { size_t at = s.find(o.s, from); return at == std::string::npos ? -1 : (int)at; }
+            int lastIndexOf(char c) const { size_t at = s.rfind(c); return at == std::string::npos ? -1 : (int)at; }
+            int lastIndexOf(const String &o) const { size_t at = s.rfind(o.s); return at == std::string::npos ? -1 : (int)at; }
+
+            String substring(unsigned int from) const { return from >= s.size() ? String() : String(s.substr(from)); }
+            String substring(unsigned int from, unsigned int to) const {
+                if (from > to) {
+                    unsigned int t = from;
+                    from = to;
+                    to = t;
+                }
+                if (from >= s.size()) {
+
+                    return String();
+                }
+
+                return String(s.substr(from, (to > s.size() ? s.size() : to) - from));
+            }
+
+            long toInt() const { return atol(s.c_str()); }
+            float toFloat() const { return (float)atof(s.c_str()); }
+            void toUpperCase() { for (char &c : s) c = (char)toupper((unsigned char)c); }
+            void toLowerCase() { for (char &c : s) c = (char)tolower((unsigned char)c); }
+            void trim() {
+                size_t first = s.find_first_not_of(" \t\r\n");
+                size_t last = s.find_last_not_of(" \t\r\n");
+                s = first == std::string::npos ? "" : s.substr(first, last - first + 1);
+            }
+            void replace(char from, char to) { for (char &c : s) if (c == from) c = to; }
+            void replace(const String &from, const String &to) {
+                if (from.s.empty()) {
+
+                    return;
+                }
+                size_t at = 0;
+                while ((at = s.find(from.s, at)) != std::string::npos) {
+                    s.replace(at, from.s.size(), to.s);
+                    at += to.s.size();
+                }
+            }
+            void remove(unsigned int from) { if (from < s.size()) s.erase(from); }
+            void remove(unsigned int from, unsigned int count) { if (from < s.size()) s.erase(from, count); }
+            void getBytes(unsigned char *buffer, unsigned int size, unsigned int from = 0) const {
+                if (size == 0) {
+
+                    return;
+                }
+                size_t n = from < s.size() ? s.copy((char *)buffer, size - 1, from) : 0;
+                buffer[n] = '\0';
+            }
+            void toCharArray(char *buffer, unsigned int size, unsigned int from = 0) const { getBytes((unsigned char *)buffer, size, from); }
+    };
+
+    template <typename T> inline String operator+(const String &a, const T &b) { String r(a); r.concat(b); return r; }
+    inline String operator+(const char *a, const String &b) { String r(a); r.concat(b); return r; }
+    inline String operator+(const __FlashStringHelper *a, const String &b) { String r(a); r.concat(b); return r; }
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef WiFiUdp_h
+    #define WiFiUdp_h
+
+    #include <Arduino.h>
+    #include <deque>
+
+    /*
+     * A test scripts what arrives with mockUdpDeliver() and finds what was
+     * sent in mockUdpSent. Every WiFiUDP shares the one network, so a packet
+     * is taken by whichever socket is bound to its port.
+     */
+    struct MockUdpPacket {
+        IPAddress               remoteIp        ;
+        uint16_t                remotePort      ;
+        IPAddress               localIp         ;
+        uint16_t                localPort       ;
+        std::vector<uint8_t>    data            ;
+    };
+
+    inline std::deque<MockUdpPacket> mockUdpInbox;
+    inline std::vector<MockUdpPacket> mockUdpSent;
+
+    inline void mockUdpDeliver(uint16_t localPort, IPAddress remoteIp, uint16_t remotePort, const uint8_t *data, size_t len, IPAddress localIp = IPAddress()) {
+        mockUdpInbox.push_back({remoteIp, remotePort, localIp, localPort, std::vector<uint8_t>(data, data + len)});
+    }
+
+    inline void mockUdpReset() {
+        mockUdpInbox.clear();
+        mockUdpSent.clear();
+    }
+
+    /**
+     * Host stand in for WiFiUDP over the scripted network above.
+     * 
+     * @author Scott Griffis
+     * @date 10-17-2026
+     */
+    class WiFiUDP : public Stream {
+        private:
+            uint16_t       port            ;
+            MockUdpPacket  current         ;
+            size_t         readAt          ;
+            MockUdpPacket  outgoing        ;
+
+        public:
+            WiFiUDP() : port(0), readAt(0) {}
+
+            uint8_t begin(uint16_t port) {
+                this->port = port;
+
+                return 1;
+            }
+            uint8_t beginMulticast(IPAddress, IPAddress, uint16_t port) { return begin(port); }
+            void stop() { port = 0; }
+
+            int parsePacket() {
+                if (port == 0) {
+
+                    return 0;
+                }
+                for (auto it = mockUdpInbox.begin(); it != mockUdpInbox.end(); ++it) {
+                    if (it->localPort == port) {
+                        current = *it;
+                        readAt = 0;
+                        mockUdpInbox.erase(it);
+
+                        return (int)current.data.size();
+                    }
+                }
+
+                return 0;
+            }
+            int available() override { return (int)(current.data.size() - readAt); }
+            int read() override { return readAt < current.data.size() ? current.data[readAt++] : -1; }
+            int read(unsigned char *buffer, size_t len) {
+                size_t count = std::min(len, current.data.size() - readAt);
+                memcpy(buffer, current.data.data() + readAt, count);
+                readAt += count;
+
+                return (int)count;
+            }
+            int read(char *buffer, size_t len) { return read((unsigned char *)buffer, len); }
+            IPAddress remoteIP() { return current.remoteIp; }
+            uint16_t remotePort() { return current.remotePort; }
+            IPAddress destinationIP() { return current.localIp; }
+
+            int beginPacket(IPAddress ip, uint16_t port) {
+                outgoing = {ip, port, IPAddress(), this->port, std::vector<uint8_t>()};
+
+                return 1;
+            }
+            int beginPacketMulticast(IPAddress ip, uint16_t port, IPAddress, int = 1) { return beginPacket(ip, port); }
+            size_t write(uint8_t c) override { return write(&c, 1); }
+            size_t write(const uint8_t *buffer, size_t size) override {
+                outgoing.data.insert(outgoing.data.end(), buffer, buffer + size);
+
+                return size;
+            }
+            int endPacket() {
+                mockUdpSent.push_back(outgoing);
+
+                return 1;
+            }
+            void flush() {}
+    };
+
+#endif
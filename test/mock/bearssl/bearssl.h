@@ -0,0 +1,146 @@
+#ifndef bearssl_h
+    #define bearssl_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <string.h>
+
+    /*
+     * Host stand in for the HMAC-SHA256 corner of BearSSL, the only part the
+     * libraries use. Real SHA-256 so MACs match those worked out on a device.
+     */
+    struct br_sha256_context {
+        uint32_t       state[8]        ;
+        uint64_t       count           ;
+        uint8_t        block[64]       ;
+    };
+
+    struct br_hash_class {
+        size_t         contextSize     ;
+    };
+
+    inline const br_hash_class br_sha256_vtable = {sizeof(br_sha256_context)};
+
+    inline void br_sha256_transform(br_sha256_context *ctx, const uint8_t *in) {
+        static const uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+        auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = ((uint32_t)in[i * 4] << 24) | ((uint32_t)in[i * 4 + 1] << 16) | ((uint32_t)in[i * 4 + 2] << 8) | (uint32_t)in[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t v[8];
+        memcpy(v, ctx->state, sizeof(v));
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = v[7] + (rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25)) + ((v[4] & v[5]) ^ (~v[4] & v[6])) + k[i] + w[i];
+            uint32_t t2 = (rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22)) + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+            memmove(v + 1, v, sizeof(uint32_t) * 7);
+            v[4] += t1;
+            v[0] = t1 + t2;
+        }
+        for (int i = 0; i < 8; i++) {
+            ctx->state[i] += v[i];
+        }
+    }
+
+    inline void br_sha256_init(br_sha256_context *ctx) {
+        static const uint32_t iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        memcpy(ctx->state, iv, sizeof(iv));
+        ctx->count = 0;
+    }
+
+    inline void br_sha256_update(br_sha256_context *ctx, const void *data, size_t len) {
+        const uint8_t *in = (const uint8_t *)data;
+        for (size_t i = 0; i < len; i++) {
+            ctx->block[ctx->count % 64] = in[i];
+            ctx->count++;
+            if (ctx->count % 64 == 0) {
+                br_sha256_transform(ctx, ctx->block);
+            }
+        }
+    }
+
+    inline void br_sha256_out(const br_sha256_context *ctx, void *out) {
+        br_sha256_context c = *ctx;
+        uint64_t bits = c.count * 8;
+        uint8_t pad = 0x80;
+        br_sha256_update(&c, &pad, 1);
+        pad = 0;
+        while (c.count % 64 != 56) {
+            br_sha256_update(&c, &pad, 1);
+        }
+        uint8_t length[8];
+        for (int i = 0; i < 8; i++) {
+            length[i] = (uint8_t)(bits >> (56 - (8 * i)));
+        }
+        br_sha256_update(&c, length, 8);
+        for (int i = 0; i < 32; i++) {
+            ((uint8_t *)out)[i] = (uint8_t)(c.state[i / 4] >> (24 - (8 * (i % 4))));
+        }
+    }
+
+    struct br_hmac_key_context {
+        uint8_t        key[64]         ;
+    };
+
+    struct br_hmac_context {
+        br_sha256_context  inner       ;
+        uint8_t            key[64]     ;
+    };
+
+    inline void br_hmac_key_init(br_hmac_key_context *kc, const br_hash_class *, const void *key, size_t key_len) {
+        memset(kc->key, 0, sizeof(kc->key));
+        if (key_len > sizeof(kc->key)) {
+            br_sha256_context c;
+            br_sha256_init(&c);
+            br_sha256_update(&c, key, key_len);
+            br_sha256_out(&c, kc->key);
+        } else {
+            memcpy(kc->key, key, key_len);
+        }
+    }
+
+    inline void br_hmac_init(br_hmac_context *ctx, const br_hmac_key_context *kc, size_t) {
+        memcpy(ctx->key, kc->key, sizeof(ctx->key));
+        uint8_t pad[64];
+        for (int i = 0; i < 64; i++) {
+            pad[i] = kc->key[i] ^ 0x36;
+        }
+        br_sha256_init(&ctx->inner);
+        br_sha256_update(&ctx->inner, pad, sizeof(pad));
+    }
+
+    inline void br_hmac_update(br_hmac_context *ctx, const void *data, size_t len) {
+        br_sha256_update(&ctx->inner, data, len);
+    }
+
+    inline size_t br_hmac_out(const br_hmac_context *ctx, void *out) {
+        uint8_t innerHash[32];
+        br_sha256_out(&ctx->inner, innerHash);
+        uint8_t pad[64];
+        for (int i = 0; i < 64; i++) {
+            pad[i] = ctx->key[i] ^ 0x5c;
+        }
+        br_sha256_context outer;
+        br_sha256_init(&outer);
+        br_sha256_update(&outer, pad, sizeof(pad));
+        br_sha256_update(&outer, innerHash, sizeof(innerHash));
+        br_sha256_out(&outer, out);
+
+        return 32;
+    }
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef core_esp8266_features_h
+    #define core_esp8266_features_h
+
+    // Nothing the host build needs, here so libraries including it build as they are
+
+#endif
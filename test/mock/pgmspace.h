@@ -0,0 +1,26 @@
+#ifndef pgmspace_h
+    #define pgmspace_h
+
+    #include <stdint.h>
+    #include <string.h>
+    #include <stdio.h>
+
+    // The host has one flat address space, so program memory is plain memory
+    #define PROGMEM
+    #define PGM_P const char *
+    #define PSTR(s) (s)
+    #define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+    #define pgm_read_word(addr) (*(const uint16_t *)(addr))
+    #define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+    #define strlen_P strlen
+    #define strcmp_P strcmp
+    #define strncmp_P strncmp
+    #define strstr_P strstr
+    #define strcpy_P strcpy
+    #define strncpy_P strncpy
+    #define memcpy_P memcpy
+    #define sprintf_P sprintf
+    #define snprintf_P snprintf
+    #define vsnprintf_P vsnprintf
+
+#endif
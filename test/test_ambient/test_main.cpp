@@ -0,0 +1,156 @@
+/*
+    Ambient tests - Feeds made up light levels thru the AmbientSensor on
+    a virtual clock and checks the averaging and hysteresis keep it from
+    switching back and forth.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "AmbientSensor.h"
+
+#define THRESHOLD 300
+
+static AmbientSensor sensor;
+
+/**
+ * Holds the ADC at the given reading for the given number of samples,
+ * calling the sensor every 50ms as the loop would.
+ *
+ * @return Returns the number of times it went dark or light.
+ */
+static int hold(int reading, int samples) {
+    int changes = 0;
+    mockPinLevels[A0] = reading;
+    for (int i = 0; i < samples * (int)(AMBIENT_SAMPLE_MS / 50); i++) {
+        mockAdvanceMillis(50);
+        changes += sensor.handle() ? 1 : 0;
+    }
+
+    return changes;
+}
+
+void setUp() {
+    mockMillis = 0;
+    randomSeed(7);
+    sensor = AmbientSensor();
+    sensor.begin(A0);
+    sensor.setThreshold(THRESHOLD);
+}
+
+void tearDown() {}
+
+void test_first_reading_is_the_level() {
+    TEST_ASSERT_FALSE(sensor.isReady());
+    mockPinLevels[A0] = 100;
+    mockAdvanceMillis(AMBIENT_SAMPLE_MS - 1);
+    TEST_ASSERT_FALSE(sensor.handle());
+    TEST_ASSERT_FALSE(sensor.isReady());
+
+    mockAdvanceMillis(1);
+    TEST_ASSERT_TRUE(sensor.handle());
+    TEST_ASSERT_TRUE(sensor.isReady());
+    TEST_ASSERT_EQUAL(100, sensor.getLevel());
+    TEST_ASSERT_TRUE(sensor.isDark());
+}
+
+void test_reads_are_spaced_out() {
+    hold(600, 1);
+    mockPinLevels[A0] = 0;
+    for (int i = 0; i < 100; i++) {
+        mockAdvanceMillis(10);
+        sensor.handle();
+    }
+    // A second of loops takes two samples, so two of the window are dark
+    TEST_ASSERT_EQUAL((600 * (AMBIENT_WINDOW - 2)) / AMBIENT_WINDOW, sensor.getLevel());
+}
+
+void test_dark_needs_threshold_and_light_needs_hysteresis() {
+    hold(600, 1);
+    TEST_ASSERT_FALSE(sensor.isDark());
+
+    TEST_ASSERT_EQUAL(1, hold(200, AMBIENT_WINDOW));
+    TEST_ASSERT_TRUE(sensor.isDark());
+
+    // Above the threshold but short of the hysteresis is still dark
+    TEST_ASSERT_EQUAL(0, hold(THRESHOLD + AMBIENT_HYSTERESIS - 1, 4 * AMBIENT_WINDOW));
+    TEST_ASSERT_TRUE(sensor.isDark());
+
+    TEST_ASSERT_EQUAL(1, hold(THRESHOLD + AMBIENT_HYSTERESIS, AMBIENT_WINDOW));
+    TEST_ASSERT_FALSE(sensor.isDark());
+
+    // Back down to just over the threshold is still light
+    TEST_ASSERT_EQUAL(0, hold(THRESHOLD + 1, 4 * AMBIENT_WINDOW));
+    TEST_ASSERT_FALSE(sensor.isDark());
+}
+
+void test_passing_shadow_is_smoothed_out() {
+    hold(600, 1);
+    TEST_ASSERT_EQUAL(0, hold(0, 4));
+    TEST_ASSERT_FALSE(sensor.isDark());
+    TEST_ASSERT_EQUAL(0, hold(600, AMBIENT_WINDOW));
+}
+
+void test_noisy_dusk_and_dawn_switch_once_each() {
+    hold(800, 1);
+    int changes = 0;
+
+    // Light falling from 800 to 0 over an hour, with +-30 of noise
+    for (int sample = 0; sample < 7200; sample++) {
+        int level = 800 - (sample * 800) / 7200 + (int)random(-30, 31);
+        changes += hold(max(level, 0), 1);
+    }
+    TEST_ASSERT_EQUAL(1, changes);
+    TEST_ASSERT_TRUE(sensor.isDark());
+
+    changes = 0;
+    for (int sample = 0; sample < 7200; sample++) {
+        int level = (sample * 800) / 7200 + (int)random(-30, 31);
+        changes += hold(max(level, 0), 1);
+    }
+    TEST_ASSERT_EQUAL(1, changes);
+    TEST_ASSERT_FALSE(sensor.isDark());
+}
+
+void test_level_hovering_at_threshold_does_not_flap() {
+    hold(THRESHOLD - 20, 1);
+    int changes = 0;
+    for (int sample = 0; sample < 2000; sample++) {
+        changes += hold(THRESHOLD - 20 + (int)random(0, 2 * AMBIENT_HYSTERESIS - 10), 1);
+    }
+    TEST_ASSERT_TRUE(changes <= 1);
+}
+
+void test_readings_are_clamped() {
+    hold(4095, AMBIENT_WINDOW * 2);
+    TEST_ASSERT_EQUAL(AMBIENT_MAX_LEVEL, sensor.getLevel());
+    sensor.setThreshold(5000);
+    TEST_ASSERT_EQUAL(1, hold(AMBIENT_MAX_LEVEL, 1));
+    TEST_ASSERT_TRUE(sensor.isDark());
+}
+
+void test_reset_starts_over_at_next_reading() {
+    hold(800, AMBIENT_WINDOW);
+    sensor.reset();
+    TEST_ASSERT_FALSE(sensor.isReady());
+    TEST_ASSERT_EQUAL(1, hold(50, 1));
+    TEST_ASSERT_EQUAL(50, sensor.getLevel());
+    TEST_ASSERT_TRUE(sensor.isDark());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_reading_is_the_level);
+    RUN_TEST(test_reads_are_spaced_out);
+    RUN_TEST(test_dark_needs_threshold_and_light_needs_hysteresis);
+    RUN_TEST(test_passing_shadow_is_smoothed_out);
+    RUN_TEST(test_noisy_dusk_and_dawn_switch_once_each);
+    RUN_TEST(test_level_hovering_at_threshold_does_not_flap);
+    RUN_TEST(test_readings_are_clamped);
+    RUN_TEST(test_reset_starts_over_at_next_reading);
+
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+/*
+    Calendar tests - Resolves days against sets of LightCalendar rules and
+    checks the right rule wins where they overlap.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "LightCalendar.h"
+
+#define FIRST_DAY 20454 // <-- 2026-01-01, a Thursday
+#define EVERY_DAY 0x7F
+
+static LightCalendar calendar;
+
+static CalendarRule rule(uint8_t kind, uint16_t start, uint16_t end, int16_t onTime, int16_t offTime, uint8_t days = 0) {
+    CalendarRule made;
+    made.start = start;
+    made.end = end;
+    made.onTime = onTime;
+    made.offTime = offTime;
+    made.kind = kind;
+    made.days = days;
+
+    return made;
+}
+
+/**
+ * Resolves a day, checking which rule won by its on time.
+ */
+static void assertResolvesTo(uint16_t epochDay, int expectedOnTime) {
+    int onTime = -1;
+    int offTime = -1;
+    int found = calendar.resolve(epochDay, onTime, offTime);
+    TEST_ASSERT_NOT_EQUAL(-1, found);
+    TEST_ASSERT_EQUAL(expectedOnTime, onTime);
+    TEST_ASSERT_EQUAL(calendar.getRule(found).offTime, offTime);
+}
+
+void setUp() {
+    calendar.clear();
+}
+
+void tearDown() {}
+
+void test_epoch_days_and_weekdays() {
+    TEST_ASSERT_EQUAL_UINT16(FIRST_DAY, LightCalendar::toEpochDay(2026, 1, 1));
+    TEST_ASSERT_EQUAL_UINT8(4, LightCalendar::toWeekday(FIRST_DAY));
+
+    int year, month, day;
+    LightCalendar::fromEpochDay(LightCalendar::toEpochDay(2028, 2, 29), year, month, day);
+    TEST_ASSERT_EQUAL(2028, year);
+    TEST_ASSERT_EQUAL(2, month);
+    TEST_ASSERT_EQUAL(29, day);
+}
+
+void test_no_rule_leaves_schedule_alone() {
+    calendar.add(rule(CALENDAR_RULE_WEEKLY, 0, 0, 1700, 2300, 1 << 0));
+    int onTime = 1800;
+    int offTime = 2200;
+    TEST_ASSERT_EQUAL(-1, calendar.resolve(FIRST_DAY, onTime, offTime));
+    TEST_ASSERT_EQUAL(1800, onTime);
+    TEST_ASSERT_EQUAL(2200, offTime);
+}
+
+void test_dates_beat_yearly_beat_weekly() {
+    calendar.add(rule(CALENDAR_RULE_WEEKLY, 0, 0, 1500, 2300, EVERY_DAY));
+    calendar.add(rule(CALENDAR_RULE_YEARLY, 101, 101, 1600, 2300));
+    calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY, FIRST_DAY, 1700, 2300));
+    assertResolvesTo(FIRST_DAY, 1700);
+    assertResolvesTo(FIRST_DAY + 365, 1600);
+    assertResolvesTo(FIRST_DAY + 1, 1500);
+}
+
+void test_narrower_rule_wins() {
+    calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY, FIRST_DAY + 30, 1700, 1700));
+    calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY + 10, FIRST_DAY + 10, 1800, 2300));
+    calendar.add(rule(CALENDAR_RULE_YEARLY, 601, 831, 2000, 2300));
+    calendar.add(rule(CALENDAR_RULE_YEARLY, 704, 704, 2100, 2300));
+    assertResolvesTo(FIRST_DAY + 9, 1700);
+    assertResolvesTo(FIRST_DAY + 10, 1800);
+    assertResolvesTo(FIRST_DAY + 11, 1700);
+    assertResolvesTo(LightCalendar::toEpochDay(2026, 7, 3), 2000);
+    assertResolvesTo(LightCalendar::toEpochDay(2026, 7, 4), 2100);
+}
+
+void test_later_dated_rules_are_skipped() {
+    // None of the dated rules has started, so the weekly one decides
+    for (int i = 0; i < 10; i++) {
+        calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY + 100 + i, FIRST_DAY + 100 + i, 1700, 2300));
+    }
+    calendar.add(rule(CALENDAR_RULE_WEEKLY, 0, 0, 1900, 2300, 1 << 4));
+    assertResolvesTo(FIRST_DAY, 1900);
+    assertResolvesTo(FIRST_DAY + 105, 1700);
+
+    // A dated rule that started earlier still covers the day
+    calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY - 5, FIRST_DAY + 5, 1600, 2300));
+    assertResolvesTo(FIRST_DAY, 1600);
+}
+
+void test_yearly_range_over_new_year() {
+    calendar.add(rule(CALENDAR_RULE_YEARLY, 1224, 102, 1600, 1600));
+    assertResolvesTo(LightCalendar::toEpochDay(2026, 12, 24), 1600);
+    assertResolvesTo(LightCalendar::toEpochDay(2026, 12, 31), 1600);
+    assertResolvesTo(LightCalendar::toEpochDay(2027, 1, 2), 1600);
+
+    int onTime = 1800;
+    int offTime = 2200;
+    TEST_ASSERT_EQUAL(-1, calendar.resolve(LightCalendar::toEpochDay(2027, 1, 3), onTime, offTime));
+    TEST_ASSERT_EQUAL(-1, calendar.resolve(LightCalendar::toEpochDay(2026, 12, 23), onTime, offTime));
+
+    // A narrower yearly rule inside the wrapping one still wins
+    calendar.add(rule(CALENDAR_RULE_YEARLY, 101, 101, 1200, 1200));
+    assertResolvesTo(LightCalendar::toEpochDay(2027, 1, 1), 1200);
+}
+
+void test_bad_rules_and_full_table_are_refused() {
+    TEST_ASSERT_FALSE(calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY + 1, FIRST_DAY, 1700, 2300)));
+    TEST_ASSERT_FALSE(calendar.add(rule(CALENDAR_RULE_YEARLY, 1301, 1301, 1700, 2300)));
+    TEST_ASSERT_FALSE(calendar.add(rule(CALENDAR_RULE_WEEKLY, 0, 0, 1700, 2300, 0)));
+    TEST_ASSERT_FALSE(calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY, FIRST_DAY, 1760, 2300)));
+    TEST_ASSERT_EQUAL_UINT8(0, calendar.getCount());
+
+    for (int i = 0; i < CALENDAR_MAX_RULES; i++) {
+        TEST_ASSERT_TRUE(calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY + CALENDAR_MAX_RULES - i, FIRST_DAY + CALENDAR_MAX_RULES - i, 1700, 2300)));
+    }
+    TEST_ASSERT_FALSE(calendar.add(rule(CALENDAR_RULE_DATES, FIRST_DAY, FIRST_DAY, 1700, 2300)));
+
+    // Kept sorted whatever order they came in
+    for (int i = 1; i < CALENDAR_MAX_RULES; i++) {
+        TEST_ASSERT_TRUE(calendar.getRule(i - 1).start < calendar.getRule(i).start);
+    }
+}
+
+void test_dates_parse_and_format() {
+    uint16_t date;
+    char text[11];
+    TEST_ASSERT_TRUE(LightCalendar::parseDate("2026-01-01", false, date));
+    TEST_ASSERT_EQUAL_UINT16(FIRST_DAY, date);
+    LightCalendar::formatDate(date, false, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("2026-01-01", text);
+
+    TEST_ASSERT_TRUE(LightCalendar::parseDate("12-24", true, date));
+    TEST_ASSERT_EQUAL_UINT16(1224, date);
+    LightCalendar::formatDate(date, true, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("12-24", text);
+
+    TEST_ASSERT_FALSE(LightCalendar::parseDate("2026-13-01", false, date));
+    TEST_ASSERT_FALSE(LightCalendar::parseDate("2026-1-01", false, date));
+    TEST_ASSERT_FALSE(LightCalendar::parseDate("12/24", true, date));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_epoch_days_and_weekdays);
+    RUN_TEST(test_no_rule_leaves_schedule_alone);
+    RUN_TEST(test_dates_beat_yearly_beat_weekly);
+    RUN_TEST(test_narrower_rule_wins);
+    RUN_TEST(test_later_dated_rules_are_skipped);
+    RUN_TEST(test_yearly_range_over_new_year);
+    RUN_TEST(test_bad_rules_and_full_table_are_refused);
+    RUN_TEST(test_dates_parse_and_format);
+
+    return UNITY_END();
+}
@@ -0,0 +1,344 @@
+/*
+    CoAP tests - Sends requests to the CoapServer thru the UDP mock and
+    checks the answers and the notifications observers are pushed.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <unity.h>
+#include <map>
+#include <vector>
+
+#include "CoapServer.h"
+
+#define NO_OBSERVE -1
+
+typedef std::vector<uint8_t> Bytes;
+
+/**
+ * A message as it came back from the server, split into its parts.
+ */
+struct Reply {
+    uint8_t                     type        ;
+    uint8_t                     code        ;
+    uint16_t                    messageId   ;
+    Bytes                       token       ;
+    std::map<uint16_t, Bytes>   options     ;
+    String                      payload     ;
+};
+
+static CoapServer *coap;
+static bool lightsOn;
+static int level;
+static int statusPad;
+
+static size_t getLight(char *buffer, size_t size) {
+
+    return snprintf(buffer, size, "{\"on\":%s,\"level\":%d}", lightsOn ? "true" : "false", level);
+}
+
+static uint8_t putLight(const char *payload, size_t length) {
+    if (length == 2 && memcmp(payload, "on", 2) == 0) {
+        lightsOn = true;
+    } else if (length == 3 && memcmp(payload, "off", 3) == 0) {
+        lightsOn = false;
+    } else {
+
+        return COAP_BAD_REQUEST;
+    }
+
+    return COAP_CHANGED;
+}
+
+static size_t getStatus(char *buffer, size_t size) {
+
+    return snprintf(buffer, size, "{\"pad\":\"%0*d\"}", statusPad, 0);
+}
+
+/**
+ * Sends a request from the given client port. Observe is left out when
+ * NO_OBSERVE.
+ */
+static void request(uint8_t type, uint8_t code, uint16_t messageId, const char *token, const char *path, int observe = NO_OBSERVE, const char *payload = nullptr, uint16_t fromPort = 50000) {
+    size_t tokenLen = strlen(token);
+    Bytes packet = {(uint8_t)(0x40 | (type << 4) | tokenLen), code, (uint8_t)(messageId >> 8), (uint8_t)(messageId & 0xFF)};
+    packet.insert(packet.end(), token, token + tokenLen);
+
+    uint16_t lastOption = 0;
+    if (observe != NO_OBSERVE) {
+        packet.push_back(((COAP_OPTION_OBSERVE - lastOption) << 4) | (observe == 0 ? 0 : 1));
+        if (observe != 0) {
+            packet.push_back(observe);
+        }
+        lastOption = COAP_OPTION_OBSERVE;
+    }
+    for (const char *segment = path + 1; *path != '\0' && *segment != '\0';) {
+        const char *end = strchr(segment, '/');
+        size_t length = end ? end - segment : strlen(segment);
+        packet.push_back(((COAP_OPTION_URI_PATH - lastOption) << 4) | length);
+        packet.insert(packet.end(), segment, segment + length);
+        lastOption = COAP_OPTION_URI_PATH;
+        segment += length + (end ? 1 : 0);
+    }
+    if (payload) {
+        packet.push_back(0xFF);
+        packet.insert(packet.end(), payload, payload + strlen(payload));
+    }
+    mockUdpDeliver(COAP_PORT, IPAddress(192, 168, 1, 10), fromPort, packet.data(), packet.size());
+    coap->handle();
+}
+
+/**
+ * Parses the given sent message.
+ */
+static Reply parse(const MockUdpPacket &sent) {
+    const Bytes &data = sent.data;
+    Reply reply;
+    TEST_ASSERT_TRUE(data.size() >= 4);
+    TEST_ASSERT_EQUAL(1, data[0] >> 6);
+    reply.type = (data[0] >> 4) & 0x03;
+    reply.code = data[1];
+    reply.messageId = (data[2] << 8) | data[3];
+    size_t pos = 4 + (data[0] & 0x0F);
+    reply.token.assign(data.begin() + 4, data.begin() + pos);
+
+    uint16_t option = 0;
+    while (pos < data.size() && data[pos] != 0xFF) {
+        uint16_t delta = data[pos] >> 4;
+        uint8_t length = data[pos] & 0x0F;
+        pos++;
+        if (delta == 13) {
+            delta = 13 + data[pos++];
+        }
+        option += delta;
+        reply.options[option].assign(data.begin() + pos, data.begin() + pos + length);
+        pos += length;
+    }
+    if (pos < data.size()) {
+        reply.payload = String(std::string(data.begin() + pos + 1, data.end()).c_str());
+    }
+
+    return reply;
+}
+
+/**
+ * Takes the one message sent since the last call.
+ */
+static Reply takeReply() {
+    TEST_ASSERT_EQUAL(1, (int)mockUdpSent.size());
+    Reply reply = parse(mockUdpSent[0]);
+    mockUdpSent.clear();
+
+    return reply;
+}
+
+static uint32_t optionValue(const Reply &reply, uint16_t option) {
+    uint32_t value = 0;
+    for (uint8_t byte : reply.options.at(option)) {
+        value = (value << 8) | byte;
+    }
+
+    return value;
+}
+
+void setUp() {
+    mockUdpReset();
+    mockMillis = 0;
+    lightsOn = true;
+    level = 50;
+    statusPad = 4;
+    coap = new CoapServer();
+    coap->on("/light", getLight, putLight);
+    coap->on("/status", getStatus);
+    coap->begin();
+}
+
+void tearDown() {
+    delete coap;
+}
+
+void test_get_is_answered_in_ack() {
+    request(COAP_TYPE_CON, COAP_GET, 0x1234, "tk", "/light");
+    Reply reply = takeReply();
+    TEST_ASSERT_EQUAL(COAP_TYPE_ACK, reply.type);
+    TEST_ASSERT_EQUAL_HEX8(COAP_CONTENT, reply.code);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, reply.messageId);
+    TEST_ASSERT_TRUE(reply.token == Bytes({'t', 'k'}));
+    TEST_ASSERT_EQUAL(COAP_FORMAT_JSON, optionValue(reply, COAP_OPTION_CONTENT_FORMAT));
+    TEST_ASSERT_EQUAL(0, (int)reply.options.count(COAP_OPTION_OBSERVE));
+    TEST_ASSERT_EQUAL_STRING("{\"on\":true,\"level\":50}", reply.payload.c_str());
+}
+
+void test_non_get_is_answered_in_non() {
+    request(COAP_TYPE_NON, COAP_GET, 0x1234, "", "/light");
+    Reply reply = takeReply();
+    TEST_ASSERT_EQUAL(COAP_TYPE_NON, reply.type);
+    TEST_ASSERT_EQUAL_HEX8(COAP_CONTENT, reply.code);
+}
+
+void test_put_changes_resource() {
+    request(COAP_TYPE_CON, COAP_PUT, 1, "a", "/light", NO_OBSERVE, "off");
+    TEST_ASSERT_EQUAL_HEX8(COAP_CHANGED, takeReply().code);
+    TEST_ASSERT_FALSE(lightsOn);
+
+    request(COAP_TYPE_CON, COAP_POST, 2, "a", "/light", NO_OBSERVE, "on");
+    TEST_ASSERT_EQUAL_HEX8(COAP_CHANGED, takeReply().code);
+    TEST_ASSERT_TRUE(lightsOn);
+
+    request(COAP_TYPE_CON, COAP_PUT, 3, "a", "/light", NO_OBSERVE, "dim");
+    TEST_ASSERT_EQUAL_HEX8(COAP_BAD_REQUEST, takeReply().code);
+    TEST_ASSERT_TRUE(lightsOn);
+}
+
+void test_bad_requests_are_refused() {
+    request(COAP_TYPE_CON, COAP_PUT, 1, "", "/status", NO_OBSERVE, "x");
+    TEST_ASSERT_EQUAL_HEX8(COAP_METHOD_NOT_ALLOWED, takeReply().code);
+    request(COAP_TYPE_CON, COAP_GET, 2, "", "/nothing");
+    TEST_ASSERT_EQUAL_HEX8(COAP_NOT_FOUND, takeReply().code);
+    request(COAP_TYPE_CON, COAP_GET, 3, "", "/");
+    TEST_ASSERT_EQUAL_HEX8(COAP_NOT_FOUND, takeReply().code);
+    request(COAP_TYPE_CON, COAP_GET, 4, "", "/abcdefghij/abcdefghij/light");
+    TEST_ASSERT_EQUAL_HEX8(COAP_NOT_FOUND, takeReply().code);
+}
+
+void test_non_requests_get_no_answer() {
+    request(COAP_TYPE_ACK, COAP_GET, 1, "", "/light");
+    request(COAP_TYPE_CON, COAP_CONTENT, 2, "", "/light");
+    request(COAP_TYPE_NON, 0, 3, "", "");
+    TEST_ASSERT_EQUAL(0, (int)mockUdpSent.size());
+}
+
+void test_ping_gets_reset() {
+    request(COAP_TYPE_CON, 0, 0x4242, "", "");
+    Reply reply = takeReply();
+    TEST_ASSERT_EQUAL(COAP_TYPE_RST, reply.type);
+    TEST_ASSERT_EQUAL_HEX16(0x4242, reply.messageId);
+}
+
+void test_well_known_core_lists_resources() {
+    request(COAP_TYPE_CON, COAP_GET, 1, "", "/.well-known/core");
+    Reply reply = takeReply();
+    TEST_ASSERT_EQUAL_HEX8(COAP_CONTENT, reply.code);
+    TEST_ASSERT_EQUAL(COAP_FORMAT_LINK, optionValue(reply, COAP_OPTION_CONTENT_FORMAT));
+    TEST_ASSERT_EQUAL_STRING("</light>;obs;ct=50,</status>;obs;ct=50", reply.payload.c_str());
+}
+
+void test_representation_too_big_is_internal_error() {
+    statusPad = COAP_MAX_PACKET;
+    request(COAP_TYPE_CON, COAP_GET, 1, "tok", "/status");
+    Reply reply = takeReply();
+    TEST_ASSERT_EQUAL_HEX8(COAP_INTERNAL_ERROR, reply.code);
+    TEST_ASSERT_TRUE(reply.token == Bytes({'t', 'o', 'k'}));
+}
+
+void test_observer_is_notified_only_of_changes() {
+    request(COAP_TYPE_CON, COAP_GET, 1, "ob", "/light", 0);
+    Reply registered = takeReply();
+    TEST_ASSERT_EQUAL(1, (int)registered.options.count(COAP_OPTION_OBSERVE));
+    TEST_ASSERT_EQUAL(1, coap->getObserverCount());
+
+    coap->notifyChanged();
+    TEST_ASSERT_EQUAL(0, (int)mockUdpSent.size());
+
+    level = 80;
+    coap->notifyChanged();
+    Reply first = takeReply();
+    TEST_ASSERT_EQUAL(COAP_TYPE_NON, first.type);
+    TEST_ASSERT_EQUAL_HEX8(COAP_CONTENT, first.code);
+    TEST_ASSERT_TRUE(first.token == Bytes({'o', 'b'}));
+    TEST_ASSERT_EQUAL_STRING("{\"on\":true,\"level\":80}", first.payload.c_str());
+    TEST_ASSERT_TRUE(mockUdpSent.empty());
+
+    lightsOn = false;
+    coap->notifyChanged();
+    Reply second = takeReply();
+    TEST_ASSERT_TRUE(optionValue(second, COAP_OPTION_OBSERVE) > optionValue(first, COAP_OPTION_OBSERVE));
+    TEST_ASSERT_TRUE(second.messageId != first.messageId);
+    TEST_ASSERT_EQUAL(2, coap->getNotificationCount());
+}
+
+void test_reset_drops_observer() {
+    request(COAP_TYPE_CON, COAP_GET, 1, "ob", "/light", 0);
+    takeReply();
+    level = 10;
+    coap->notifyChanged();
+    Reply notification = takeReply();
+
+    // A reset to some other message leaves it be
+    request(COAP_TYPE_RST, 0, notification.messageId + 1, "", "");
+    TEST_ASSERT_EQUAL(1, coap->getObserverCount());
+    request(COAP_TYPE_RST, 0, notification.messageId, "", "");
+    TEST_ASSERT_EQUAL(0, coap->getObserverCount());
+
+    level = 20;
+    coap->notifyChanged();
+    TEST_ASSERT_TRUE(mockUdpSent.empty());
+}
+
+void test_deregister_drops_observer() {
+    request(COAP_TYPE_CON, COAP_GET, 1, "ob", "/light", 0);
+    request(COAP_TYPE_CON, COAP_GET, 2, "xx", "/light", 1);
+    TEST_ASSERT_EQUAL(1, coap->getObserverCount());
+    request(COAP_TYPE_CON, COAP_GET, 3, "ob", "/light", 1);
+    TEST_ASSERT_EQUAL(0, coap->getObserverCount());
+}
+
+void test_observer_expires_unless_renewed() {
+    request(COAP_TYPE_CON, COAP_GET, 1, "ob", "/light", 0);
+    mockAdvanceMillis(COAP_OBSERVE_LIFETIME_MS - 1000);
+    request(COAP_TYPE_CON, COAP_GET, 2, "ob", "/light", 0);
+    TEST_ASSERT_EQUAL(1, coap->getObserverCount());
+
+    mockAdvanceMillis(COAP_OBSERVE_LIFETIME_MS - 1000);
+    coap->handle();
+    TEST_ASSERT_EQUAL(1, coap->getObserverCount());
+    mockAdvanceMillis(2000);
+    coap->handle();
+    TEST_ASSERT_EQUAL(0, coap->getObserverCount());
+}
+
+void test_observers_past_limit_get_plain_answer() {
+    for (uint16_t client = 0; client < COAP_MAX_OBSERVERS; client++) {
+        request(COAP_TYPE_CON, COAP_GET, client, "ob", "/light", 0, nullptr, 50000 + client);
+        TEST_ASSERT_EQUAL(1, (int)takeReply().options.count(COAP_OPTION_OBSERVE));
+    }
+    request(COAP_TYPE_CON, COAP_GET, 99, "ob", "/light", 0, nullptr, 60000);
+    Reply reply = takeReply();
+    TEST_ASSERT_EQUAL_HEX8(COAP_CONTENT, reply.code);
+    TEST_ASSERT_EQUAL(0, (int)reply.options.count(COAP_OPTION_OBSERVE));
+    TEST_ASSERT_EQUAL(COAP_MAX_OBSERVERS, coap->getObserverCount());
+
+    level = 1;
+    coap->notifyChanged();
+    TEST_ASSERT_EQUAL(COAP_MAX_OBSERVERS, (int)mockUdpSent.size());
+}
+
+void test_oversized_packet_is_dropped() {
+    uint8_t packet[COAP_MAX_PACKET + 1] = {0x40, COAP_GET, 0, 1};
+    mockUdpDeliver(COAP_PORT, IPAddress(192, 168, 1, 10), 50000, packet, sizeof(packet));
+    coap->handle();
+    TEST_ASSERT_TRUE(mockUdpSent.empty());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_get_is_answered_in_ack);
+    RUN_TEST(test_non_get_is_answered_in_non);
+    RUN_TEST(test_put_changes_resource);
+    RUN_TEST(test_bad_requests_are_refused);
+    RUN_TEST(test_non_requests_get_no_answer);
+    RUN_TEST(test_ping_gets_reset);
+    RUN_TEST(test_well_known_core_lists_resources);
+    RUN_TEST(test_representation_too_big_is_internal_error);
+    RUN_TEST(test_observer_is_notified_only_of_changes);
+    RUN_TEST(test_reset_drops_observer);
+    RUN_TEST(test_deregister_drops_observer);
+    RUN_TEST(test_observer_expires_unless_renewed);
+    RUN_TEST(test_observers_past_limit_get_plain_answer);
+    RUN_TEST(test_oversized_packet_is_dropped);
+
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+/*
+    Event log tests - Records events into the EventLog and restarts it
+    over an in memory LittleFS, checking the ring, merging of slider
+    events and that a failed save leaves the last log in place.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+
+#include "EventLog.h"
+
+#define EPOCH 1767225600UL
+
+static EventLog *eventLog;
+
+static String formatted(uint32_t seq) {
+    char buffer[128];
+    size_t length = eventLog->format(seq, buffer, sizeof(buffer));
+
+    return length > 0 ? String(buffer) : String("");
+}
+
+/**
+ * Records a light event for each given value, a second apart.
+ */
+static void recordLights(int count) {
+    for (int i = 0; i < count; i++) {
+        eventLog->record(EPOCH + i, false, EVENT_SOURCE_BUTTON, EVENT_KIND_LIGHT, i & 0xFF, (i + 1) & 0xFF);
+        mockAdvanceMillis(1000);
+    }
+}
+
+/**
+ * Throws the log away and starts a new one over the same files.
+ */
+static bool restart() {
+    delete eventLog;
+    eventLog = new EventLog();
+
+    return eventLog->begin();
+}
+
+void setUp() {
+    mockFsReset();
+    mockMillis = 0;
+    eventLog = new EventLog();
+}
+
+void tearDown() {
+    delete eventLog;
+}
+
+void test_records_are_formatted() {
+    TEST_ASSERT_FALSE(eventLog->begin());
+    eventLog->record(EPOCH, false, EVENT_SOURCE_WEB, EVENT_KIND_LIGHT, 0, 1);
+    eventLog->record(12, true, EVENT_SOURCE_BOOT, EVENT_KIND_BOOT, 6, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, eventLog->getFirstSeq());
+    TEST_ASSERT_EQUAL_UINT32(2, eventLog->getNextSeq());
+    TEST_ASSERT_EQUAL_STRING("{\"seq\":0,\"t\":1767225600,\"src\":\"web\",\"kind\":\"light\",\"from\":0,\"to\":1}", formatted(0).c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"seq\":1,\"t\":12,\"up\":true,\"src\":\"boot\",\"kind\":\"boot\",\"from\":6,\"to\":1}", formatted(1).c_str());
+    TEST_ASSERT_EQUAL_STRING("", formatted(2).c_str());
+
+    char small[20];
+    TEST_ASSERT_EQUAL(0, (int)eventLog->format(0, small, sizeof(small)));
+}
+
+void test_ring_keeps_the_newest() {
+    eventLog->begin();
+    recordLights(EVENT_LOG_SIZE + 72);
+    TEST_ASSERT_EQUAL_UINT32(72, eventLog->getFirstSeq());
+    TEST_ASSERT_EQUAL_UINT32(EVENT_LOG_SIZE + 72, eventLog->getNextSeq());
+
+    Event event;
+    TEST_ASSERT_FALSE(eventLog->get(71, event));
+    TEST_ASSERT_TRUE(eventLog->get(72, event));
+    TEST_ASSERT_EQUAL_UINT32(EPOCH + 72, event.time);
+    TEST_ASSERT_TRUE(eventLog->get(EVENT_LOG_SIZE + 71, event));
+    TEST_ASSERT_EQUAL_UINT32(EPOCH + EVENT_LOG_SIZE + 71, event.time);
+    TEST_ASSERT_FALSE(eventLog->get(EVENT_LOG_SIZE + 72, event));
+}
+
+void test_slider_level_events_are_merged() {
+    eventLog->begin();
+    for (uint8_t level = 10; level <= 90; level += 10) {
+        eventLog->record(EPOCH + level, false, EVENT_SOURCE_WEB, EVENT_KIND_LEVEL, level - 10, level);
+        mockAdvanceMillis(500);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, eventLog->getNextSeq());
+    TEST_ASSERT_EQUAL_STRING("{\"seq\":0,\"t\":1767225690,\"src\":\"web\",\"kind\":\"level\",\"from\":0,\"to\":90}", formatted(0).c_str());
+
+    // Another source, or the same one later on, is an event of its own
+    eventLog->record(EPOCH + 100, false, EVENT_SOURCE_MQTT, EVENT_KIND_LEVEL, 90, 40);
+    mockAdvanceMillis(EVENT_MERGE_MS);
+    eventLog->record(EPOCH + 103, false, EVENT_SOURCE_MQTT, EVENT_KIND_LEVEL, 40, 30);
+    TEST_ASSERT_EQUAL_UINT32(3, eventLog->getNextSeq());
+}
+
+void test_save_waits_then_survives_restart() {
+    eventLog->begin();
+    recordLights(EVENT_LOG_SIZE + 5);
+    eventLog->handle();
+    TEST_ASSERT_EQUAL(0, (int)mockFsFiles.count(EVENT_LOG_FILE));
+
+    mockAdvanceMillis(EVENT_FLUSH_DELAY);
+    eventLog->handle();
+    TEST_ASSERT_EQUAL(1, (int)mockFsFiles.count(EVENT_LOG_FILE));
+    TEST_ASSERT_EQUAL(0, (int)mockFsFiles.count(EVENT_LOG_TEMP));
+    String last = formatted(EVENT_LOG_SIZE + 4);
+
+    TEST_ASSERT_TRUE(restart());
+    TEST_ASSERT_EQUAL_UINT32(5, eventLog->getFirstSeq());
+    TEST_ASSERT_EQUAL_UINT32(EVENT_LOG_SIZE + 5, eventLog->getNextSeq());
+    TEST_ASSERT_EQUAL_STRING(last.c_str(), formatted(EVENT_LOG_SIZE + 4).c_str());
+
+    // Sequence numbers carry on from before the restart
+    eventLog->record(EPOCH, false, EVENT_SOURCE_TIMER, EVENT_KIND_LIGHT, 1, 0);
+    TEST_ASSERT_EQUAL_UINT32(EVENT_LOG_SIZE + 6, eventLog->getNextSeq());
+    TEST_ASSERT_EQUAL_UINT32(6, eventLog->getFirstSeq());
+}
+
+void test_nothing_new_is_not_saved_again() {
+    eventLog->begin();
+    recordLights(3);
+    TEST_ASSERT_TRUE(eventLog->flush());
+    mockFsFiles.erase(EVENT_LOG_FILE);
+    mockAdvanceMillis(EVENT_FLUSH_DELAY);
+    eventLog->handle();
+    TEST_ASSERT_TRUE(eventLog->flush());
+    TEST_ASSERT_EQUAL(0, (int)mockFsFiles.count(EVENT_LOG_FILE));
+}
+
+void test_failed_save_keeps_last_log() {
+    eventLog->begin();
+    recordLights(10);
+    TEST_ASSERT_TRUE(eventLog->flush());
+    std::vector<uint8_t> saved = mockFsFiles[EVENT_LOG_FILE];
+
+    // Power goes partway thru the next save
+    recordLights(10);
+    mockFsWriteLimit = 40;
+    TEST_ASSERT_FALSE(eventLog->flush());
+    TEST_ASSERT_TRUE(mockFsFiles[EVENT_LOG_FILE] == saved);
+    TEST_ASSERT_TRUE(restart());
+    TEST_ASSERT_EQUAL_UINT32(10, eventLog->getNextSeq());
+}
+
+void test_failed_save_is_retried() {
+    eventLog->begin();
+    recordLights(10);
+    mockFsWriteLimit = 0;
+    TEST_ASSERT_FALSE(eventLog->flush());
+
+    mockFsWriteLimit = SIZE_MAX;
+    mockAdvanceMillis(EVENT_FLUSH_DELAY - 1000);
+    eventLog->handle();
+    TEST_ASSERT_EQUAL(0, (int)mockFsFiles.count(EVENT_LOG_FILE));
+    mockAdvanceMillis(1000);
+    eventLog->handle();
+    TEST_ASSERT_TRUE(restart());
+    TEST_ASSERT_EQUAL_UINT32(10, eventLog->getNextSeq());
+}
+
+void test_bad_file_starts_empty_log() {
+    mockFsFiles[EVENT_LOG_FILE] = std::vector<uint8_t>(20, 0xAB);
+    TEST_ASSERT_FALSE(eventLog->begin());
+    TEST_ASSERT_EQUAL_UINT32(0, eventLog->getNextSeq());
+
+    // Header says more events than the file has
+    recordLights(3);
+    eventLog->flush();
+    mockFsFiles[EVENT_LOG_FILE].resize(mockFsFiles[EVENT_LOG_FILE].size() - 1);
+    TEST_ASSERT_FALSE(restart());
+    TEST_ASSERT_EQUAL_UINT32(0, eventLog->getNextSeq());
+}
+
+void test_unmounted_log_still_records() {
+    mockFsMountable = false;
+    TEST_ASSERT_FALSE(eventLog->begin());
+    recordLights(3);
+    TEST_ASSERT_EQUAL_UINT32(3, eventLog->getNextSeq());
+    TEST_ASSERT_FALSE(eventLog->flush());
+    TEST_ASSERT_TRUE(mockFsFiles.empty());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_records_are_formatted);
+    RUN_TEST(test_ring_keeps_the_newest);
+    RUN_TEST(test_slider_level_events_are_merged);
+    RUN_TEST(test_save_waits_then_survives_restart);
+    RUN_TEST(test_nothing_new_is_not_saved_again);
+    RUN_TEST(test_failed_save_keeps_last_log);
+    RUN_TEST(test_failed_save_is_retried);
+    RUN_TEST(test_bad_file_starts_empty_log);
+    RUN_TEST(test_unmounted_log_still_records);
+
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+/*
+    Group control tests - Checks that each group command is acted on
+    exactly once however many copies of it arrive, and that echoes,
+    replays and other groups are ignored.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <unity.h>
+
+#include "GroupControl.h"
+
+#define TEST_GROUP 7
+
+static const uint8_t OWN_ID[3] = {0xA1, 0xB2, 0xC3};
+static const uint8_t PEER_ID[3] = {0x11, 0x22, 0x33};
+
+static void deliver(uint8_t command, uint16_t groupId, const uint8_t *senderId, uint16_t bootNonce, uint32_t seq) {
+    uint8_t packet[GROUP_PACKET_SIZE];
+    GroupControl::encode(packet, command, groupId, senderId, bootNonce, seq);
+    mockUdpDeliver(GROUP_PORT, IPAddress(192, 168, 1, 20), GROUP_PORT, packet, sizeof(packet));
+}
+
+static void startGroup(GroupControl &group, const char *deviceId, uint16_t bootNonce) {
+    group.begin(deviceId, bootNonce);
+    group.setGroupId(TEST_GROUP);
+    group.setInterface(true, IPAddress(192, 168, 1, 2));
+}
+
+void setUp() {
+    mockUdpReset();
+    mockMillis = 0;
+}
+
+void tearDown() {}
+
+void test_copies_are_acted_on_once() {
+    GroupControl group;
+    startGroup(group, "A1B2C3", 0x1234);
+    for (int copy = 0; copy < GROUP_SEND_COPIES; copy++) {
+        deliver(GROUP_CMD_ON, TEST_GROUP, PEER_ID, 0x0001, 5);
+    }
+    TEST_ASSERT_EQUAL(GROUP_CMD_ON, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+}
+
+void test_later_commands_pass_and_replays_do_not() {
+    GroupControl group;
+    startGroup(group, "A1B2C3", 0x1234);
+    deliver(GROUP_CMD_ON, TEST_GROUP, PEER_ID, 0x0001, 5);
+    deliver(GROUP_CMD_OFF, TEST_GROUP, PEER_ID, 0x0001, 6);
+    deliver(GROUP_CMD_ON, TEST_GROUP, PEER_ID, 0x0001, 5);
+    deliver(GROUP_CMD_ON, TEST_GROUP, PEER_ID, 0x0001, 4);
+    TEST_ASSERT_EQUAL(GROUP_CMD_ON, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_OFF, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+}
+
+void test_own_echo_and_other_groups_are_ignored() {
+    GroupControl group;
+    startGroup(group, "A1B2C3", 0x1234);
+    deliver(GROUP_CMD_ON, TEST_GROUP, OWN_ID, 0x1234, 9);
+    deliver(GROUP_CMD_ON, TEST_GROUP + 1, PEER_ID, 0x0001, 9);
+    deliver(GROUP_CMD_ON, TEST_GROUP, PEER_ID, 0x0001, 0);
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+
+    // Same device after a reboot is someone else as far as echoes go
+    deliver(GROUP_CMD_ON, TEST_GROUP, OWN_ID, 0x4321, 1);
+    TEST_ASSERT_EQUAL(GROUP_CMD_ON, group.handle());
+}
+
+void test_rebooted_sender_starts_over() {
+    GroupControl group;
+    startGroup(group, "A1B2C3", 0x1234);
+    deliver(GROUP_CMD_ON, TEST_GROUP, PEER_ID, 0x0001, 500);
+    TEST_ASSERT_EQUAL(GROUP_CMD_ON, group.handle());
+
+    // New boot nonce, sequence back at 1
+    deliver(GROUP_CMD_OFF, TEST_GROUP, PEER_ID, 0x0002, 1);
+    TEST_ASSERT_EQUAL(GROUP_CMD_OFF, group.handle());
+}
+
+void test_sequence_wraps() {
+    GroupControl group;
+    startGroup(group, "A1B2C3", 0x1234);
+    deliver(GROUP_CMD_ON, TEST_GROUP, PEER_ID, 0x0001, 0xFFFFFF);
+    deliver(GROUP_CMD_OFF, TEST_GROUP, PEER_ID, 0x0001, 1);
+    TEST_ASSERT_EQUAL(GROUP_CMD_ON, group.handle());
+    TEST_ASSERT_EQUAL(GROUP_CMD_OFF, group.handle());
+}
+
+void test_busy_group_forgets_the_quietest_sender() {
+    GroupControl group;
+    startGroup(group, "A1B2C3", 0x1234);
+    for (uint8_t sender = 0; sender <= GROUP_MAX_SENDERS; sender++) {
+        uint8_t id[3] = {0x50, 0x00, sender};
+        deliver(GROUP_CMD_ON, TEST_GROUP, id, 0x0001, 10);
+        TEST_ASSERT_EQUAL(GROUP_CMD_ON, group.handle());
+        mockAdvanceMillis(1000);
+    }
+
+    // The first sender was pushed out, the rest are still remembered
+    uint8_t first[3] = {0x50, 0x00, 0};
+    uint8_t last[3] = {0x50, 0x00, GROUP_MAX_SENDERS};
+    deliver(GROUP_CMD_ON, TEST_GROUP, last, 0x0001, 10);
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+    deliver(GROUP_CMD_ON, TEST_GROUP, first, 0x0001, 10);
+    TEST_ASSERT_EQUAL(GROUP_CMD_ON, group.handle());
+}
+
+void test_sent_command_reaches_peer_once() {
+    GroupControl sender;
+    GroupControl receiver;
+    startGroup(sender, "112233", 0x0001);
+    startGroup(receiver, "A1B2C3", 0x1234);
+
+    TEST_ASSERT_TRUE(sender.send(GROUP_CMD_OFF));
+    for (int i = 0; i < 10; i++) {
+        mockAdvanceMillis(15);
+        sender.handle();
+    }
+    TEST_ASSERT_EQUAL(GROUP_SEND_COPIES, (int)mockUdpSent.size());
+    for (const MockUdpPacket &sent : mockUdpSent) {
+        TEST_ASSERT_TRUE(sent.remoteIp == GROUP_MULTICAST_IP);
+        mockUdpDeliver(GROUP_PORT, IPAddress(192, 168, 1, 3), GROUP_PORT, sent.data.data(), sent.data.size());
+    }
+
+    int acted = 0;
+    for (int copy = 0; copy < GROUP_SEND_COPIES; copy++) {
+        acted += receiver.handle() == GROUP_CMD_OFF ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(1, acted);
+}
+
+void test_no_group_means_no_listening() {
+    GroupControl group;
+    group.begin("A1B2C3", 0x1234);
+    group.setGroupId(0);
+    group.setInterface(true, IPAddress(192, 168, 1, 2));
+    TEST_ASSERT_FALSE(group.send(GROUP_CMD_ON));
+    deliver(GROUP_CMD_ON, 0, PEER_ID, 0x0001, 1);
+    TEST_ASSERT_EQUAL(GROUP_CMD_NONE, group.handle());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_copies_are_acted_on_once);
+    RUN_TEST(test_later_commands_pass_and_replays_do_not);
+    RUN_TEST(test_own_echo_and_other_groups_are_ignored);
+    RUN_TEST(test_rebooted_sender_starts_over);
+    RUN_TEST(test_sequence_wraps);
+    RUN_TEST(test_busy_group_forgets_the_quietest_sender);
+    RUN_TEST(test_sent_command_reaches_peer_once);
+    RUN_TEST(test_no_group_means_no_listening);
+
+    return UNITY_END();
+}
@@ -0,0 +1,235 @@
+/*
+    MQTT tests - Runs the MqttLink against a scripted broker and checks
+    that state is only published when it differs from what the broker
+    holds, that changes are coalesced and that reconnects back off.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include <unity.h>
+
+#include "MqttLink.h"
+
+#define STATE_TOPIC "lumen/A1B2C3/state"
+#define LOOP_MILLIS 10
+
+static MqttLink *mqtt;
+
+/**
+ * Runs the loop for the given time.
+ */
+static void run(unsigned long ms, bool isNetworkUp = true) {
+    for (unsigned long at = 0; at < ms; at += LOOP_MILLIS) {
+        mqtt->handle(isNetworkUp);
+        mockAdvanceMillis(LOOP_MILLIS);
+    }
+}
+
+static int countPublished(const char *topic) {
+    int count = 0;
+    for (const MockMqttMessage &message : mockMqttPublished) {
+        if (message.topic == topic) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static void command(const char *suffix, const char *payload) {
+    mockMqttInbox.push_back({std::string("lumen/A1B2C3/") + suffix, payload, false});
+}
+
+void setUp() {
+    mockMqttReset();
+    mockMillis = 0;
+    randomSeed(42);
+    mqtt = new MqttLink();
+    mqtt->begin("A1B2C3", "1.2.3");
+    mqtt->setBroker("broker.local", 1883, "", "");
+}
+
+void tearDown() {
+    delete mqtt;
+}
+
+void test_connect_announces_then_publishes_state() {
+    mqtt->setState(true, 80, false);
+    run(2000);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+    TEST_ASSERT_EQUAL(1, (int)mockMqttConnectAt.size());
+    TEST_ASSERT_EQUAL_STRING("online", mockMqttRetained["lumen/A1B2C3/availability"].c_str());
+    TEST_ASSERT_EQUAL(1, countPublished("homeassistant/light/lumen_A1B2C3/light/config"));
+    TEST_ASSERT_EQUAL(1, countPublished("homeassistant/switch/lumen_A1B2C3/timer/config"));
+    TEST_ASSERT_TRUE(mockMqttRetained["homeassistant/light/lumen_A1B2C3/light/config"].find("\"sw\":\"1.2.3\"") != std::string::npos);
+    TEST_ASSERT_EQUAL(1, countPublished(STATE_TOPIC));
+    TEST_ASSERT_EQUAL_STRING("{\"state\":\"ON\",\"brightness\":80,\"timer\":\"OFF\"}", mockMqttRetained[STATE_TOPIC].c_str());
+}
+
+void test_unchanged_state_is_not_published_again() {
+    mqtt->setState(true, 80, false);
+    run(2000);
+    for (int i = 0; i < 20; i++) {
+        mqtt->setState(true, 80, false);
+        run(100);
+    }
+    TEST_ASSERT_EQUAL(1, countPublished(STATE_TOPIC));
+
+    mqtt->setState(false, 80, false);
+    run(1000);
+    TEST_ASSERT_EQUAL(2, countPublished(STATE_TOPIC));
+}
+
+void test_reconnect_with_broker_state_publishes_nothing() {
+    mockMqttRetained[STATE_TOPIC] = "{\"state\":\"ON\",\"brightness\":80,\"timer\":\"OFF\"}";
+    mqtt->setState(true, 80, false);
+    run(2000);
+    TEST_ASSERT_EQUAL(0, countPublished(STATE_TOPIC));
+    TEST_ASSERT_EQUAL(1, mqtt->getSuppressedCount());
+
+    // Broker holds something stale, so it is put right
+    mockMqttBrokerUp = false;
+    run(100);
+    mockMqttBrokerUp = true;
+    mockMqttRetained[STATE_TOPIC] = "{\"state\":\"OFF\",\"brightness\":80,\"timer\":\"OFF\"}";
+    run(5000);
+    TEST_ASSERT_EQUAL(2, (int)mockMqttConnectAt.size());
+    TEST_ASSERT_EQUAL(1, countPublished(STATE_TOPIC));
+    TEST_ASSERT_EQUAL_STRING("{\"state\":\"ON\",\"brightness\":80,\"timer\":\"OFF\"}", mockMqttRetained[STATE_TOPIC].c_str());
+}
+
+void test_slider_changes_are_coalesced() {
+    mqtt->setState(true, 1, false);
+    run(2000);
+    mockMqttPublished.clear();
+
+    // A slider dragged from 1 to 100 over 3 seconds
+    for (uint8_t level = 2; level <= 100; level++) {
+        mqtt->setState(true, level, false);
+        run(30);
+    }
+    int whileDragging = countPublished(STATE_TOPIC);
+    TEST_ASSERT_TRUE(whileDragging >= 2);
+    TEST_ASSERT_TRUE(whileDragging <= (int)(3000 / MQTT_COALESCE_MAX_MS) + 1);
+
+    run(MQTT_COALESCE_MS + 2 * LOOP_MILLIS);
+    TEST_ASSERT_EQUAL_STRING("{\"state\":\"ON\",\"brightness\":100,\"timer\":\"OFF\"}", mockMqttRetained[STATE_TOPIC].c_str());
+    TEST_ASSERT_TRUE(countPublished(STATE_TOPIC) <= whileDragging + 1);
+}
+
+void test_single_change_waits_to_settle() {
+    mqtt->setState(true, 50, false);
+    run(2000);
+    mqtt->setState(true, 60, false);
+    run(MQTT_COALESCE_MS - 2 * LOOP_MILLIS);
+    TEST_ASSERT_EQUAL(1, countPublished(STATE_TOPIC));
+    run(4 * LOOP_MILLIS);
+    TEST_ASSERT_EQUAL(2, countPublished(STATE_TOPIC));
+}
+
+void test_failed_connects_back_off() {
+    mockMqttBrokerUp = false;
+    run(600000);
+    size_t attempts = mockMqttConnectAt.size();
+    TEST_ASSERT_TRUE(attempts >= 8);
+    TEST_ASSERT_TRUE(attempts <= 20);
+
+    unsigned long delay = MQTT_RETRY_MIN;
+    for (size_t i = 1; i < attempts; i++) {
+        unsigned long gap = mockMqttConnectAt[i] - mockMqttConnectAt[i - 1];
+        TEST_ASSERT_TRUE(gap >= delay);
+        TEST_ASSERT_TRUE(gap <= delay + delay / 2 + LOOP_MILLIS);
+        delay = std::min(delay * 2, MQTT_RETRY_MAX);
+    }
+
+    // Once back, the next try gets in and the wait starts over
+    mockMqttBrokerUp = true;
+    run(MQTT_RETRY_MAX + MQTT_RETRY_MAX / 2 + LOOP_MILLIS);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+}
+
+void test_lost_broker_is_retried_soon_and_will_is_left() {
+    run(2000);
+    mockMqttBrokerUp = false;
+    run(LOOP_MILLIS);
+    TEST_ASSERT_EQUAL_STRING("offline", mockMqttRetained["lumen/A1B2C3/availability"].c_str());
+
+    mockMqttBrokerUp = true;
+    run(MQTT_RETRY_MIN + LOOP_MILLIS);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+    TEST_ASSERT_EQUAL(2, (int)mockMqttConnectAt.size());
+    TEST_ASSERT_EQUAL_STRING("online", mockMqttRetained["lumen/A1B2C3/availability"].c_str());
+}
+
+void test_commands_are_taken_once() {
+    run(2000);
+    command("light/set", "{\"state\":\"OFF\",\"brightness\":35}");
+    command("timer/set", "ON");
+    command("light/set", "{\"brightness\":0}");
+    run(100);
+
+    bool on = true;
+    uint8_t level = 0;
+    TEST_ASSERT_TRUE(mqtt->takePower(on));
+    TEST_ASSERT_FALSE(on);
+    TEST_ASSERT_TRUE(mqtt->takeLevel(level));
+    TEST_ASSERT_EQUAL(35, level);
+    TEST_ASSERT_TRUE(mqtt->takeTimer(on));
+    TEST_ASSERT_TRUE(on);
+    TEST_ASSERT_FALSE(mqtt->takePower(on));
+    TEST_ASSERT_FALSE(mqtt->takeLevel(level));
+    TEST_ASSERT_FALSE(mqtt->takeTimer(on));
+
+    command("light/set", "ON");
+    mockMqttInbox.push_back({"lumen/OTHER1/light/set", "OFF", false});
+    run(100);
+    TEST_ASSERT_TRUE(mqtt->takePower(on));
+    TEST_ASSERT_TRUE(on);
+    TEST_ASSERT_FALSE(mqtt->takePower(on));
+}
+
+void test_no_broker_or_network_means_no_connect() {
+    run(5000, false);
+    TEST_ASSERT_EQUAL(0, (int)mockMqttConnectAt.size());
+
+    run(2000);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+    mqtt->setBroker("", 1883, "", "");
+    run(5000);
+    TEST_ASSERT_FALSE(mqtt->isConnected());
+    TEST_ASSERT_EQUAL(1, (int)mockMqttConnectAt.size());
+}
+
+void test_longest_device_id_keeps_whole_topics() {
+    const char *id = "0123456789ABCDEF0123456789ABCDEF";
+    delete mqtt;
+    mqtt = new MqttLink();
+    mqtt->begin(id, "1.2.3");
+    mqtt->setBroker("broker.local", 1883, "", "");
+    mqtt->setState(true, 80, true);
+    run(2000);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+    TEST_ASSERT_EQUAL_STRING("online", mockMqttRetained[std::string("lumen/") + id + "/availability"].c_str());
+    TEST_ASSERT_EQUAL(1, countPublished((std::string("homeassistant/light/lumen_") + id + "/light/config").c_str()));
+    TEST_ASSERT_EQUAL(1, countPublished((std::string("homeassistant/switch/lumen_") + id + "/timer/config").c_str()));
+    TEST_ASSERT_EQUAL(1, countPublished((std::string("lumen/") + id + "/state").c_str()));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_connect_announces_then_publishes_state);
+    RUN_TEST(test_unchanged_state_is_not_published_again);
+    RUN_TEST(test_reconnect_with_broker_state_publishes_nothing);
+    RUN_TEST(test_slider_changes_are_coalesced);
+    RUN_TEST(test_single_change_waits_to_settle);
+    RUN_TEST(test_failed_connects_back_off);
+    RUN_TEST(test_lost_broker_is_retried_soon_and_will_is_left);
+    RUN_TEST(test_commands_are_taken_once);
+    RUN_TEST(test_no_broker_or_network_means_no_connect);
+    RUN_TEST(test_longest_device_id_keeps_whole_topics);
+
+    return UNITY_END();
+}
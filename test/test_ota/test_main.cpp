@@ -0,0 +1,245 @@
+/*
+    OTA tests - Streams full, gzip and delta images thru the OtaUpdater
+    into a fake flash and checks what lands there.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+
+#include "OtaUpdater.h"
+#include "DeltaDecoder.h"
+#include "FakeFlashBackend.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static FakeFlashBackend backend;
+
+static Bytes makeImage(size_t size, uint32_t seed) {
+    Bytes image(size);
+    for (size_t i = 0; i < size; i++) {
+        seed = (seed * 1103515245UL) + 12345UL;
+        image[i] = (uint8_t)(seed >> 16);
+    }
+
+    return image;
+}
+
+static void md5Of(const Bytes &data, MD5Builder &md5) {
+    md5.begin();
+    for (size_t at = 0; at < data.size(); at += 0x8000) {
+        md5.add(data.data() + at, (uint16_t)std::min(data.size() - at, (size_t)0x8000));
+    }
+    md5.calculate();
+}
+
+static String md5HexOf(const Bytes &data) {
+    MD5Builder md5;
+    md5Of(data, md5);
+
+    return md5.toString();
+}
+
+static void putUint32(Bytes &to, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        to.push_back((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * Makes a delta turning the base into the target in three ops: a copy of
+ * the head of the base, an add of the middle of the target and a copy of
+ * the tail of the base.
+ */
+static Bytes makeDelta(const Bytes &base, const Bytes &target, size_t keepHead, size_t keepTail) {
+    Bytes delta = {'L', 'D', 'L', 'T', DELTA_VERSION, 0, 0, 0};
+    putUint32(delta, base.size());
+    putUint32(delta, target.size());
+    uint8_t digest[16];
+    MD5Builder md5;
+    md5Of(base, md5);
+    md5.getBytes(digest);
+    delta.insert(delta.end(), digest, digest + 16);
+    md5Of(target, md5);
+    md5.getBytes(digest);
+    delta.insert(delta.end(), digest, digest + 16);
+
+    delta.push_back(DELTA_OP_COPY);
+    putUint32(delta, 0);
+    putUint32(delta, keepHead);
+    delta.push_back(DELTA_OP_ADD);
+    putUint32(delta, target.size() - keepHead - keepTail);
+    delta.insert(delta.end(), target.begin() + keepHead, target.end() - keepTail);
+    delta.push_back(DELTA_OP_COPY);
+    putUint32(delta, base.size() - keepTail);
+    putUint32(delta, keepTail);
+    delta.push_back(DELTA_OP_END);
+
+    return delta;
+}
+
+/**
+ * Uploads the file in chunks of the given size, as the web server hands
+ * them over.
+ */
+static bool upload(OtaUpdater &ota, const Bytes &file, size_t chunk, const String &md5) {
+    if (!ota.begin(md5.c_str(), 1024 * 1024)) {
+
+        return false;
+    }
+    for (size_t at = 0; at < file.size(); at += chunk) {
+        if (!ota.write(file.data() + at, std::min(chunk, file.size() - at))) {
+
+            return false;
+        }
+    }
+
+    return ota.end();
+}
+
+void setUp() {
+    backend = FakeFlashBackend();
+    backend.current = makeImage(20000, 1);
+}
+
+void tearDown() {}
+
+void test_full_image_in_any_chunk_size() {
+    Bytes image = makeImage(12345, 2);
+    const size_t chunks[] = {1, 3, 4, 5, 536, 1460, 4096, 20000};
+    for (size_t chunk : chunks) {
+        OtaUpdater ota(backend);
+        TEST_ASSERT_TRUE(upload(ota, image, chunk, md5HexOf(image)));
+        TEST_ASSERT_TRUE(backend.committed);
+        TEST_ASSERT_TRUE(backend.written == image);
+        TEST_ASSERT_EQUAL(OtaUpdater::FORMAT_FULL, ota.getFormat());
+        TEST_ASSERT_EQUAL_UINT32(image.size(), ota.getBytesReceived());
+        TEST_ASSERT_EQUAL_UINT32(image.size(), ota.getBytesWritten());
+    }
+}
+
+void test_gzip_image_passes_thru() {
+    Bytes image = makeImage(5000, 3);
+    image[0] = 0x1F;
+    image[1] = 0x8B;
+    OtaUpdater ota(backend);
+    TEST_ASSERT_TRUE(upload(ota, image, 700, md5HexOf(image)));
+    TEST_ASSERT_EQUAL(OtaUpdater::FORMAT_GZIP, ota.getFormat());
+    TEST_ASSERT_EQUAL_STRING("gzip", ota.getFormatName().c_str());
+    TEST_ASSERT_TRUE(backend.written == image);
+}
+
+void test_image_shorter_than_magic() {
+    Bytes image = {0xE9, 0x01};
+    OtaUpdater ota(backend);
+    TEST_ASSERT_TRUE(upload(ota, image, 1, md5HexOf(image)));
+    TEST_ASSERT_EQUAL(OtaUpdater::FORMAT_FULL, ota.getFormat());
+    TEST_ASSERT_TRUE(backend.written == image);
+}
+
+void test_delta_rebuilds_target() {
+    Bytes target = backend.current;
+    Bytes changed = makeImage(3000, 4);
+    target.erase(target.begin() + 10000, target.begin() + 15000);
+    target.insert(target.begin() + 10000, changed.begin(), changed.end());
+    Bytes delta = makeDelta(backend.current, target, 10000, 5000);
+
+    const size_t chunks[] = {1, 7, 48, 49, 1460};
+    for (size_t chunk : chunks) {
+        OtaUpdater ota(backend);
+        TEST_ASSERT_TRUE(upload(ota, delta, chunk, md5HexOf(delta)));
+        TEST_ASSERT_EQUAL(OtaUpdater::FORMAT_DELTA, ota.getFormat());
+        TEST_ASSERT_TRUE(backend.committed);
+        TEST_ASSERT_TRUE(backend.written == target);
+        TEST_ASSERT_EQUAL_UINT32(delta.size(), ota.getBytesReceived());
+        TEST_ASSERT_EQUAL_UINT32(target.size(), ota.getBytesWritten());
+    }
+}
+
+void test_delta_against_other_base_is_refused() {
+    Bytes otherBase = makeImage(20000, 5);
+    Bytes target = makeImage(20000, 6);
+    Bytes delta = makeDelta(otherBase, target, 1000, 1000);
+    OtaUpdater ota(backend);
+    TEST_ASSERT_FALSE(upload(ota, delta, 512, md5HexOf(delta)));
+    TEST_ASSERT_EQUAL_STRING("Delta was not made against the running firmware!", ota.getError().c_str());
+    TEST_ASSERT_TRUE(backend.aborted);
+    TEST_ASSERT_FALSE(backend.committed);
+}
+
+void test_delta_copy_outside_base_is_refused() {
+    Bytes target = backend.current;
+    Bytes delta = makeDelta(backend.current, target, 10000, 5000);
+    // Last copy now runs past the end of the base
+    delta[delta.size() - 9] += 1;
+    OtaUpdater ota(backend);
+    TEST_ASSERT_FALSE(upload(ota, delta, 512, md5HexOf(delta)));
+    TEST_ASSERT_EQUAL_STRING("Delta copies from outside the running firmware!", ota.getError().c_str());
+    TEST_ASSERT_FALSE(backend.committed);
+}
+
+void test_delta_with_wrong_target_md5_is_refused() {
+    Bytes target = backend.current;
+    target[500] ^= 0xFF;
+    Bytes delta = makeDelta(backend.current, target, 100, 100);
+    delta[32] ^= 0xFF;
+    OtaUpdater ota(backend);
+    TEST_ASSERT_FALSE(upload(ota, delta, 512, md5HexOf(delta)));
+    TEST_ASSERT_EQUAL_STRING("MD5 of the rebuilt image does not match!", ota.getError().c_str());
+    TEST_ASSERT_FALSE(backend.committed);
+}
+
+void test_upload_md5_mismatch_is_refused() {
+    Bytes image = makeImage(4000, 8);
+    Bytes other = makeImage(4000, 9);
+    OtaUpdater ota(backend);
+    TEST_ASSERT_FALSE(upload(ota, image, 1000, md5HexOf(other)));
+    TEST_ASSERT_EQUAL_STRING("MD5 of the uploaded file does not match!", ota.getError().c_str());
+    TEST_ASSERT_TRUE(backend.aborted);
+    TEST_ASSERT_FALSE(backend.committed);
+}
+
+void test_md5_is_required() {
+    OtaUpdater ota(backend);
+    TEST_ASSERT_FALSE(ota.begin("abc", 1024));
+    TEST_ASSERT_TRUE(ota.hasError());
+    TEST_ASSERT_FALSE(ota.isRunning());
+}
+
+void test_flash_write_failure_stops_update() {
+    Bytes image = makeImage(8000, 10);
+    backend.failWriteAt = 3000;
+    OtaUpdater ota(backend);
+    TEST_ASSERT_FALSE(upload(ota, image, 1000, md5HexOf(image)));
+    TEST_ASSERT_EQUAL_STRING("Writing to flash failed!", ota.getError().c_str());
+    TEST_ASSERT_FALSE(ota.isRunning());
+    TEST_ASSERT_FALSE(ota.write(image.data(), 10));
+}
+
+void test_image_larger_than_flash_is_refused() {
+    Bytes image = makeImage(5000, 11);
+    OtaUpdater ota(backend);
+    TEST_ASSERT_TRUE(ota.begin(md5HexOf(image).c_str(), 2048));
+    TEST_ASSERT_FALSE(ota.write(image.data(), image.size()));
+    TEST_ASSERT_FALSE(backend.committed);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_image_in_any_chunk_size);
+    RUN_TEST(test_gzip_image_passes_thru);
+    RUN_TEST(test_image_shorter_than_magic);
+    RUN_TEST(test_delta_rebuilds_target);
+    RUN_TEST(test_delta_against_other_base_is_refused);
+    RUN_TEST(test_delta_copy_outside_base_is_refused);
+    RUN_TEST(test_delta_with_wrong_target_md5_is_refused);
+    RUN_TEST(test_upload_md5_mismatch_is_refused);
+    RUN_TEST(test_md5_is_required);
+    RUN_TEST(test_flash_write_failure_stops_update);
+    RUN_TEST(test_image_larger_than_flash_is_refused);
+
+    return UNITY_END();
+}
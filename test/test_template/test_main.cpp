@@ -0,0 +1,154 @@
+/*
+    Template tests - Fills in the real pages from HtmlContent.h with the
+    names their handlers set and checks nothing is left unfilled, so a
+    name misspelt in a page or a handler fails here rather than on a
+    device.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <unity.h>
+#include <set>
+#include <string>
+
+#include "PageTemplate.h"
+#include "HtmlContent.h"
+#include "Utils.h"
+
+// The names webHandleSettingsPage() sets, kept in step with it
+static const char *SETTINGS_NAMES[] = {
+    "version", "ap_pwd", "ssid", "pwd", "adminuser", "adminpwd", "time_zone", "checked_status",
+    "group", "controlkey", "mqtthost", "mqttport", "mqttuser", "mqttpwd", "vacation_checked",
+    "vaconfrom", "vaconto", "vacofffrom", "vacoffto", "ambient_checked", "ambientthreshold",
+    "ambient_level", "occupancy_checked", "occupancytimeout", "circadian_checked", "warmkelvin",
+    "coolkelvin"
+};
+
+// The names doFillMainPage() sets, kept in step with it
+static const char *MAIN_NAMES[] = {
+    "version", "wifi_addr", "ssid", "status_message", "toggle_hidden", "on_off_status", "cur_time",
+    "clock_sync", "timer_on_off", "schedule_hide", "on_at", "off_at", "group_hidden"
+};
+
+#define SETTINGS_NAME_COUNT (sizeof(SETTINGS_NAMES) / sizeof(SETTINGS_NAMES[0]))
+#define MAIN_NAME_COUNT (sizeof(MAIN_NAMES) / sizeof(MAIN_NAMES[0]))
+
+static ESP8266WebServer web;
+
+/**
+ * Finds the names of the place-holders in a page.
+ */
+static std::set<std::string> findNames(const char *page) {
+    std::set<std::string> names;
+    for (const char *at = strstr(page, "${"); at != nullptr; at = strstr(at + 2, "${")) {
+        const char *end = strchr(at + 2, '}');
+        TEST_ASSERT_NOT_NULL(end);
+        names.insert(std::string(at + 2, end - at - 2));
+    }
+
+    return names;
+}
+
+/**
+ * Sets every given name but the one to skip, each to a value with
+ * characters a user could put in a setting, escaped as the handlers do.
+ *
+ * @return Returns the number of names the page took.
+ */
+static size_t fill(PageTemplate &page, const char **names, size_t count, const char *skip = nullptr) {
+    size_t taken = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (skip != nullptr && strcmp(names[i], skip) == 0) {
+            continue;
+        }
+        String value = Utils::htmlEscape(String(F("<b>\"")) + names[i] + F("\" & ${version}</b>"));
+        taken += page.set(F(names[i]), value) ? 1 : 0;
+    }
+
+    return taken;
+}
+
+static void assertSentWhole(PageTemplate &page) {
+    TEST_ASSERT_EQUAL(200, web.mockCode);
+    TEST_ASSERT_EQUAL_STRING("text/html", web.mockContentType.c_str());
+    TEST_ASSERT_EQUAL(-1, web.mockBody.indexOf("${"));
+    TEST_ASSERT_EQUAL_UINT32(web.mockBody.length(), web.mockContentLength);
+    TEST_ASSERT_EQUAL_UINT32(page.getLength(), web.mockContentLength);
+}
+
+void setUp() {
+    web.mockReset();
+}
+
+void tearDown() {}
+
+void test_settings_page_names_match_handler() {
+    std::set<std::string> handlerNames(SETTINGS_NAMES, SETTINGS_NAMES + SETTINGS_NAME_COUNT);
+    TEST_ASSERT_EQUAL(SETTINGS_NAME_COUNT, handlerNames.size());
+    TEST_ASSERT_TRUE(findNames(SETTINGS_PAGE) == handlerNames);
+}
+
+void test_settings_page_fills_in_completely() {
+    PageTemplate page(SETTINGS_PAGE);
+    TEST_ASSERT_TRUE(page.isValid());
+    TEST_ASSERT_EQUAL(SETTINGS_NAME_COUNT, fill(page, SETTINGS_NAMES, SETTINGS_NAME_COUNT));
+    TEST_ASSERT_TRUE(page.isComplete());
+    page.send(web, 200, F("text/html"));
+    assertSentWhole(page);
+    TEST_ASSERT_TRUE(web.mockBody.indexOf("&lt;b&gt;&quot;coolkelvin&quot; &amp; &#36;{version}&lt;/b&gt;") != -1);
+
+    // Gathered into full sized writes, not one per piece
+    TEST_ASSERT_TRUE(web.mockWrites <= web.mockBody.length() / TEMPLATE_SEND_BUFFER + 1);
+}
+
+void test_settings_page_missing_name_is_refused() {
+    for (size_t i = 0; i < SETTINGS_NAME_COUNT; i++) {
+        PageTemplate page(SETTINGS_PAGE);
+        web.mockReset();
+        fill(page, SETTINGS_NAMES, SETTINGS_NAME_COUNT, SETTINGS_NAMES[i]);
+        TEST_ASSERT_FALSE(page.isComplete());
+        page.send(web, 200, F("text/html"));
+        TEST_ASSERT_EQUAL(500, web.mockCode);
+        TEST_ASSERT_EQUAL(-1, web.mockBody.indexOf("${"));
+    }
+}
+
+void test_main_page_names_match_handler() {
+    std::set<std::string> handlerNames(MAIN_NAMES, MAIN_NAMES + MAIN_NAME_COUNT);
+    TEST_ASSERT_EQUAL(MAIN_NAME_COUNT, handlerNames.size());
+    TEST_ASSERT_TRUE(findNames(MAIN_PAGE) == handlerNames);
+}
+
+void test_main_page_sends_again_unchanged() {
+    PageTemplate page(MAIN_PAGE);
+    TEST_ASSERT_EQUAL(MAIN_NAME_COUNT, fill(page, MAIN_NAMES, MAIN_NAME_COUNT));
+    page.send(web, 200, F("text/html"));
+    assertSentWhole(page);
+    String first = web.mockBody;
+
+    // A popup shown once, then the page as it was
+    page.set(F("status_message"), F("Settings saved"));
+    web.mockReset();
+    page.send(web, 200, F("text/html"));
+    assertSentWhole(page);
+    TEST_ASSERT_TRUE(web.mockBody.indexOf("Settings saved") != -1);
+
+    page.set(F("status_message"), Utils::htmlEscape(F("<b>\"status_message\" & ${version}</b>")));
+    web.mockReset();
+    page.send(web, 200, F("text/html"));
+    TEST_ASSERT_EQUAL_STRING(first.c_str(), web.mockBody.c_str());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_settings_page_names_match_handler);
+    RUN_TEST(test_settings_page_fills_in_completely);
+    RUN_TEST(test_settings_page_missing_name_is_refused);
+    RUN_TEST(test_main_page_names_match_handler);
+    RUN_TEST(test_main_page_sends_again_unchanged);
+
+    return UNITY_END();
+}
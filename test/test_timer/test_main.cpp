@@ -0,0 +1,405 @@
+/*
+    Timer simulation - Runs the timer logic of the firmware against a
+    virtual clock, with scripted NTP, button and web events, for up to a
+    year at a time and checks every light transition it makes.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+#include <algorithm>
+#include <vector>
+
+#include "DeviceClock.h"
+#include "LightTimer.h"
+#include "LightCalendar.h"
+#include "VacationPlanner.h"
+#include "DaySchedule.h"
+#include "Utils.h"
+
+#define SIM_START_EPOCH 1767225600UL // <-- 2026-01-01, local midnight of which the simulation starts at
+#define SIM_LOOP_MILLIS 5000UL // <------ Time between loop() passes, always under a minute
+#define SIM_NTP_INTERVAL 60UL // <------- Seconds between NTP updates, the NTPClient default
+
+#define SIM_SOURCE_BUTTON 1
+#define SIM_SOURCE_WEB 2
+#define SIM_SOURCE_TIMER 9
+
+/**
+ * A change of the lights made while simulating.
+ */
+struct SimTransition {
+    long           localDay        ;
+    int            localTime24     ;
+    bool           on              ;
+    uint8_t        source          ;
+    uint64_t       trueMillis      ; // when it really happened, from the epoch
+};
+
+/**
+ * The TimerSim class is the timer part of the firmware's loop() lifted out
+ * of main.cpp: doTimerFunctions() with getLocalEpochDay() and getLocalTime24()
+ * and doChangeLightState() cut down to recording the change. The day's
+ * schedule is resolved and run by the same DaySchedule the firmware uses. It runs off
+ * the mock millis(), which it moves along as true time passes, faster or
+ * slower than true time by the drift of the crystal being simulated.
+ *
+ * @author Scott Griffis
+ * @date 10-17-2026
+ */
+class TimerSim {
+    private:
+        uint64_t       elapsedMillis   ;
+        unsigned long  startMillis     ;
+
+    public:
+        DeviceClock    clock           ;
+        LightTimer     timer           ;
+        LightCalendar  calendar        ;
+        VacationPlanner vacation       ;
+        DaySchedule    schedule        ;
+        int            onTime          ;
+        int            offTime         ;
+        int            timezone        ;
+        bool           isDst           ;
+        bool           isTimerOn       ;
+        bool           isVacationOn    ;
+        bool           isAmbientLight  ; // what isAmbientLight() would say
+        bool           isNtpReachable  ;
+        long           crystalPpm      ;
+        bool           lightsOn        ;
+        uint64_t       trueMillis      ;
+        uint32_t       nextNtpEpoch    ;
+        std::vector<SimTransition> transitions;
+
+        TimerSim(int onTime, int offTime, int timezone) : schedule(timer, calendar, vacation) {
+            // Start near a millis roll over, a year of millis rolls over seven times anyway
+            startMillis = 0xFFFFFFFFUL - 600000UL;
+            mockMillis = startMillis;
+            elapsedMillis = 0;
+            this->onTime = onTime;
+            this->offTime = offTime;
+            this->timezone = timezone;
+            isDst = false;
+            isTimerOn = true;
+            isVacationOn = false;
+            isAmbientLight = false;
+            isNtpReachable = true;
+            crystalPpm = 0;
+            lightsOn = false;
+            trueMillis = ((uint64_t)SIM_START_EPOCH - (timezone * 3600LL)) * 1000ULL;
+            nextNtpEpoch = trueEpoch();
+        }
+
+        uint32_t trueEpoch() {
+
+            return (uint32_t)(trueMillis / 1000ULL);
+        }
+
+        long localEpochDay() {
+            long offset = (timezone + (isDst ? 1L : 0L)) * 3600L;
+
+            return ((long)clock.getEpoch() + offset) / 86400L;
+        }
+
+        int localTime24() {
+            int time24 = (clock.getHours() * 100) + clock.getMinutes();
+
+            return Utils::adjustIntTimeForTimezone(time24, timezone, isDst);
+        }
+
+        void changeLightState(bool on, uint8_t source) {
+            if (lightsOn != on) {
+                lightsOn = on;
+                transitions.push_back({clock.isSet() ? localEpochDay() : -1L, clock.isSet() ? localTime24() : -1, on, source, trueMillis});
+            }
+        }
+
+        void changeSchedule(int onTime, int offTime) {
+            this->onTime = onTime;
+            this->offTime = offTime;
+            schedule.invalidate();
+        }
+
+        /**
+         * One pass of loop() as far as the timer goes, see doTimerFunctions().
+         */
+        void loop() {
+            clock.update();
+            if (isNtpReachable && trueEpoch() >= nextNtpEpoch) {
+                // NTPClient only gives whole seconds so take mid-second, as main.cpp does
+                clock.setTime(trueEpoch(), 500, CLOCK_SOURCE_NTP, 2, true);
+                nextNtpEpoch = trueEpoch() + SIM_NTP_INTERVAL;
+            }
+
+            if (clock.isSet()) {
+                schedule.resolve(localEpochDay(), onTime, offTime, isVacationOn);
+            }
+
+            switch (schedule.evaluate(clock.isSet() ? localTime24() : -1, isTimerOn, isVacationOn, isAmbientLight)) {
+                case TIMER_ACTION_ON:
+                    changeLightState(true, SIM_SOURCE_TIMER);
+                    break;
+                case TIMER_ACTION_OFF:
+                    changeLightState(false, SIM_SOURCE_TIMER);
+                    break;
+            }
+        }
+
+        /**
+         * Lets true time run on to the given epoch, passing through loop()
+         * as the device would.
+         */
+        void runUntil(uint32_t epoch) {
+            while (trueEpoch() < epoch) {
+                trueMillis += SIM_LOOP_MILLIS;
+                elapsedMillis += SIM_LOOP_MILLIS;
+                mockMillis = startMillis + (unsigned long)((elapsedMillis * (uint64_t)(1000000L + crystalPpm)) / 1000000ULL);
+                loop();
+            }
+        }
+
+        /**
+         * Runs on to the given local time on the given day of the simulation,
+         * day 0 being the day it started.
+         */
+        void runUntilLocal(int day, int time24) {
+            long offset = (timezone + (isDst ? 1L : 0L)) * 3600L;
+            runUntil(SIM_START_EPOCH + (day * 86400L) + ((time24 / 100) * 3600L) + ((time24 % 100) * 60L) - offset);
+        }
+};
+
+/**
+ * Checks the timer's transitions over the days simulated: exactly one on
+ * and one off each local day, each in the minute it was scheduled for.
+ * The first transition, which may just line the lights up with the
+ * schedule at start, and the first and last days are left out.
+ */
+static void assertDailyTransitions(TimerSim &sim, int days, int expectedOnTime, int expectedOffTime) {
+    std::vector<int> ons(days + 2, 0);
+    std::vector<int> offs(days + 2, 0);
+    long firstDay = (long)(SIM_START_EPOCH / 86400UL);
+    for (size_t i = 1; i < sim.transitions.size(); i++) {
+        const SimTransition &t = sim.transitions[i];
+        TEST_ASSERT_EQUAL(SIM_SOURCE_TIMER, t.source);
+        TEST_ASSERT_TRUE_MESSAGE(t.on != sim.transitions[i - 1].on, "Transition repeats the last one");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(t.on ? expectedOnTime : expectedOffTime, t.localTime24, "Transition outside its minute");
+        long day = t.localDay - firstDay;
+        TEST_ASSERT_TRUE(day >= 0 && day <= days);
+        (t.on ? ons : offs)[day]++;
+    }
+    for (int day = 1; day < days; day++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(1, ons[day], "Not one on transition in the day");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(1, offs[day], "Not one off transition in the day");
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_year_of_overnight_schedule() {
+    TimerSim sim(2200, 600, -5);
+    sim.runUntilLocal(365, 1200);
+
+    // Lit at start, midnight being inside 22:00 to 06:00, then off and on each day
+    TEST_ASSERT_TRUE(sim.transitions[0].on);
+    TEST_ASSERT_EQUAL_INT(0, sim.transitions[0].localTime24);
+    TEST_ASSERT_EQUAL_INT(1 + (365 * 2) + 1, (int)sim.transitions.size());
+    assertDailyTransitions(sim, 365, 2200, 600);
+}
+
+void test_year_of_daytime_schedule() {
+    TimerSim sim(730, 1815, 1);
+    sim.runUntilLocal(365, 0);
+
+    // Already off at start so the first change is the first on time
+    TEST_ASSERT_TRUE(sim.transitions[0].on);
+    TEST_ASSERT_EQUAL_INT(730, sim.transitions[0].localTime24);
+    TEST_ASSERT_EQUAL_INT(365 * 2, (int)sim.transitions.size());
+    assertDailyTransitions(sim, 365, 730, 1815);
+}
+
+void test_time_zones_either_side_of_utc() {
+    const int timezones[] = {-12, -11, -8, -1, 0, 1, 9, 12, 13, 14};
+    for (int timezone : timezones) {
+        TimerSim sim(2330, 30, timezone);
+        sim.runUntilLocal(31, 1200);
+        assertDailyTransitions(sim, 31, 2330, 30);
+    }
+}
+
+void test_dst_change_skips_and_repeats_an_hour() {
+    TimerSim sim(1800, 230, -5);
+
+    // Spring forward at 02:00, the off time at 02:30 is skipped over
+    sim.runUntilLocal(66, 200);
+    sim.isDst = true;
+    sim.runUntilLocal(66, 400);
+    const SimTransition &springOff = sim.transitions.back();
+    TEST_ASSERT_FALSE(springOff.on);
+    TEST_ASSERT_EQUAL_INT(300, springOff.localTime24);
+    size_t springCount = sim.transitions.size();
+
+    // Fall back at 02:00, the hour before the off time comes round twice
+    sim.runUntilLocal(304, 159);
+    sim.isDst = false;
+    sim.runUntilLocal(304, 400);
+    const SimTransition &fallOff = sim.transitions.back();
+    TEST_ASSERT_FALSE(fallOff.on);
+    TEST_ASSERT_EQUAL_INT(230, fallOff.localTime24);
+    TEST_ASSERT_EQUAL_INT(1, (int)std::count_if(sim.transitions.begin(), sim.transitions.end(), [&](const SimTransition &t) {
+
+        return t.localDay == fallOff.localDay && !t.on;
+    }));
+
+    // Every day in between had one on and one off
+    TEST_ASSERT_EQUAL_INT((int)springCount + ((304 - 66) * 2), (int)sim.transitions.size());
+}
+
+void test_manual_change_sticks_until_next_crossing() {
+    TimerSim sim(2200, 600, 0);
+    sim.runUntilLocal(1, 2300);
+    TEST_ASSERT_TRUE(sim.lightsOn);
+
+    // Off by the button in the on zone, stays off through the off time
+    sim.changeLightState(false, SIM_SOURCE_BUTTON);
+    sim.runUntilLocal(2, 2159);
+    TEST_ASSERT_FALSE(sim.lightsOn);
+    TEST_ASSERT_EQUAL(SIM_SOURCE_BUTTON, sim.transitions.back().source);
+    sim.runUntilLocal(2, 2201);
+    TEST_ASSERT_TRUE(sim.lightsOn);
+
+    // On from the web in the off zone, stays on until the off time
+    sim.runUntilLocal(3, 1200);
+    sim.changeLightState(true, SIM_SOURCE_WEB);
+    sim.runUntilLocal(3, 2300);
+    TEST_ASSERT_TRUE(sim.lightsOn);
+    TEST_ASSERT_EQUAL(SIM_SOURCE_WEB, sim.transitions.back().source);
+    sim.runUntilLocal(4, 601);
+    TEST_ASSERT_FALSE(sim.lightsOn);
+    TEST_ASSERT_EQUAL(SIM_SOURCE_TIMER, sim.transitions.back().source);
+    TEST_ASSERT_EQUAL_INT(600, sim.transitions.back().localTime24);
+}
+
+void test_schedule_change_applies_at_once() {
+    TimerSim sim(2200, 600, 3);
+    sim.runUntilLocal(1, 1200);
+    TEST_ASSERT_FALSE(sim.lightsOn);
+
+    sim.changeSchedule(1100, 1300);
+    sim.runUntilLocal(1, 1201);
+    TEST_ASSERT_TRUE(sim.lightsOn);
+    TEST_ASSERT_EQUAL_INT(1200, sim.transitions.back().localTime24);
+    sim.runUntilLocal(1, 1301);
+    TEST_ASSERT_FALSE(sim.lightsOn);
+}
+
+void test_timer_off_leaves_lights_alone() {
+    TimerSim sim(2200, 600, 0);
+    sim.runUntilLocal(1, 1200);
+    sim.isTimerOn = false;
+    size_t count = sim.transitions.size();
+    sim.runUntilLocal(10, 1200);
+    TEST_ASSERT_EQUAL_INT((int)count, (int)sim.transitions.size());
+
+    // Back on in the off zone lines the lights up without a change
+    sim.isTimerOn = true;
+    sim.runUntilLocal(10, 2201);
+    TEST_ASSERT_EQUAL_INT((int)count + 1, (int)sim.transitions.size());
+}
+
+void test_drifting_crystal_through_ntp_outage() {
+    TimerSim sim(2000, 500, -7);
+    sim.crystalPpm = 300;
+
+    // Two days with NTP learns the drift, then a week without it
+    sim.runUntilLocal(2, 1200);
+    TEST_ASSERT_INT_WITHIN(30, 300, -sim.clock.getDriftPpm());
+    sim.isNtpReachable = false;
+    sim.runUntilLocal(9, 1200);
+    TEST_ASSERT_INT_WITHIN(5, (long)sim.trueEpoch(), (long)sim.clock.getEpoch());
+    sim.isNtpReachable = true;
+    sim.runUntilLocal(365, 1200);
+
+    assertDailyTransitions(sim, 365, 2000, 500);
+    for (size_t i = 1; i < sim.transitions.size(); i++) {
+        // Each happened within a few seconds of the true start of its minute
+        const SimTransition &t = sim.transitions[i];
+        long offset = (sim.timezone + (sim.isDst ? 1L : 0L)) * 3600L;
+        int64_t localMillis = (int64_t)t.trueMillis + (offset * 1000LL);
+        int64_t intoMinute = localMillis % 60000LL;
+        TEST_ASSERT_TRUE_MESSAGE(intoMinute < 10000LL || intoMinute > 55000LL, "Transition far from its minute");
+    }
+}
+
+void test_clock_unset_until_ntp() {
+    TimerSim sim(0, 2359, 0);
+    sim.isNtpReachable = false;
+    sim.runUntilLocal(0, 1200);
+    TEST_ASSERT_FALSE(sim.clock.isSet());
+    TEST_ASSERT_EQUAL_INT(0, (int)sim.transitions.size());
+
+    sim.isNtpReachable = true;
+    sim.runUntilLocal(0, 1201);
+    TEST_ASSERT_TRUE(sim.lightsOn);
+}
+
+void test_calendar_ambient_and_vacation_steer_the_day() {
+    TimerSim sim(1800, 2300, 0);
+    uint16_t firstDay = (uint16_t)(SIM_START_EPOCH / 86400UL);
+
+    // Off all day on day 2 by the calendar
+    CalendarRule rule = {(uint16_t)(firstDay + 2), (uint16_t)(firstDay + 2), 2000, 2000, CALENDAR_RULE_DATES, 0};
+    TEST_ASSERT_TRUE(sim.calendar.add(rule));
+    sim.runUntilLocal(2, 0);
+    size_t count = sim.transitions.size();
+    sim.runUntilLocal(3, 0);
+    TEST_ASSERT_EQUAL_INT((int)count, (int)sim.transitions.size());
+    sim.runUntilLocal(3, 1801);
+    TEST_ASSERT_TRUE(sim.lightsOn);
+    TEST_ASSERT_EQUAL_INT(1800, sim.transitions.back().localTime24);
+
+    // Still light out at the on time, so the timer leaves it to the sensor
+    sim.runUntilLocal(4, 1200);
+    sim.isAmbientLight = true;
+    sim.runUntilLocal(4, 1801);
+    TEST_ASSERT_FALSE(sim.lightsOn);
+    sim.isAmbientLight = false;
+    sim.runUntilLocal(5, 1801);
+    TEST_ASSERT_TRUE(sim.lightsOn);
+
+    // On vacation the planned times are followed, even with the timer off
+    sim.runUntilLocal(6, 1200);
+    sim.vacation.setSeed(42);
+    sim.vacation.setBounds(1900, 1930, 2200, 2230);
+    sim.isVacationOn = true;
+    sim.isTimerOn = false;
+    sim.schedule.invalidate();
+    sim.runUntilLocal(7, 1200);
+    int onTime;
+    int offTime;
+    sim.vacation.plan(firstDay + 6, onTime, offTime);
+    TEST_ASSERT_EQUAL(firstDay + 6, sim.transitions.back().localDay);
+    TEST_ASSERT_EQUAL_INT(offTime, sim.transitions.back().localTime24);
+    TEST_ASSERT_EQUAL_INT(onTime, sim.transitions[sim.transitions.size() - 2].localTime24);
+    TEST_ASSERT_TRUE(onTime >= 1900 && onTime <= 1930);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_year_of_overnight_schedule);
+    RUN_TEST(test_year_of_daytime_schedule);
+    RUN_TEST(test_time_zones_either_side_of_utc);
+    RUN_TEST(test_dst_change_skips_and_repeats_an_hour);
+    RUN_TEST(test_manual_change_sticks_until_next_crossing);
+    RUN_TEST(test_schedule_change_applies_at_once);
+    RUN_TEST(test_timer_off_leaves_lights_alone);
+    RUN_TEST(test_drifting_crystal_through_ntp_outage);
+    RUN_TEST(test_clock_unset_until_ntp);
+    RUN_TEST(test_calendar_ambient_and_vacation_steer_the_day);
+
+    return UNITY_END();
+}
@@ -0,0 +1,322 @@
+/*
+    UDP control tests - Checks that signed commands are carried out once,
+    that replays, stale nonces and bad commands are refused with a signed
+    reply, and that anything without the key is dropped unanswered.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <bearssl/bearssl.h>
+#include <unity.h>
+
+#include "UdpControl.h"
+
+#define TEST_KEY "correct horse battery staple"
+#define TEST_NONCE 0xC0FFEE11UL
+
+static const IPAddress CONTROLLER_IP(192, 168, 1, 50);
+static const uint16_t CONTROLLER_PORT = 50123;
+
+static void putUint32(uint8_t *at, uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        at[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static uint32_t getUint32(const uint8_t *at) {
+
+    return at[0] | (at[1] << 8) | (at[2] << 16) | ((uint32_t)at[3] << 24);
+}
+
+/**
+ * Works out a packet's MAC as a controller holding the given key would.
+ */
+static void macOf(const char *key, const uint8_t *packet, uint8_t *mac) {
+    br_hmac_key_context keyContext;
+    br_hmac_context context;
+    br_hmac_key_init(&keyContext, &br_sha256_vtable, key, strlen(key));
+    br_hmac_init(&context, &keyContext, 0);
+    br_hmac_update(&context, packet, UDP_CONTROL_SIGNED_SIZE);
+    br_hmac_out(&context, mac);
+}
+
+static void send(uint8_t command, uint8_t arg, uint32_t nonce, uint32_t counter, const char *key = TEST_KEY) {
+    uint8_t packet[UDP_CONTROL_PACKET_SIZE] = {'L', 'C', UDP_CONTROL_VERSION, command, arg};
+    putUint32(packet + 8, nonce);
+    putUint32(packet + 12, counter);
+    uint8_t mac[32];
+    macOf(key, packet, mac);
+    memcpy(packet + UDP_CONTROL_SIGNED_SIZE, mac, UDP_CONTROL_MAC_SIZE);
+    mockUdpDeliver(UDP_CONTROL_PORT, CONTROLLER_IP, CONTROLLER_PORT, packet, sizeof(packet));
+}
+
+/**
+ * Handles one request as loop() does, replying with lights on at 40% and
+ * the timer off.
+ */
+static uint8_t roundTrip(UdpControl &control, uint8_t &arg) {
+    uint8_t command = control.handle(arg);
+    control.reply(true, 40, false);
+
+    return command;
+}
+
+/**
+ * Checks the last reply went back to the controller signed with the key
+ * and carrying the given status, nonce and counter.
+ */
+static void checkReply(uint8_t command, uint8_t status, uint32_t nonce, uint32_t counter) {
+    TEST_ASSERT_EQUAL_UINT32(1, mockUdpSent.size());
+    const MockUdpPacket &sent = mockUdpSent.back();
+    TEST_ASSERT_TRUE(sent.remoteIp == CONTROLLER_IP);
+    TEST_ASSERT_EQUAL_UINT16(CONTROLLER_PORT, sent.remotePort);
+    TEST_ASSERT_EQUAL_UINT32(UDP_CONTROL_PACKET_SIZE, sent.data.size());
+    const uint8_t *response = sent.data.data();
+    TEST_ASSERT_EQUAL_UINT8('L', response[0]);
+    TEST_ASSERT_EQUAL_UINT8('C', response[1]);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CONTROL_VERSION, response[2]);
+    TEST_ASSERT_EQUAL_HEX8(command | 0x80, response[3]);
+    TEST_ASSERT_EQUAL_UINT8(status, response[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, response[5]);
+    TEST_ASSERT_EQUAL_UINT8(40, response[6]);
+    TEST_ASSERT_EQUAL_HEX32(nonce, getUint32(response + 8));
+    TEST_ASSERT_EQUAL_UINT32(counter, getUint32(response + 12));
+    uint8_t mac[32];
+    macOf(TEST_KEY, response, mac);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(mac, response + UDP_CONTROL_SIGNED_SIZE, UDP_CONTROL_MAC_SIZE);
+    mockUdpSent.clear();
+}
+
+static void startControl(UdpControl &control) {
+    control.begin(TEST_NONCE);
+    control.setKey(TEST_KEY);
+}
+
+void setUp() {
+    mockUdpReset();
+    mockMillis = 0;
+    mockMicrosPerCall = 0;
+    mockMicrosSpent = 0;
+}
+
+void tearDown() {}
+
+void test_mac_is_hmac_sha256() {
+    // RFC 4231 test case 2, so MACs match those of any controller
+    const char *data = "what do ya want for nothing?";
+    const uint8_t expected[32] = {
+        0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+        0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43
+    };
+    br_hmac_key_context keyContext;
+    br_hmac_context context;
+    uint8_t mac[32];
+    br_hmac_key_init(&keyContext, &br_sha256_vtable, "Jefe", 4);
+    br_hmac_init(&context, &keyContext, 0);
+    br_hmac_update(&context, data, strlen(data));
+    br_hmac_out(&context, mac);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, mac, 32);
+}
+
+void test_good_commands_are_carried_out() {
+    UdpControl control;
+    startControl(control);
+    uint8_t arg;
+
+    send(UDP_CMD_POWER, 1, TEST_NONCE, 1);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_POWER, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT8(1, arg);
+    checkReply(UDP_CMD_POWER, UDP_STATUS_OK, TEST_NONCE, 1);
+
+    send(UDP_CMD_LEVEL, 40, TEST_NONCE, 2);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_LEVEL, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT8(40, arg);
+    checkReply(UDP_CMD_LEVEL, UDP_STATUS_OK, TEST_NONCE, 2);
+
+    // Counters only have to go up, not one at a time
+    send(UDP_CMD_TOGGLE, 0, TEST_NONCE, 10);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_TOGGLE, roundTrip(control, arg));
+    checkReply(UDP_CMD_TOGGLE, UDP_STATUS_OK, TEST_NONCE, 10);
+
+    TEST_ASSERT_EQUAL_UINT32(3, control.getCommandCount());
+}
+
+void test_replays_are_stale() {
+    UdpControl control;
+    startControl(control);
+    uint8_t arg;
+    send(UDP_CMD_POWER, 1, TEST_NONCE, 5);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_POWER, roundTrip(control, arg));
+    mockUdpSent.clear();
+
+    send(UDP_CMD_POWER, 1, TEST_NONCE, 5);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    checkReply(UDP_CMD_POWER, UDP_STATUS_STALE, TEST_NONCE, 5);
+
+    send(UDP_CMD_POWER, 0, TEST_NONCE, 4);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    checkReply(UDP_CMD_POWER, UDP_STATUS_STALE, TEST_NONCE, 5);
+}
+
+void test_wrong_nonce_is_stale_and_tells_the_current_one() {
+    UdpControl control;
+    startControl(control);
+    uint8_t arg;
+    send(UDP_CMD_LEVEL, 70, TEST_NONCE, 3);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_LEVEL, roundTrip(control, arg));
+    mockUdpSent.clear();
+
+    // A controller still on the nonce from before a reboot
+    send(UDP_CMD_LEVEL, 70, TEST_NONCE + 1, 50);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    checkReply(UDP_CMD_LEVEL, UDP_STATUS_STALE, TEST_NONCE, 3);
+
+    // Which it can then catch up from
+    send(UDP_CMD_LEVEL, 70, TEST_NONCE, 4);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_LEVEL, roundTrip(control, arg));
+    checkReply(UDP_CMD_LEVEL, UDP_STATUS_OK, TEST_NONCE, 4);
+}
+
+void test_unauthenticated_packets_are_dropped() {
+    UdpControl control;
+    startControl(control);
+    uint8_t arg;
+
+    send(UDP_CMD_POWER, 1, TEST_NONCE, 1, "wrong key");
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT32(0, mockUdpSent.size());
+
+    uint8_t shortPacket[UDP_CONTROL_PACKET_SIZE - 1] = {'L', 'C', UDP_CONTROL_VERSION, UDP_CMD_HELLO};
+    mockUdpDeliver(UDP_CONTROL_PORT, CONTROLLER_IP, CONTROLLER_PORT, shortPacket, sizeof(shortPacket));
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT32(0, mockUdpSent.size());
+
+    uint8_t longPacket[UDP_CONTROL_PACKET_SIZE + 1] = {'L', 'C', UDP_CONTROL_VERSION, UDP_CMD_HELLO};
+    mockUdpDeliver(UDP_CONTROL_PORT, CONTROLLER_IP, CONTROLLER_PORT, longPacket, sizeof(longPacket));
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT32(0, mockUdpSent.size());
+
+    // Dropped packets do not move the counter on either
+    TEST_ASSERT_EQUAL_UINT32(0, control.getCommandCount());
+    send(UDP_CMD_POWER, 1, TEST_NONCE, 1);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_POWER, roundTrip(control, arg));
+    checkReply(UDP_CMD_POWER, UDP_STATUS_OK, TEST_NONCE, 1);
+}
+
+void test_level_out_of_range_is_a_bad_command() {
+    UdpControl control;
+    startControl(control);
+    uint8_t arg;
+
+    send(UDP_CMD_LEVEL, 0, TEST_NONCE, 1);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    checkReply(UDP_CMD_LEVEL, UDP_STATUS_BAD_COMMAND, TEST_NONCE, 0);
+
+    send(UDP_CMD_LEVEL, 101, TEST_NONCE, 2);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    checkReply(UDP_CMD_LEVEL, UDP_STATUS_BAD_COMMAND, TEST_NONCE, 0);
+
+    send(UDP_CMD_STATUS + 1, 0, TEST_NONCE, 3);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    checkReply(UDP_CMD_STATUS + 1, UDP_STATUS_BAD_COMMAND, TEST_NONCE, 0);
+
+    // Refused commands do not use up their counters
+    send(UDP_CMD_LEVEL, 100, TEST_NONCE, 1);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_LEVEL, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT8(100, arg);
+    checkReply(UDP_CMD_LEVEL, UDP_STATUS_OK, TEST_NONCE, 1);
+}
+
+void test_hello_and_status_are_answered_with_any_nonce() {
+    UdpControl control;
+    startControl(control);
+    uint8_t arg;
+    send(UDP_CMD_POWER, 1, TEST_NONCE, 8);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_POWER, roundTrip(control, arg));
+    mockUdpSent.clear();
+
+    send(UDP_CMD_HELLO, 0, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_HELLO, roundTrip(control, arg));
+    checkReply(UDP_CMD_HELLO, UDP_STATUS_OK, TEST_NONCE, 8);
+
+    send(UDP_CMD_STATUS, 0, 0x12345678, 1);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_STATUS, roundTrip(control, arg));
+    checkReply(UDP_CMD_STATUS, UDP_STATUS_OK, TEST_NONCE, 8);
+
+    // Neither one moves the counter on
+    send(UDP_CMD_POWER, 0, TEST_NONCE, 9);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_POWER, roundTrip(control, arg));
+    checkReply(UDP_CMD_POWER, UDP_STATUS_OK, TEST_NONCE, 9);
+}
+
+void test_round_trips_are_counted_and_timed() {
+    UdpControl control;
+    startControl(control);
+    uint8_t arg;
+    mockMicrosPerCall = 25;
+
+    // Nothing to receive costs nothing
+    roundTrip(control, arg);
+    TEST_ASSERT_EQUAL_UINT32(0, control.getHandleMicros());
+
+    // A handled request is timed on the way in and again on the way out
+    send(UDP_CMD_HELLO, 0, 0, 0);
+    roundTrip(control, arg);
+    TEST_ASSERT_EQUAL_UINT32(50, control.getHandleMicros());
+    TEST_ASSERT_EQUAL_UINT32(1, control.getCommandCount());
+    TEST_ASSERT_EQUAL_UINT32(1, mockUdpSent.size());
+
+    // A dropped one is only timed on the way in and never answered
+    send(UDP_CMD_HELLO, 0, 0, 0, "wrong key");
+    roundTrip(control, arg);
+    TEST_ASSERT_EQUAL_UINT32(75, control.getHandleMicros());
+    TEST_ASSERT_EQUAL_UINT32(1, control.getCommandCount());
+    TEST_ASSERT_EQUAL_UINT32(1, mockUdpSent.size());
+
+    // Refused ones are still answered, so they count as round trips
+    send(UDP_CMD_POWER, 1, TEST_NONCE + 1, 1);
+    roundTrip(control, arg);
+    TEST_ASSERT_EQUAL_UINT32(125, control.getHandleMicros());
+    TEST_ASSERT_EQUAL_UINT32(2, control.getCommandCount());
+    TEST_ASSERT_EQUAL_UINT32(2, mockUdpSent.size());
+}
+
+void test_empty_key_stops_listening() {
+    UdpControl control;
+    control.begin(TEST_NONCE);
+    control.setKey("");
+    uint8_t arg;
+    send(UDP_CMD_HELLO, 0, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT32(0, mockUdpSent.size());
+
+    // Nothing was bound, so the network never delivered it
+    mockUdpReset();
+    control.setKey(TEST_KEY);
+    send(UDP_CMD_HELLO, 0, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_HELLO, roundTrip(control, arg));
+    checkReply(UDP_CMD_HELLO, UDP_STATUS_OK, TEST_NONCE, 0);
+
+    control.setKey("");
+    send(UDP_CMD_HELLO, 0, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(UDP_CMD_NONE, roundTrip(control, arg));
+    TEST_ASSERT_EQUAL_UINT32(0, mockUdpSent.size());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mac_is_hmac_sha256);
+    RUN_TEST(test_good_commands_are_carried_out);
+    RUN_TEST(test_replays_are_stale);
+    RUN_TEST(test_wrong_nonce_is_stale_and_tells_the_current_one);
+    RUN_TEST(test_unauthenticated_packets_are_dropped);
+    RUN_TEST(test_level_out_of_range_is_a_bad_command);
+    RUN_TEST(test_hello_and_status_are_answered_with_any_nonce);
+    RUN_TEST(test_round_trips_are_counted_and_timed);
+    RUN_TEST(test_empty_key_stops_listening);
+
+    return UNITY_END();
+}
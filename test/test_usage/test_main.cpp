@@ -0,0 +1,169 @@
+/*
+    Usage tests - Counts usage thru the UsageMeter on a virtual clock and
+    restarts it over the same RTC memory, checking what survives.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "UsageMeter.h"
+
+/**
+ * Runs the meter at the given level for the given seconds, calling it
+ * every 100ms as the loop would.
+ */
+static void run(UsageMeter &meter, uint16_t level, unsigned long seconds) {
+    for (unsigned long at = 0; at < seconds * 10; at++) {
+        mockAdvanceMillis(100);
+        meter.handle(level);
+    }
+}
+
+void setUp() {
+    memset(mockRtcMemory, 0, sizeof(mockRtcMemory));
+    mockMillis = 0;
+}
+
+void tearDown() {}
+
+void test_cold_boot_starts_from_flash() {
+    UsageMeter meter;
+    TEST_ASSERT_FALSE(meter.begin(1000, 20, 500));
+    TEST_ASSERT_EQUAL_UINT32(1000, meter.getOnSeconds());
+    TEST_ASSERT_EQUAL_UINT32(20, meter.getSwitchCycles());
+    TEST_ASSERT_EQUAL_UINT32(500, meter.getFullOnSeconds());
+}
+
+void test_restart_carries_on_from_rtc() {
+    UsageMeter before;
+    before.begin(1000, 20, 500);
+    before.countCycle();
+    run(before, USAGE_FULL_LEVEL, 120);
+
+    // Restarted, flash still holding what it did
+    UsageMeter after;
+    TEST_ASSERT_TRUE(after.begin(1000, 20, 500));
+    TEST_ASSERT_EQUAL_UINT32(1120, after.getOnSeconds());
+    TEST_ASSERT_EQUAL_UINT32(21, after.getSwitchCycles());
+    TEST_ASSERT_EQUAL_UINT32(620, after.getFullOnSeconds());
+}
+
+void test_rtc_from_other_flash_is_not_trusted() {
+    UsageMeter before;
+    before.begin(1000, 20, 500);
+    run(before, USAGE_FULL_LEVEL, 60);
+
+    // Factory reset cleared the totals in flash
+    UsageMeter after;
+    TEST_ASSERT_FALSE(after.begin(0, 0, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, after.getOnSeconds());
+}
+
+void test_corrupt_rtc_is_not_trusted() {
+    UsageMeter before;
+    before.begin(1000, 20, 500);
+    run(before, USAGE_FULL_LEVEL, 60);
+    ((uint8_t *)mockRtcMemory)[USAGE_RTC_BLOCK * 4 + 5] ^= 0x01;
+
+    UsageMeter after;
+    TEST_ASSERT_FALSE(after.begin(1000, 20, 500));
+    TEST_ASSERT_EQUAL_UINT32(1000, after.getOnSeconds());
+}
+
+void test_flushed_totals_are_what_rtc_counts_on_from() {
+    UsageMeter before;
+    before.begin(0, 0, 0);
+    run(before, USAGE_FULL_LEVEL, 30);
+    before.markFlushed();
+    uint32_t flushedOn = before.getOnSeconds();
+    run(before, USAGE_FULL_LEVEL, 30);
+
+    UsageMeter after;
+    TEST_ASSERT_TRUE(after.begin(flushedOn, 0, flushedOn));
+    TEST_ASSERT_EQUAL_UINT32(60, after.getOnSeconds());
+
+    UsageMeter stale;
+    TEST_ASSERT_FALSE(stale.begin(0, 0, 0));
+}
+
+void test_full_on_seconds_follow_level() {
+    UsageMeter meter;
+    meter.begin(0, 0, 0);
+    run(meter, 512, 2046);
+    TEST_ASSERT_EQUAL_UINT32(2046, meter.getOnSeconds());
+    TEST_ASSERT_EQUAL_UINT32(1024, meter.getFullOnSeconds());
+
+    run(meter, 0, 500);
+    TEST_ASSERT_EQUAL_UINT32(2046, meter.getOnSeconds());
+    TEST_ASSERT_EQUAL_UINT32(1024, meter.getFullOnSeconds());
+}
+
+void test_part_of_full_on_second_survives_restart() {
+    UsageMeter before;
+    before.begin(0, 0, 0);
+    run(before, 1, USAGE_FULL_LEVEL - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, before.getFullOnSeconds());
+
+    UsageMeter after;
+    TEST_ASSERT_TRUE(after.begin(0, 0, 0));
+    run(after, 1, 1);
+    TEST_ASSERT_EQUAL_UINT32(1, after.getFullOnSeconds());
+}
+
+void test_held_up_loop_catches_up() {
+    UsageMeter meter;
+    meter.begin(0, 0, 0);
+    mockAdvanceMillis(10500);
+    meter.handle(USAGE_FULL_LEVEL);
+    TEST_ASSERT_EQUAL_UINT32(10, meter.getOnSeconds());
+    mockAdvanceMillis(500);
+    meter.handle(USAGE_FULL_LEVEL);
+    TEST_ASSERT_EQUAL_UINT32(11, meter.getOnSeconds());
+}
+
+void test_flush_is_due_hourly_when_changed() {
+    UsageMeter meter;
+    meter.begin(0, 0, 0);
+    mockAdvanceMillis(USAGE_FLUSH_INTERVAL);
+    TEST_ASSERT_FALSE(meter.isFlushDue());
+
+    meter.countCycle();
+    TEST_ASSERT_TRUE(meter.isFlushDue());
+    meter.markFlushed();
+    TEST_ASSERT_FALSE(meter.isFlushDue());
+
+    run(meter, USAGE_FULL_LEVEL, USAGE_FLUSH_INTERVAL / 1000 - 1);
+    TEST_ASSERT_FALSE(meter.isFlushDue());
+    run(meter, USAGE_FULL_LEVEL, 1);
+    TEST_ASSERT_TRUE(meter.isFlushDue());
+}
+
+void test_report_is_due_each_tenth_of_an_hour() {
+    UsageMeter meter;
+    meter.begin(0, 0, 0);
+    int reports = 0;
+    for (unsigned long second = 0; second < 3600; second++) {
+        mockAdvanceMillis(USAGE_TICK_MS);
+        reports += meter.handle(USAGE_FULL_LEVEL) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(10, reports);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_boot_starts_from_flash);
+    RUN_TEST(test_restart_carries_on_from_rtc);
+    RUN_TEST(test_rtc_from_other_flash_is_not_trusted);
+    RUN_TEST(test_corrupt_rtc_is_not_trusted);
+    RUN_TEST(test_flushed_totals_are_what_rtc_counts_on_from);
+    RUN_TEST(test_full_on_seconds_follow_level);
+    RUN_TEST(test_part_of_full_on_second_survives_restart);
+    RUN_TEST(test_held_up_loop_catches_up);
+    RUN_TEST(test_flush_is_due_hourly_when_changed);
+    RUN_TEST(test_report_is_due_each_tenth_of_an_hour);
+
+    return UNITY_END();
+}
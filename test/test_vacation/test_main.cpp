@@ -0,0 +1,173 @@
+/*
+    Vacation tests - Plans years of days with the VacationPlanner and
+    checks the plans are repeatable, inside their windows and varied.
+
+    Written by: .... Scott Griffis
+    Date: .......... 10-17-2026
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+#include <set>
+
+#include "VacationPlanner.h"
+
+#define FIRST_DAY 20454 // <-- 2026-01-01
+#define YEARS_OF_DAYS 3653
+
+/**
+ * Converts a 24hour time to minutes past midnight.
+ */
+static int toMinute(int time) {
+
+    return ((time / 100) * 60) + (time % 100);
+}
+
+/**
+ * Determines if a 24hour time is within a window, the window running
+ * past midnight if its end is before its start.
+ */
+static bool isWithin(int time, int from, int to) {
+    if (to >= from) {
+
+        return time >= from && time <= to;
+    }
+
+    return time >= from || time <= to;
+}
+
+static void assertValidTime(int time) {
+    TEST_ASSERT_TRUE(time >= 0 && time / 100 < 24 && time % 100 < 60);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_plans_are_repeatable() {
+    VacationPlanner planner;
+    planner.setSeed(0x00C0FFEE);
+    planner.setBounds(1800, 1930, 2230, 30);
+
+    // Known plans, so a change to how days are planned doesn't go unseen
+    int onTime;
+    int offTime;
+    planner.plan(FIRST_DAY, onTime, offTime);
+    TEST_ASSERT_EQUAL(1859, onTime);
+    TEST_ASSERT_EQUAL(7, offTime);
+    planner.plan(FIRST_DAY + 1, onTime, offTime);
+    TEST_ASSERT_EQUAL(1818, onTime);
+    TEST_ASSERT_EQUAL(2343, offTime);
+
+    // A restart plans the day the same, whatever was planned before it
+    VacationPlanner restarted;
+    restarted.setSeed(0x00C0FFEE);
+    restarted.setBounds(1800, 1930, 2230, 30);
+    for (uint16_t day = FIRST_DAY + YEARS_OF_DAYS; day > FIRST_DAY; day--) {
+        int onAgain;
+        int offAgain;
+        planner.plan(day, onTime, offTime);
+        restarted.plan(day, onAgain, offAgain);
+        TEST_ASSERT_EQUAL(onTime, onAgain);
+        TEST_ASSERT_EQUAL(offTime, offAgain);
+    }
+}
+
+void test_plans_keep_to_windows() {
+    const int bounds[][4] = {
+        {1800, 1930, 2230, 2330},
+        {1800, 1930, 2230, 30}, // off runs past midnight
+        {2330, 45, 100, 200}, // on runs past midnight
+        {0, 2359, 0, 2359}, // whole day
+        {1900, 1900, 2300, 2300} // no window at all
+    };
+    VacationPlanner planner;
+    planner.setSeed(12345);
+    for (const int *bound : bounds) {
+        planner.setBounds(bound[0], bound[1], bound[2], bound[3]);
+        for (uint16_t day = FIRST_DAY; day < FIRST_DAY + YEARS_OF_DAYS; day++) {
+            int onTime;
+            int offTime;
+            planner.plan(day, onTime, offTime);
+            assertValidTime(onTime);
+            assertValidTime(offTime);
+            TEST_ASSERT_TRUE(isWithin(onTime, bound[0], bound[1]));
+            // Off only leaves its window to stay on for a minute
+            bool isMinuteAfter = toMinute(offTime) == (toMinute(onTime) + 1) % 1440;
+            TEST_ASSERT_TRUE(isWithin(offTime, bound[2], bound[3]) || isMinuteAfter);
+            TEST_ASSERT_TRUE(onTime != offTime);
+        }
+    }
+}
+
+void test_every_minute_of_window_gets_used() {
+    VacationPlanner planner;
+    planner.setSeed(777);
+    planner.setBounds(1830, 1929, 2300, 2300);
+    std::set<int> minutes;
+    for (uint16_t day = FIRST_DAY; day < FIRST_DAY + YEARS_OF_DAYS; day++) {
+        int onTime;
+        int offTime;
+        planner.plan(day, onTime, offTime);
+        minutes.insert(toMinute(onTime));
+        TEST_ASSERT_EQUAL(2300, offTime);
+    }
+    TEST_ASSERT_EQUAL(60, (int)minutes.size());
+}
+
+void test_days_and_devices_differ() {
+    VacationPlanner kitchen;
+    VacationPlanner bedroom;
+    kitchen.setSeed(0x1A2B3C);
+    bedroom.setSeed(0x1A2B3D);
+    kitchen.setBounds(1800, 2000, 2200, 2359);
+    bedroom.setBounds(1800, 2000, 2200, 2359);
+
+    int sameAsYesterday = 0;
+    int sameAsOtherRoom = 0;
+    int lastOnTime = -1;
+    for (uint16_t day = FIRST_DAY; day < FIRST_DAY + 365; day++) {
+        int onTime;
+        int offTime;
+        int otherOnTime;
+        int otherOffTime;
+        kitchen.plan(day, onTime, offTime);
+        bedroom.plan(day, otherOnTime, otherOffTime);
+        sameAsYesterday += onTime == lastOnTime ? 1 : 0;
+        sameAsOtherRoom += onTime == otherOnTime ? 1 : 0;
+        lastOnTime = onTime;
+    }
+
+    // 121 minutes to pick from, so a handful of repeats by chance at most
+    TEST_ASSERT_TRUE(sameAsYesterday <= 12);
+    TEST_ASSERT_TRUE(sameAsOtherRoom <= 12);
+}
+
+void test_same_on_and_off_stays_on_a_minute() {
+    VacationPlanner planner;
+    int onTime;
+    int offTime;
+    planner.setBounds(1900, 1900, 1900, 1900);
+    planner.plan(FIRST_DAY, onTime, offTime);
+    TEST_ASSERT_EQUAL(1900, onTime);
+    TEST_ASSERT_EQUAL(1901, offTime);
+
+    planner.setBounds(1859, 1859, 1859, 1859);
+    planner.plan(FIRST_DAY, onTime, offTime);
+    TEST_ASSERT_EQUAL(1900, offTime);
+
+    planner.setBounds(2359, 2359, 2359, 2359);
+    planner.plan(FIRST_DAY, onTime, offTime);
+    TEST_ASSERT_EQUAL(0, offTime);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_plans_are_repeatable);
+    RUN_TEST(test_plans_keep_to_windows);
+    RUN_TEST(test_every_minute_of_window_gets_used);
+    RUN_TEST(test_days_and_devices_differ);
+    RUN_TEST(test_same_on_and_off_stays_on_a_minute);
+
+    return UNITY_END();
+}
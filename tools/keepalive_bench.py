@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+keepalive_bench - Measures how long a Lumen Light Controller takes to serve
+a page load, being the page plus what it fetches after, when each request
+gets its own connection, when the requests share a kept-alive connection
+and when they are all pipelined onto one connection at once.
+
+Each page load is timed from the first connect to the last response byte,
+and the latency percentiles are reported for each of the three ways.
+
+Usage: keepalive_bench.py <device url> [--path P ...] [--loads N]
+
+Written by: .... Scott Griffis
+Date: .......... 10-17-2026
+"""
+import argparse
+import socket
+import time
+import urllib.parse
+
+DEFAULT_PATHS = ["/", "/api/status"]
+
+
+def request_bytes(host, path, keep_alive):
+    connection = "keep-alive" if keep_alive else "close"
+    return ("GET %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n\r\n" % (path, host, connection)).encode("ascii")
+
+
+def read_response(stream):
+    """Reads one response from a buffered socket file, returning its status."""
+    status_line = stream.readline()
+    if not status_line:
+        raise ConnectionError("connection closed before response")
+    status = int(status_line.split()[1])
+    length = None
+    chunked = False
+    closes = False
+    while True:
+        line = stream.readline().strip()
+        if not line:
+            break
+        name, _, value = line.decode("latin-1").partition(":")
+        name = name.strip().lower()
+        value = value.strip().lower()
+        if name == "content-length":
+            length = int(value)
+        elif name == "transfer-encoding" and "chunked" in value:
+            chunked = True
+        elif name == "connection" and "close" in value:
+            closes = True
+    if chunked:
+        while True:
+            size = int(stream.readline().split(b";")[0], 16)
+            stream.read(size + 2)
+            if size == 0:
+                break
+    elif length is not None:
+        stream.read(length)
+    else:
+        stream.read()
+        closes = True
+    return status, closes
+
+
+def connect(address):
+    sock = socket.create_connection(address, timeout=10)
+    # Small requests must not wait on Nagle or the client ends up being timed
+    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    return sock
+
+
+def load_separate(address, host, paths):
+    for path in paths:
+        with connect(address) as sock:
+            sock.sendall(request_bytes(host, path, False))
+            read_response(sock.makefile("rb"))
+
+
+def load_keep_alive(address, host, paths):
+    with connect(address) as sock:
+        stream = sock.makefile("rb")
+        for path in paths:
+            sock.sendall(request_bytes(host, path, True))
+            read_response(stream)
+
+
+def load_pipelined(address, host, paths):
+    with connect(address) as sock:
+        stream = sock.makefile("rb")
+        sock.sendall(b"".join(request_bytes(host, path, True) for path in paths))
+        for _ in paths:
+            read_response(stream)
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare page load latency with and without keep-alive.")
+    parser.add_argument("url", help="Base URL of the device, e.g. http://192.168.1.1")
+    parser.add_argument("--path", action="append", help="Path fetched per page load, repeat for each (default / and /api/status)")
+    parser.add_argument("--loads", type=int, default=50, help="Page loads per way of connecting")
+    args = parser.parse_args()
+
+    parts = urllib.parse.urlsplit(args.url)
+    address = (parts.hostname, parts.port or 80)
+    paths = args.path or DEFAULT_PATHS
+
+    print("Page load of %s, %d loads each" % (" + ".join(paths), args.loads))
+    for name, load in (("separate", load_separate), ("keep-alive", load_keep_alive), ("pipelined", load_pipelined)):
+        latencies = []
+        failures = 0
+        for _ in range(args.loads):
+            start = time.perf_counter()
+            try:
+                load(address, parts.netloc, paths)
+                latencies.append((time.perf_counter() - start) * 1000.0)
+            except (OSError, ValueError, IndexError):
+                failures += 1
+            # Give the device a moment between loads
+            time.sleep(0.05)
+        print("%-10s p50 %7.1f  p90 %7.1f  p99 %7.1f  max %7.1f ms  (%d failed)" % (
+            name, percentile(latencies, 50), percentile(latencies, 90), percentile(latencies, 99),
+            max(latencies or [0.0]), failures))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
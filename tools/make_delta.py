@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+make_delta - Builds a binary delta that turns the firmware image currently
+installed on a Lumen Light Controller into a new one. The resulting file can
+be uploaded thru the device's /update page in place of the full image, so
+only the bytes that changed have to cross the network.
+
+The format is the one decoded by lib/Ota/DeltaDecoder. The base image must
+be the exact firmware.bin the device is running, as the device refuses a
+delta whose base size or MD5 does not match its running image.
+
+Usage: make_delta.py <base.bin> <target.bin> <out.delta>
+
+Written by: .... Scott Griffis
+Date: .......... 10-17-2026
+"""
+import hashlib
+import struct
+import sys
+
+MAGIC = b"LDLT"
+VERSION = 1
+OP_END = 0x00
+OP_COPY = 0x01
+OP_ADD = 0x02
+BLOCK = 16  # Shortest run worth a COPY (it costs 9 bytes)
+
+
+def build_index(base):
+    index = {}
+    for i in range(len(base) - BLOCK + 1):
+        index.setdefault(base[i:i + BLOCK], i)
+    return index
+
+
+def match_length(base, b, target, t):
+    n = 0
+    limit = min(len(base) - b, len(target) - t)
+    while n < limit and base[b + n] == target[t + n]:
+        n += 1
+    return n
+
+
+def make_ops(base, target):
+    index = build_index(base)
+    ops = []
+    literal = bytearray()
+    t = 0
+    next_base = None  # Where the previous copy would continue in the base
+    while t < len(target):
+        best_off, best_len = None, 0
+        # Prefer carrying on from the previous copy, that is where small
+        # in place edits leave the rest of the image
+        if next_base is not None and next_base < len(base):
+            n = match_length(base, next_base, target, t)
+            if n >= BLOCK:
+                best_off, best_len = next_base, n
+        if best_off is None:
+            off = index.get(bytes(target[t:t + BLOCK]))
+            if off is not None:
+                best_off, best_len = off, match_length(base, off, target, t)
+        if best_len >= BLOCK:
+            if literal:
+                ops.append((OP_ADD, bytes(literal)))
+                literal = bytearray()
+            ops.append((OP_COPY, best_off, best_len))
+            t += best_len
+            next_base = best_off + best_len
+        else:
+            literal.append(target[t])
+            t += 1
+            if next_base is not None:
+                next_base += 1
+    if literal:
+        ops.append((OP_ADD, bytes(literal)))
+    return ops
+
+
+def main(argv):
+    if len(argv) != 4:
+        sys.stderr.write(__doc__)
+        return 1
+    base = open(argv[1], "rb").read()
+    target = open(argv[2], "rb").read()
+
+    out = bytearray()
+    out += MAGIC
+    out += struct.pack("<B3xII", VERSION, len(base), len(target))
+    out += hashlib.md5(base).digest()
+    out += hashlib.md5(target).digest()
+    for op in make_ops(base, target):
+        if op[0] == OP_COPY:
+            out += struct.pack("<BII", OP_COPY, op[1], op[2])
+        else:
+            out += struct.pack("<BI", OP_ADD, len(op[1]))
+            out += op[1]
+    out += bytes([OP_END])
+
+    open(argv[3], "wb").write(out)
+    print("Delta is %d bytes (%.1f%% of the %d byte image)" % (len(out), 100.0 * len(out) / max(len(target), 1), len(target)))
+    print("MD5 to enter on the update page: %s" % hashlib.md5(out).hexdigest())
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
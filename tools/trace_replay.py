@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+trace_replay - Replays a request trace captured by a Lumen Light Controller
+(see lib/Trace/RequestTrace) against a device, to reproduce real world web
+load on the bench.
+
+Requests are sent with the same spacing they arrived with, divided by the
+speed-up factor, and the throughput and latency percentiles seen by the
+client are reported. With --heap the device captures its own trace of the
+replay, and the free heap it recorded after each request is reported too.
+
+Capturing on a device:
+  curl --digest -u admin:admin "http://192.168.1.1/trace?start=128"
+  ... let real traffic happen ...
+  curl --digest -u admin:admin "http://192.168.1.1/trace" > prod.trace
+
+Usage: trace_replay.py <trace file> <device url> [--speed N] [--user U --password P] [--heap]
+
+Written by: .... Scott Griffis
+Date: .......... 10-17-2026
+"""
+import argparse
+import time
+import urllib.error
+import urllib.request
+
+METHODS = {"G": "GET", "P": "POST", "H": "HEAD", "U": "PUT", "A": "PATCH", "D": "DELETE", "O": "OPTIONS"}
+
+
+def read_trace(path):
+    records = []
+    for line in open(path, encoding="utf-8"):
+        if line.startswith("#") or not line.strip():
+            continue
+        at, method, duration, heap, target = line.rstrip("\n").split("\t", 4)
+        records.append((int(at), METHODS.get(method, "GET"), int(duration), int(heap), target))
+    return records
+
+
+def build_opener(url, user, password):
+    handlers = []
+    if user is not None:
+        manager = urllib.request.HTTPPasswordMgrWithDefaultRealm()
+        manager.add_password(None, url, user, password)
+        handlers.append(urllib.request.HTTPDigestAuthHandler(manager))
+    return urllib.request.build_opener(*handlers)
+
+
+def send(opener, url, method, target):
+    path, _, query = target.partition("?")
+    data = None
+    if method == "POST":
+        # Form args were recorded as a query string, send them back as a form
+        data = query.encode("ascii")
+    elif query:
+        path = path + "?" + query
+    request = urllib.request.Request(url + path, data=data, method=method)
+    start = time.perf_counter()
+    try:
+        with opener.open(request, timeout=10) as response:
+            response.read()
+            status = response.status
+    except urllib.error.HTTPError as e:
+        status = e.code
+    except OSError:
+        status = 0
+    return time.perf_counter() - start, status
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a Lumen request trace against a device.")
+    parser.add_argument("trace")
+    parser.add_argument("url", help="Base URL of the device, e.g. http://192.168.1.1")
+    parser.add_argument("--speed", type=float, default=1.0, help="Speed-up factor, 0 sends back to back")
+    parser.add_argument("--user")
+    parser.add_argument("--password")
+    parser.add_argument("--heap", action="store_true", help="Capture on the device during replay to report its heap")
+    args = parser.parse_args()
+
+    url = args.url.rstrip("/")
+    records = read_trace(args.trace)
+    opener = build_opener(url, args.user, args.password)
+    if args.heap:
+        send(opener, url, "GET", "/trace?start=%d" % min(max(len(records), 1), 128))
+
+    latencies = []
+    failures = 0
+    begin = time.perf_counter()
+    first_at = records[0][0] if records else 0
+    for at, method, _, _, target in records:
+        if args.speed > 0:
+            due = begin + (at - first_at) / 1000.0 / args.speed
+            delay = due - time.perf_counter()
+            if delay > 0:
+                time.sleep(delay)
+        latency, status = send(opener, url, method, target)
+        latencies.append(latency * 1000.0)
+        if status < 200 or status >= 400:
+            failures += 1
+    elapsed = time.perf_counter() - begin
+
+    print("Requests: %d (%d failed) in %.2f s, %.1f req/s" % (len(records), failures, elapsed, len(records) / elapsed if elapsed else 0.0))
+    print("Latency ms: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f" % (
+        percentile(latencies, 50), percentile(latencies, 90), percentile(latencies, 99), max(latencies or [0.0])))
+
+    if args.heap:
+        dump = "/tmp/lumen-replay.trace"
+        with opener.open(url + "/trace", timeout=10) as response, open(dump, "wb") as out:
+            out.write(response.read())
+        send(opener, url, "GET", "/trace?stop=1")
+        replayed = read_trace(dump)
+        heaps = [r[3] for r in replayed]
+        handling = [r[2] / 1000.0 for r in replayed]
+        if heaps:
+            print("Device heap bytes: min %d  avg %d  max %d  drift %+d" % (
+                min(heaps), sum(heaps) // len(heaps), max(heaps), heaps[-1] - heaps[0]))
+            print("Device handling ms: p50 %.1f  p90 %.1f  p99 %.1f" % (
+                percentile(handling, 50), percentile(handling, 90), percentile(handling, 99)))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+udp_control - Client for the UDP control protocol of a Lumen Light Controller
+(see lib/UdpControl), for automation controllers and for the bench.
+
+Commands: hello, status, on, off, toggle, level <1-100> and bench. The bench
+toggles the lights N times over UDP and then N times over HTTP (/api/cmd),
+reporting packets sent, bytes moved and round-trip times for each. From
+/metrics it also works out the device CPU time per UDP command, and with
+--user/--password it captures a request trace to get the same for HTTP.
+
+The boot nonce and counter are learned with a HELLO first, so a stale reply
+is only ever seen if the device reboots or another controller is using it.
+
+Usage: udp_control.py <device ip> <key> <command> [value] [--count N] [--user U --password P]
+
+Written by: .... Scott Griffis
+Date: .......... 10-17-2026
+"""
+import argparse
+import hashlib
+import hmac
+import re
+import socket
+import struct
+import time
+import urllib.request
+
+PORT = 42102
+VERSION = 1
+COMMANDS = {"hello": 0x00, "on": 0x01, "off": 0x01, "level": 0x02, "toggle": 0x03, "status": 0x04}
+STATUSES = {0: "ok", 1: "stale", 2: "bad command"}
+
+
+class Controller:
+    def __init__(self, ip, key, timeout=1.0):
+        self.address = (ip, PORT)
+        self.key = key.encode("utf-8")
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.settimeout(timeout)
+        self.nonce = 0
+        self.counter = 0
+        self.packets = 0
+
+    def mac(self, data):
+        return hmac.new(self.key, data, hashlib.sha256).digest()[:8]
+
+    def exchange(self, command, arg=0):
+        body = struct.pack("<2sBBBBBBII", b"LC", VERSION, command, arg, 0, 0, 0, self.nonce, self.counter + 1)
+        self.sock.sendto(body + self.mac(body), self.address)
+        self.packets += 1
+        reply, _ = self.sock.recvfrom(64)
+        if len(reply) != 24 or reply[16:] != self.mac(reply[:16]):
+            raise ValueError("reply failed authentication")
+        _, _, rcommand, status, flags, level, _, nonce, counter = struct.unpack("<2sBBBBBBII", reply[:16])
+        self.nonce, self.counter = nonce, counter
+        return status, {"on": bool(flags & 1), "timer": bool(flags & 2), "level": level}
+
+    def command(self, command, arg=0):
+        status, state = self.exchange(command, arg)
+        if status == 1:
+            # Caught up with the device's nonce and counter, so send again
+            status, state = self.exchange(command, arg)
+        return status, state
+
+
+def metric(base, name):
+    with urllib.request.urlopen(base + "/metrics", timeout=5) as response:
+        match = re.search(r"^%s (\d+)$" % name, response.read().decode(), re.M)
+    return int(match.group(1)) if match else 0
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))] if ordered else 0.0
+
+
+def bench(args, controller):
+    base = "http://%s" % args.ip
+    count = args.count
+
+    # UDP, one packet each way per command
+    controller.command(COMMANDS["hello"])
+    micros_before = metric(base, "lumen_udp_control_micros")
+    requests_before = metric(base, "lumen_udp_control_requests")
+    packets_before = controller.packets
+    udp_times = []
+    for _ in range(count):
+        start = time.perf_counter()
+        controller.command(COMMANDS["toggle"])
+        udp_times.append((time.perf_counter() - start) * 1000.0)
+    udp_cpu = (metric(base, "lumen_udp_control_micros") - micros_before) / max(metric(base, "lumen_udp_control_requests") - requests_before, 1)
+    udp_packets = controller.packets - packets_before
+
+    # HTTP, a connection per command as a controller without keep-alive would
+    opener = urllib.request.build_opener()
+    if args.user is not None:
+        manager = urllib.request.HTTPPasswordMgrWithDefaultRealm()
+        manager.add_password(None, base, args.user, args.password)
+        opener = urllib.request.build_opener(urllib.request.HTTPDigestAuthHandler(manager))
+        opener.open(base + "/trace?start=%d" % min(count, 128), timeout=5).read()
+    http_times = []
+    http_bytes = 0
+    for i in range(count):
+        start = time.perf_counter()
+        with urllib.request.urlopen(base + "/api/cmd", data=b"do=" + (b"on" if i % 2 else b"off"), timeout=5) as response:
+            http_bytes += len(response.read()) + 200  # plus request and headers, roughly
+        http_times.append((time.perf_counter() - start) * 1000.0)
+    http_cpu = None
+    if args.user is not None:
+        trace = opener.open(base + "/trace", timeout=5).read().decode()
+        opener.open(base + "/trace?stop=1", timeout=5).read()
+        durations = [int(line.split("\t")[2]) for line in trace.splitlines() if line and not line.startswith("#") and "/api/cmd" in line]
+        http_cpu = sum(durations) / len(durations) if durations else None
+
+    print("%d commands each way" % count)
+    print("UDP   packets %4d  bytes %6d  rtt p50 %6.2f p90 %6.2f ms  device %6.0f us/cmd" % (
+        udp_packets * 2, udp_packets * 48, percentile(udp_times, 50), percentile(udp_times, 90), udp_cpu))
+    print("HTTP  packets ~%3d  bytes ~%5d  rtt p50 %6.2f p90 %6.2f ms  device %s us/cmd" % (
+        count * 8, http_bytes, percentile(http_times, 50), percentile(http_times, 90),
+        "%6.0f" % http_cpu if http_cpu is not None else "     ? (needs --user)"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Control a Lumen device over UDP.")
+    parser.add_argument("ip")
+    parser.add_argument("key")
+    parser.add_argument("command", choices=sorted(list(COMMANDS) + ["bench"]))
+    parser.add_argument("value", nargs="?", type=int, default=0)
+    parser.add_argument("--count", type=int, default=100, help="Commands sent each way by bench")
+    parser.add_argument("--user")
+    parser.add_argument("--password")
+    args = parser.parse_args()
+
+    controller = Controller(args.ip, args.key)
+    if args.command == "bench":
+        bench(args, controller)
+        return 0
+
+    if args.command not in ("hello", "status"):
+        controller.command(COMMANDS["hello"])
+    arg = {"on": 1, "off": 0, "level": args.value}.get(args.command, 0)
+    status, state = controller.command(COMMANDS[args.command], arg)
+    print("%s: lights %s at %d%%, timer %s" % (
+        STATUSES.get(status, status), "on" if state["on"] else "off", state["level"], "on" if state["timer"] else "off"))
+    return 0 if status == 0 else 1
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())